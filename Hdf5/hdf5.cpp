@@ -5,32 +5,100 @@
 
 #include "hdf5.h"
 
+#include H5_ZLIB_HEADER
+#ifdef H5_HAVE_FILTER_LZ4
+#include H5_LZ4_HEADER
+#endif
+#ifdef H5_HAVE_FILTER_ZSTD
+#include H5_ZSTD_HEADER
+#endif
+
 
 namespace Upp {
 
+#ifndef H5_HAVE_THREADSAFE
+// Without thread safety the library has one error handler for all threads, so the threads turning it off
+// take turns
+static StaticMutex h5_errors_mutex;
+#endif
+
+struct ErrorsOffLock0 {
+	ErrorsOffLock0() {}
+#ifndef H5_HAVE_THREADSAFE
+	Mutex::Lock lock{h5_errors_mutex};
+#endif
+};
+
 void Hdf5File::Close() {
+	String error = Close0();
+	if (!IsNull(error))		// Background writes are reported once the file is closed
+		throw Exc(error);
+}
+
+// Closes everything, even after an error. Returns the first one, if any
+String Hdf5File::Close0() {
+	String error = StopAsync0();
+	
+	for (int i = 0; i < appends.GetCount(); ++i) {
+		try {
+			FlushAppend0(appends.GetKey(i), appends[i], true);
+		} catch (Exc e) {
+			if (IsNull(error))
+				error = e;
+		}
+	}
+	appends.Clear();
+	
 	for (int i = group_ids.size()-1; i >= 0; --i)
 		H5Gclose(group_ids[i]);
 	
 	group_ids.Clear();
+	name_index.Clear();
+	ClearCache0();
 	
 	dts_id.Close();
 	
 	if (file_id >= 0) {
-		ssize_t num_tot = H5Fget_obj_count(file_id, H5F_OBJ_ALL);
-		if (num_tot != 1)
-			throw Exc("HDF: Unclosed objects");
-		H5Fclose(file_id);
+		ssize_t num_tot = H5Fget_obj_count(file_id, H5F_OBJ_ALL | H5F_OBJ_LOCAL);	// Other handles may share the file
+		if (num_tot != 1 && IsNull(error))
+			error = "HDF: Unclosed objects";
+		H5Fclose(file_id);		// The file stays open until those objects are closed
+		file_id = -1;
 	}
+	mapped = NULL;
+	mapped_size = 0;
+	return error;
 }
 
 void Hdf5File::Open(String file, unsigned mode) {
+	Open0(file, mode, H5P_DEFAULT);
+}
+
+void Hdf5File::OpenMapped(String file) {
+#ifdef H5_HAVE_MMAP
+	HidP fapl = H5Pcreate(H5P_FILE_ACCESS);
+	if (fapl < 0 || H5Pset_fapl_mmap(fapl) < 0)
+		throw Exc("HDF: Impossible to set the mmap driver");
+	Open0(file, H5F_ACC_RDONLY, fapl);
+	
+	void *handle;
+	hsize_t size;
+	if (H5Fget_vfd_handle(file_id, H5P_DEFAULT, &handle) < 0 || H5Fget_filesize(file_id, &size) < 0)
+		throw Exc("HDF: Impossible to get the file mapping");
+	mapped = *(const char **)handle;
+	mapped_size = size;
+#else
+	Open0(file, H5F_ACC_RDONLY, H5P_DEFAULT);
+#endif
+}
+
+void Hdf5File::Open0(String file, unsigned mode, hid_t fapl) {
 	Close();
 	
 	if (!FileExists(file))
 		throw Exc(F("HDF: File '%s' does not exist", file));
 	
-    file_id = H5Fopen(file, mode, H5P_DEFAULT);
+    file_id = H5Fopen(file, mode, fapl);
     if (file_id < 0) 
         throw Exc(F("HDF: Impossible to open file '%s'", file));
     
@@ -58,12 +126,16 @@ void Hdf5File::Create(String file) {
 }
 
 bool Hdf5File::CreateGroup(String group, bool change) {
+	Sync0();
+	
 	hid_t group_id = Last(group_ids);
 
     hid_t id = H5Gcreate2(group_id, group, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
 	if (id < 0) 
         return false;
 
+	IndexName0(group, H5O_TYPE_GROUP);
+
 	if (change) {
 		hid_t ngroup_id = H5Oopen(group_id, ~group, H5P_DEFAULT);
 		group_ids << ngroup_id;
@@ -75,29 +147,16 @@ bool Hdf5File::CreateGroup(String group, bool change) {
 }
 
 bool Hdf5File::ChangeGroup(String sgroup) {
-	hid_t group_id = Last(group_ids);
+	Sync0();
 	
-    H5G_info_t group_info;
-    H5Gget_info(group_id, &group_info);
+	if (!ExistGroup(sgroup))
+		return false;
 	
-    for (hsize_t i = 0; i < group_info.nlinks; i++) {
-        char obj_name[256];
-        H5Lget_name_by_idx(group_id, ".", H5_INDEX_NAME, H5_ITER_NATIVE, i, obj_name, sizeof(obj_name), H5P_DEFAULT);
-		String sname(obj_name);
-
-		if (sname == sgroup && H5Lexists(group_id, obj_name, H5P_DEFAULT) >= 0) {
-            hid_t ngroup_id = H5Oopen(group_id, obj_name, H5P_DEFAULT);
-            H5O_info2_t oinfo;
-            if (H5Oget_info(ngroup_id, &oinfo, H5O_INFO_BASIC) >= 0) {
-            	if (oinfo.type == H5O_TYPE_GROUP) {
-	            	group_ids << ngroup_id;
-	            	return true;
-            	}
-            	H5Oclose(ngroup_id);
-            }
-		}
-    }
-    return false;
+	hid_t ngroup_id = H5Oopen(Last(group_ids), ~sgroup, H5P_DEFAULT);
+	if (ngroup_id < 0)
+		return false;
+	group_ids << ngroup_id;
+	return true;
 }
 
 /*Vector<String> Hdf5File::ListGroup(bool groups, bool datasets) {
@@ -129,6 +188,8 @@ bool Hdf5File::ChangeGroup(String sgroup) {
 }*/
 
 Vector<String> Hdf5File::ListGroup(bool groups, bool datasets) {
+	Sync0();
+	
 	struct SIterate {
 		Vector<String> *pret;
 		bool groups, datasets;
@@ -166,155 +227,409 @@ Vector<String> Hdf5File::ListGroup(bool groups, bool datasets) {
 	return ret;	
 }
 
-bool Hdf5File::Exist(String name, bool isgroup) {
+String Hdf5File::GetGroupPath0() {
 	hid_t group_id = Last(group_ids);
+	ssize_t len = H5Iget_name(group_id, NULL, 0);
+	if (len <= 0)
+		return Null;
+	StringBuffer path((int)len);
+	H5Iget_name(group_id, ~path, (size_t)len + 1);
+	return path;
+}
+
+H5O_type_t Hdf5File::GetObjType0(hid_t group_id, String name) {
+	H5O_type_t type = H5O_TYPE_UNKNOWN;
+	ErrorsOffLock0 __;
+	H5E_BEGIN_TRY {		// Missing intermediate groups in name are not an error
+		H5O_info2_t oinfo;
+		if (H5Lexists(group_id, ~name, H5P_DEFAULT) > 0 && 
+			H5Oget_info_by_name(group_id, ~name, &oinfo, H5O_INFO_BASIC, H5P_DEFAULT) >= 0)
+			type = oinfo.type;
+	} H5E_END_TRY
+	return type;
+}
+
+Hdf5File &Hdf5File::IndexNames(bool set) {
+	Sync0();
 	
-    H5G_info_t group_info;
-    H5Gget_info(group_id, &group_info);
+	index_names = set;
+	name_index.Clear();
+	return *this;
+}
+
+// Index of the current group. Null if indexing is disabled or name is a path, 
+// as it may point to other groups
+VectorMap<String, int> *Hdf5File::GetNameIndex0(String name) {
+	if (!index_names || name.Find('/') >= 0)
+		return NULL;
 	
-    for (hsize_t i = 0; i < group_info.nlinks; i++) {
-        char obj_name[256];
-        H5Lget_name_by_idx(group_id, ".", H5_INDEX_NAME, H5_ITER_NATIVE, i, obj_name, sizeof(obj_name), H5P_DEFAULT);
-		String ename(obj_name);
-		if (ename == name) {
-	        if (H5Lexists(group_id, obj_name, H5P_DEFAULT) >= 0) {
-		    	HidO obj_id = H5Oopen(group_id, obj_name, H5P_DEFAULT);
-		        H5O_info2_t oinfo;
-		        if (H5Oget_info(obj_id, &oinfo, H5O_INFO_BASIC) >= 0) {
-		           	if (isgroup) {
-		           		if (oinfo.type == H5O_TYPE_GROUP)
-		           			return true;
-		           	} else {
-		           		if (oinfo.type == H5O_TYPE_DATASET) 
-		           			return true;
-		           	}
-	            }
-	        }
+	String path = GetGroupPath0();
+	int id = name_index.Find(path);
+	if (id >= 0)
+		return &name_index[id];
+	
+	VectorMap<String, int> &index = name_index.Add(path);
+	auto IterateGroup = [](hid_t group_id, const char *name, const H5L_info_t */*info*/, void *op_data)->herr_t {
+		VectorMap<String, int> &index = *(VectorMap<String, int> *)op_data;
+		index.Add(name, GetObjType0(group_id, name));
+		return 0;
+	};
+	H5Literate(Last(group_ids), H5_INDEX_NAME, H5_ITER_NATIVE, NULL, IterateGroup, &index);
+	return &index;
+}
+
+// Keeps the index in sync when an object is created (type) or deleted (H5O_TYPE_UNKNOWN)
+void Hdf5File::IndexName0(String name, H5O_type_t type) {
+	if (!index_names)
+		return;
+	if (name.Find('/') >= 0) {		// Other groups may be affected
+		name_index.Clear();
+		return;
+	}
+	String path = GetGroupPath0();
+	if (type == H5O_TYPE_UNKNOWN) {		// A deleted group takes the indexes of its subgroups along
+		String sub = (path.EndsWith("/") ? path : path + "/") + name;
+		for (int i = name_index.GetCount()-1; i >= 0; --i) {
+			const String &key = name_index.GetKey(i);
+			if (key == sub || key.StartsWith(sub + "/"))
+				name_index.Remove(i);
 		}
-    }
-	return false;
+	}
+	int id = name_index.Find(path);
+	if (id < 0)
+		return;
+	if (type == H5O_TYPE_UNKNOWN)
+		name_index[id].RemoveKey(name);
+	else
+		name_index[id].GetAdd(name) = type;
+}
+
+bool Hdf5File::Exist(String name, bool isgroup) {
+	Sync0();
+	
+	H5O_type_t type;
+	if (VectorMap<String, int> *index = GetNameIndex0(name)) 
+		type = (H5O_type_t)index->Get(name, H5O_TYPE_UNKNOWN);
+	else
+		type = GetObjType0(Last(group_ids), name);
+	
+	return type == (isgroup ? H5O_TYPE_GROUP : H5O_TYPE_DATASET);
 }
 
 bool Hdf5File::Delete(String name) {
+	Sync0();
+	
 	hid_t group_id = Last(group_ids);
 	
+	InvalidateCache0(name);
+	DiscardAppend0(name);
 	if (H5Ldelete(group_id, name, H5P_DEFAULT) < 0) 
         return false;
+	
+	IndexName0(name, H5O_TYPE_UNKNOWN);
     return true;
 }
 
 void Hdf5File::UpGroup() {
+	Sync0();
+	
 	H5Gclose(Last(group_ids));	
 	group_ids.Remove(group_ids.size()-1);
 }
 
-void Hdf5File::GetData0(String name, HidO &obj_id, hid_t &datatype_id, hid_t &dspace, int &sz, Vector<int> &dims) {
+String Hdf5File::GetDatasetKey0(String name) {
+	if (name.StartsWith("/"))
+		return name;
+	String path = GetGroupPath0();
+	if (!path.EndsWith("/"))
+		path << "/";
+	return path + name;
+}
+
+const Hdf5File::Dataset0 &Hdf5File::GetData0(String name) {
+	Sync0();
+	
+	String key = GetDatasetKey0(name);
+	int iappend = appends.Find(key);
+	if (iappend >= 0)
+		FlushAppend0(key, appends[iappend], true);
+	
+	int icache = datasets.Find(key);
+	if (icache >= 0) {
+		cache_hits++;
+		Dataset0 &ds = datasets[icache];
+		ds.tick = ++cache_tick;
+		return ds;
+	}
+	cache_misses++;
+	
 	hid_t group_id = Last(group_ids);
 	
-	if (H5Lexists(group_id, ~name, H5P_DEFAULT) < 0) 
-		throw Exc(F("HDF: Dataset '%s' not found", name));
+	if (GetObjType0(group_id, name) != H5O_TYPE_DATASET) {
+		if (H5Lexists(group_id, ~name, H5P_DEFAULT) <= 0) 
+			throw Exc(F("HDF: Dataset '%s' not found", name));
+		throw Exc(F("HDF: '%s' is not a dataset", name));
+	}
+	
+	Dataset0 *pds;
+	if (cache_size > 0) {
+		if (datasets.GetCount() >= cache_size) {		// Evicts the least recently used
+			int iold = 0;
+			for (int i = 1; i < datasets.GetCount(); ++i)
+				if (datasets[i].tick < datasets[iold].tick)
+					iold = i;
+			datasets.Remove(iold);
+		}
+		pds = &datasets.Add(key);
+	} else {
+		uncached.Create();
+		pds = &*uncached;
+	}
+	Dataset0 &ds = *pds;
+	ds.tick = ++cache_tick;
+	
+	try {
+		ds.id = H5Dopen2(group_id, ~name, GetDapl0());
+		if (ds.id < 0)
+			throw Exc(F("HDF: Impossible to open dataset '%s'", name));
+			    
+	    ds.type = H5Dget_type(ds.id);
+		if (ds.type < 0)
+			throw Exc(F("HDF: Dataset '%s' type is unknown", name));
+		ds.clss = H5Tget_class(ds.type);
+			
+		ds.space = H5Dget_space(ds.id);
+		const int ndims = H5Sget_simple_extent_ndims(ds.space);
 		
-  	obj_id = H5Oopen(group_id, ~name, H5P_DEFAULT);
-    H5O_info2_t oinfo;
-    if (H5Oget_info(obj_id, &oinfo, H5O_INFO_BASIC) < 0) 
-        throw Exc(F("HDF: Dataset '%s' info not found", name));
-        
-    if (oinfo.type != H5O_TYPE_DATASET)
-        throw Exc(F("HDF: '%s' is not a dataset", name));
-    
-    datatype_id = H5Dget_type(obj_id);
-	if (datatype_id < 0)
-		throw Exc(F("HDF: Dataset '%s' type is unknown", name));
+		Vector<hsize_t> _dims(ndims);
+		H5Sget_simple_extent_dims(ds.space, _dims.begin(), NULL);
 		
-	dspace = H5Dget_space(obj_id);
-	const int ndims = H5Sget_simple_extent_ndims(dspace);
+		ds.dims.SetCount(ndims);
+	    ds.sz = 1;
+	    for (int id = 0; id < ndims; ++id) 
+	        ds.sz *= ds.dims[id] = int(_dims[id]);
+	    
+	    ds.colmajor = IsColMajor0(ds.id);
+	} catch (...) {
+		if (cache_size > 0)
+			datasets.RemoveKey(key);
+		else
+			uncached.Clear();
+		throw;
+	}
+	return ds;
+}
+
+// Returns where the dataset is in the file mapping, or NULL if it cannot be used in place
+const double *Hdf5File::GetMapped0(const Dataset0 &ds) {
+	if (!mapped || ds.clss != H5T_FLOAT || ds.dims.size() < 1 || ds.dims.size() > 2 || ds.sz == 0)
+		return NULL;
+	if (H5Tequal(ds.type, H5T_NATIVE_DOUBLE) <= 0)
+		return NULL;
+	haddr_t offset = H5Dget_offset(ds.id);		// Only contiguous datasets have it
+	if (offset == HADDR_UNDEF || int64(offset + ds.sz*sizeof(double)) > mapped_size)
+		return NULL;
+	return (const double *)(mapped + offset);
+}
+
+bool Hdf5File::CanMap(String name) {
+	return GetMapped0(GetData0(name));
+}
+
+const double *Hdf5File::Map0(String name, const Dataset0 &ds) {
+	const double *d = GetMapped0(ds);
+	if (!d) {
+		if (!mapped)
+			throw Exc("HDF: File is not memory-mapped");
+		throw Exc(F("HDF: Dataset '%s' cannot be mapped", name));
+	}
+	return d;
+}
+
+Hdf5File::MapVXd Hdf5File::MapVector(String name) {
+	const Dataset0 &ds = GetData0(name);
+	
+	if (ds.dims.size() == 2 && ds.dims[0] != 1 && ds.dims[1] != 1)
+		throw Exc("HDF: Dimension different than one");
+	
+	return MapVXd(Map0(name, ds), ds.sz);
+}
+
+Hdf5File::MapXd Hdf5File::Map(String name) {
+	const Dataset0 &ds = GetData0(name);
 	
-	Vector<hsize_t> _dims(ndims);
-	H5Sget_simple_extent_dims(dspace, _dims.begin(), NULL);
+	const double *d = Map0(name, ds);
+	if (ds.dims.size() == 1)
+		return MapXd(d, ds.dims[0], 1, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(ds.dims[0], 1));
+	if (ds.colmajor)
+		return MapXd(d, ds.dims[1], ds.dims[0], Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(ds.dims[1], 1));
+	return MapXd(d, ds.dims[0], ds.dims[1], Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(1, ds.dims[1]));	// Row-major, read as is
+}
+
+// Closes the cached datasets that are name, or are inside name if it is a group
+void Hdf5File::InvalidateCache0(String name) {
+	String key = GetDatasetKey0(name);
+	String group = key + "/";
+	for (int i = datasets.GetCount()-1; i >= 0; --i) {
+		const String &k = datasets.GetKey(i);
+		if (k == key || k.StartsWith(group))
+			datasets.Remove(i);
+	}
+	uncached.Clear();
+}
+
+void Hdf5File::ClearCache0() {
+	datasets.Clear();
+	uncached.Clear();
+}
+
+Hdf5File &Hdf5File::SetCacheSize(int n) {
+	Sync0();
+	
+	cache_size = max(n, 0);
+	ClearCache0();
+	return *this;
+}
+
+Hdf5File &Hdf5File::SetChunkCache(int64 bytes, int slots, bool scanresistant) {
+	Sync0();
+	
+	ClearCache0();		// Open datasets keep their previous cache
+	hid_t p = Dapl0();
+	if (bytes <= 0) {
+		if (H5Pset_chunk_cache(p, H5D_CHUNK_CACHE_NSLOTS_DEFAULT, H5D_CHUNK_CACHE_NBYTES_DEFAULT, 
+							   H5D_CHUNK_CACHE_W0_DEFAULT) < 0 ||
+			H5Pset_chunk_cache_policy(p, H5D_CHUNK_CACHE_HASH_DIRECT, H5D_CHUNK_CACHE_POLICY_W0) < 0)
+			throw Exc("HDF: Impossible to set the chunk cache");
+		return *this;
+	}
+	if (H5Pset_chunk_cache(p, slots > 0 ? size_t(slots) : H5D_CHUNK_CACHE_NSLOTS_DEFAULT, size_t(bytes), 
+						   H5D_CHUNK_CACHE_W0_DEFAULT) < 0)
+		throw Exc("HDF: Impossible to set the chunk cache");
+	if (H5Pset_chunk_cache_policy(p, scanresistant ? H5D_CHUNK_CACHE_HASH_OPEN : H5D_CHUNK_CACHE_HASH_DIRECT, 
+								  scanresistant ? H5D_CHUNK_CACHE_POLICY_2Q : H5D_CHUNK_CACHE_POLICY_W0) < 0)
+		throw Exc("HDF: Impossible to set the chunk cache policy");
+	return *this;
+}
+
+Hdf5File &Hdf5File::SetChunkPrefetch(int nchunks) {
+	Sync0();
+	
+	ClearCache0();
+	if (H5Pset_chunk_prefetch(Dapl0(), unsigned(max(nchunks, 0))) < 0)
+		throw Exc("HDF: Impossible to set the chunk prefetch");
+	return *this;
+}
+
+Hdf5File &Hdf5File::SnapshotChunkIndex(bool set) {
+	Sync0();
+	
+	ClearCache0();
+	if (H5Pset_chunk_index_snapshot(Dapl0(), set) < 0)
+		throw Exc("HDF: Impossible to set the chunk index snapshot");
+	return *this;
+}
+
+bool Hdf5File::OptimizeLayout(String name) {
+	const Dataset0 &ds = GetData0(name);
+	
+	H5D_chunk_index_t idx;
+	herr_t ret;
+	{
+		ErrorsOffLock0 __;
+		H5E_BEGIN_TRY {
+			ret = H5Dget_chunk_index_type(ds.id, &idx);
+		} H5E_END_TRY
+	}
+	if (ret < 0 || idx != H5D_CHUNK_IDX_BTREE)
+		return false;
+	if (H5Dformat_upgrade(ds.id) < 0)
+		throw Exc(F("HDF: Impossible to optimize the layout of dataset '%s'", name));
+	return true;
+}
+
+hid_t Hdf5File::Dapl0() {
+	if (dapl < 0 && (dapl = H5Pcreate(H5P_DATASET_ACCESS)) < 0)
+		throw Exc("HDF: Impossible to create the dataset access properties");
+	return dapl;
+}
+
+H5D_chunk_cache_stats_t Hdf5File::GetChunkCacheStats(String name) {
+	const Dataset0 &ds = GetData0(name);
 	
-	dims.SetCount(ndims);
-    sz = 1;
-    for (int id = 0; id < ndims; ++id) 
-        sz *= dims[id] = int(_dims[id]);
+	H5D_chunk_cache_stats_t stats;
+	herr_t ret;
+	{
+		ErrorsOffLock0 __;
+		H5E_BEGIN_TRY {
+			ret = H5Dget_chunk_cache_stats(ds.id, &stats);
+		} H5E_END_TRY
+	}
+	if (ret < 0)
+		throw Exc(F("HDF: Dataset '%s' is not chunked", name));
+	return stats;
 }
 
 void Hdf5File::GetType(String name, H5T_class_t &type, Vector<int> &dims) {
-	int sz;
-	HidO obj_id;
-	hid_t datatype_id, dspace;
-	GetData0(name, obj_id, datatype_id, dspace, sz, dims);
-	type = H5Tget_class(datatype_id);
+	const Dataset0 &ds = GetData0(name);
+	type = ds.clss;
+	dims = ds.colmajor ? Reverse0(ds.dims) : clone(ds.dims);
 }
 
 int Hdf5File::GetInt(String name) {
-	int sz;
-	HidO obj_id;
-	hid_t datatype_id, dspace;
-	Vector<int> dims;
-	GetData0(name, obj_id, datatype_id, dspace, sz, dims);
-	
-	H5T_class_t clss = H5Tget_class(datatype_id);
-	if (clss != H5T_INTEGER)
+	const Dataset0 &ds = GetData0(name);
+	
+	if (ds.clss != H5T_INTEGER)
 		throw Exc("HDF: Dataset is not integer");
 	
-	if (sz != 1) 
+	if (ds.sz != 1) 
 		throw Exc("HDF: Size is not 1");
 
 	int i;
-    if (H5Dread(obj_id, datatype_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, &i) < 0) 
+    if (H5Dread(ds.id, ds.type, H5S_ALL, H5S_ALL, H5P_DEFAULT, &i) < 0) 
         throw Exc("HDF: Impossible to read data");
     return i;
 }
 
 double Hdf5File::GetDouble(String name) {
-	int sz;
-	HidO obj_id;
-	hid_t datatype_id, dspace;
-	Vector<int> dims;
-	GetData0(name, obj_id, datatype_id, dspace, sz, dims);
-
-	H5T_class_t clss = H5Tget_class(datatype_id);
-	if (clss != H5T_FLOAT)
+	const Dataset0 &ds = GetData0(name);
+
+	if (ds.clss != H5T_FLOAT)
 		throw Exc("HDF: Dataset is not double");
 	
-	if (sz != 1) 
+	if (ds.sz != 1) 
 		throw Exc("HDF: Size is not 1");
 	
 	double d;
-    if (H5Dread(obj_id, datatype_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, &d) < 0) 
+    if (H5Dread(ds.id, ds.type, H5S_ALL, H5S_ALL, H5P_DEFAULT, &d) < 0) 
         throw Exc("HDF: Impossible to read data");
     return d;
 }
 
 String Hdf5File::GetString(String name) {
-	int sz;
-	HidO obj_id;
-	hid_t datatype_id, dspace;
-	Vector<int> dims;
-	GetData0(name, obj_id, datatype_id, dspace, sz, dims);
-	
-	H5T_class_t clss = H5Tget_class(datatype_id);
-	if (clss != H5T_STRING)
+	const Dataset0 &ds = GetData0(name);
+	
+	if (ds.clss != H5T_STRING)
 		throw Exc("HDF: Dataset is not string");
 	
-	if (sz != 1) 
+	if (ds.sz != 1) 
 		throw Exc("HDF: Size is not 1");
 	
-	hsize_t len = H5Dget_storage_size(obj_id);
-    for (int id = 0; id < dims.size(); ++id) 
-		len /= (hsize_t)dims[id];
+	hsize_t len = H5Dget_storage_size(ds.id);
+    for (int id = 0; id < ds.dims.size(); ++id) 
+		len /= (hsize_t)ds.dims[id];
     
-	H5S_class_t space_class = H5Sget_simple_extent_type(dspace);
+	H5S_class_t space_class = H5Sget_simple_extent_type(ds.space);
 	
     if (space_class == H5S_SCALAR) {
         StringBuffer bstr((int)len);
-		if (H5Dread(obj_id, datatype_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, ~bstr) >= 0) 
+		if (H5Dread(ds.id, ds.type, H5S_ALL, H5S_ALL, H5P_DEFAULT, ~bstr) >= 0) 
 			return String(bstr);
 		throw Exc("HDF: Problem reading scalar string");
     } else {
-        hssize_t size = H5Sget_simple_extent_npoints(dspace);
+        hssize_t size = H5Sget_simple_extent_npoints(ds.space);
     	Buffer<char *> bstr((size_t)size);
-		if (H5Dread(obj_id, datatype_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, ~bstr) >= 0) 
+		if (H5Dread(ds.id, ds.type, H5S_ALL, H5S_ALL, H5P_DEFAULT, ~bstr) >= 0) 
 			return String(bstr[0]);
 		throw Exc("HDF: Problem reading string");
     }
@@ -322,82 +637,704 @@ String Hdf5File::GetString(String name) {
 }
 
 void Hdf5File::GetDouble(String name, Eigen::VectorXd &data) {
-	int sz;
-	HidO obj_id;
-	hid_t datatype_id, dspace;
-	Vector<int> dims;
-	GetData0(name, obj_id, datatype_id, dspace, sz, dims);
+	const Dataset0 &ds = GetData0(name);
 	
-	if (!(dims.size() == 1) && (dims.size() == 2 && dims[0] != 1 && dims[1] != 1))
+	if (!(ds.dims.size() == 1) && (ds.dims.size() == 2 && ds.dims[0] != 1 && ds.dims[1] != 1))
 		throw Exc("HDF: Dimension different than one");
 	
-	H5T_class_t clss = H5Tget_class(datatype_id);
-	if (clss != H5T_FLOAT)
+	if (ds.clss != H5T_FLOAT)
 		throw Exc("HDF: Dataset is not double");
 	
-	data.resize(dims[0]);
-	if (H5Dread(obj_id, datatype_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data()) < 0) 
-		throw Exc("HDF: Impossible to read data");
+	data.resize(ds.dims[0]);
+	ReadDouble0(ds, H5S_ALL, H5S_ALL, data.data());
 }
 
 void Hdf5File::GetDouble(String name, Vector<double> &data) {
-	int sz;
-	HidO obj_id;
-	hid_t datatype_id, dspace;
-	Vector<int> dims;
-	GetData0(name, obj_id, datatype_id, dspace, sz, dims);
+	const Dataset0 &ds = GetData0(name);
 	
-	if (!(dims.size() == 1) && (dims.size() == 2 && dims[0] != 1 && dims[1] != 1))
+	if (!(ds.dims.size() == 1) && (ds.dims.size() == 2 && ds.dims[0] != 1 && ds.dims[1] != 1))
 		throw Exc("HDF: Dimension different than one");
 	
-	H5T_class_t clss = H5Tget_class(datatype_id);
-	if (clss != H5T_FLOAT)
+	if (ds.clss != H5T_FLOAT)
 		throw Exc("HDF: Dataset is not double");
 	
-	data.SetCount(int(dims[0]));
-	if (H5Dread(obj_id, datatype_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.begin()) < 0) 
-		throw Exc("HDF: Impossible to read data");
+	data.SetCount(int(ds.dims[0]));
+	ReadDouble0(ds, H5S_ALL, H5S_ALL, data.begin());
 }
 
 void Hdf5File::GetDouble(String name, Eigen::MatrixXd &data) {
-	int sz;
-	HidO obj_id;
-	hid_t datatype_id, dspace;
-	Vector<int> dims;
-	GetData0(name, obj_id, datatype_id, dspace, sz, dims);
+	const Dataset0 &ds = GetData0(name);
 	
-	if (dims.size() != 2)
+	if (ds.dims.size() != 2)
 		throw Exc("HDF: Dimension different than two");
 	
-	H5T_class_t clss = H5Tget_class(datatype_id);
-	if (clss != H5T_FLOAT)
+	if (ds.clss != H5T_FLOAT)
 		throw Exc("HDF: Dataset is not double");
 	
-	Buffer<double> d((size_t)sz);
-	if (H5Dread(obj_id, datatype_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, d.Get()) < 0) 
-		throw Exc("HDF: Impossible to read data");
-	
-	CopyRowMajor(d.Get(), int(dims[0]), int(dims[1]), data);
+	if (ds.colmajor) {
+		data.resize(ds.dims[1], ds.dims[0]);
+		ReadDouble0(ds, H5S_ALL, H5S_ALL, data.data());
+	} else if (ds.dims[0] == ds.dims[1]) {
+		data.resize(ds.dims[0], ds.dims[1]);
+		ReadDouble0(ds, H5S_ALL, H5S_ALL, data.data());
+		TransposeInPlace0(data.data(), ds.dims[0]);
+	} else {
+		Buffer<double> d((size_t)ds.sz);
+		ReadDouble0(ds, H5S_ALL, H5S_ALL, d.Get());
+		data.resize(ds.dims[0], ds.dims[1]);
+		RowMajorToColMajor0(d.Get(), data.data(), ds.dims);
+	}
 }
 
 void Hdf5File::GetDouble(String name, MultiDimMatrixRowMajor<double> &d) {
-	int sz;
-	HidO obj_id;
-	hid_t datatype_id, dspace;
-	Vector<int> dims;
-	GetData0(name, obj_id, datatype_id, dspace, sz, dims);
+	const Dataset0 &ds = GetData0(name);
+	
+	if (ds.clss != H5T_FLOAT)
+		throw Exc("HDF: Dataset is not double");
 	
-	d.Resize(dims);
+	if (ds.colmajor) {
+		Buffer<double> d_col((size_t)ds.sz);
+		ReadDouble0(ds, H5S_ALL, H5S_ALL, d_col.Get());
+		Vector<int> ldims = Reverse0(ds.dims);
+		d.Resize(ldims);
+		ColMajorToRowMajor0(d_col.Get(), d.begin(), ldims);
+	} else {
+		d.Resize(ds.dims);
+		ReadDouble0(ds, H5S_ALL, H5S_ALL, d.begin());
+	}
+}
+	
+void Hdf5File::SelectHyperslab0(hid_t dspace, const Vector<int> &dims, const Vector<int> &start, const Vector<int> &count, 
+				const Vector<int> &stride, const Vector<int> &block, bool colmajor, HidS &memspace, Vector<int> &seldims) {
+	if (colmajor) {		// Indices come in Eigen order, the reverse of the file order
+		Vector<int> rstride = Reverse0(stride), rblock = Reverse0(block);
+		SelectHyperslab0(dspace, dims, Reverse0(start), Reverse0(count), rstride, rblock, false, memspace, seldims);
+		seldims = Reverse0(seldims);
+		return;
+	}
+	
+	int rank = dims.size();
+	if (start.size() != rank || count.size() != rank)
+		throw Exc(F("HDF: Hyperslab start and count have to have %d dimensions", rank));
+	if (!stride.IsEmpty() && stride.size() != rank)
+		throw Exc(F("HDF: Hyperslab stride has to have %d dimensions", rank));
+	if (!block.IsEmpty() && block.size() != rank)
+		throw Exc(F("HDF: Hyperslab block has to have %d dimensions", rank));
+	
+	Buffer<hsize_t> hstart(rank), hcount(rank), hstride(rank), hblock(rank), hseldims(rank);
+	seldims.SetCount(rank);
+	for (int i = 0; i < rank; ++i) {
+		int str = stride.IsEmpty() ? 1 : stride[i];
+		int blk = block.IsEmpty() ? 1 : block[i];
+		if (start[i] < 0 || count[i] < 1 || str < 1 || blk < 1)
+			throw Exc(F("HDF: Wrong hyperslab in dimension %d", i));
+		if (str < blk)
+			throw Exc(F("HDF: Hyperslab blocks overlap in dimension %d", i));
+		if ((int64)start[i] + (int64)(count[i]-1)*str + blk > dims[i])
+			throw Exc(F("HDF: Hyperslab out of bounds in dimension %d", i));
+		hstart[i]  = (hsize_t)start[i];
+		hcount[i]  = (hsize_t)count[i];
+		hstride[i] = (hsize_t)str;
+		hblock[i]  = (hsize_t)blk;
+		hseldims[i] = (hsize_t)(seldims[i] = count[i]*blk);
+	}
+	if (H5Sselect_hyperslab(dspace, H5S_SELECT_SET, hstart, hstride, hcount, hblock) < 0)
+		throw Exc("HDF: Impossible to select hyperslab");
+	
+	memspace = H5Screate_simple(rank, hseldims, NULL);
+	if (memspace < 0) 
+        throw Exc("HDF: Error creating dataspace");
+}
+
+void Hdf5File::GetDouble(String name, const Vector<int> &start, const Vector<int> &count, Eigen::VectorXd &data, 
+						 const Vector<int> &stride, const Vector<int> &block) {
+	const Dataset0 &ds = GetData0(name);
+	HidS fspace = H5Scopy(ds.space);		// The selection is not kept in the cache
+	
+	if (ds.clss != H5T_FLOAT)
+		throw Exc("HDF: Dataset is not double");
+	
+	bool colmajor = ds.colmajor;
+	HidS memspace;
+	Vector<int> seldims;
+	SelectHyperslab0(fspace, ds.dims, start, count, stride, block, colmajor, memspace, seldims);
+	
+	Eigen::Index selsz = 1;
+	for (int i = 0; i < seldims.size(); ++i)
+		selsz *= seldims[i];
+	
+	data.resize(selsz);
+	if (colmajor) {
+		Buffer<double> d_col((size_t)selsz);
+		ReadDouble0(ds, memspace, fspace, d_col.Get());
+		ColMajorToRowMajor0(d_col.Get(), data.data(), seldims);
+	} else
+		ReadDouble0(ds, memspace, fspace, data.data());
+}
+
+void Hdf5File::GetDouble(String name, const Vector<int> &start, const Vector<int> &count, Vector<double> &data, 
+						 const Vector<int> &stride, const Vector<int> &block) {
+	const Dataset0 &ds = GetData0(name);
+	HidS fspace = H5Scopy(ds.space);		// The selection is not kept in the cache
 	
-	H5T_class_t clss = H5Tget_class(datatype_id);
-	if (clss != H5T_FLOAT)
+	if (ds.clss != H5T_FLOAT)
 		throw Exc("HDF: Dataset is not double");
 	
-	if (H5Dread(obj_id, datatype_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, d.begin()) < 0) 
+	bool colmajor = ds.colmajor;
+	HidS memspace;
+	Vector<int> seldims;
+	SelectHyperslab0(fspace, ds.dims, start, count, stride, block, colmajor, memspace, seldims);
+	
+	int selsz = 1;
+	for (int i = 0; i < seldims.size(); ++i)
+		selsz *= seldims[i];
+	
+	data.SetCount(selsz);
+	if (colmajor) {
+		Buffer<double> d_col((size_t)selsz);
+		ReadDouble0(ds, memspace, fspace, d_col.Get());
+		ColMajorToRowMajor0(d_col.Get(), data.begin(), seldims);
+	} else
+		ReadDouble0(ds, memspace, fspace, data.begin());
+}
+
+void Hdf5File::GetDouble(String name, const Vector<int> &start, const Vector<int> &count, Eigen::MatrixXd &data, 
+						 const Vector<int> &stride, const Vector<int> &block) {
+	const Dataset0 &ds = GetData0(name);
+	HidS fspace = H5Scopy(ds.space);		// The selection is not kept in the cache
+	
+	if (ds.dims.size() != 2)
+		throw Exc("HDF: Dimension different than two");
+	
+	if (ds.clss != H5T_FLOAT)
+		throw Exc("HDF: Dataset is not double");
+	
+	bool colmajor = ds.colmajor;
+	HidS memspace;
+	Vector<int> seldims;
+	SelectHyperslab0(fspace, ds.dims, start, count, stride, block, colmajor, memspace, seldims);
+	
+	data.resize(seldims[0], seldims[1]);
+	if (colmajor) {
+		ReadDouble0(ds, memspace, fspace, data.data());
+	} else {
+		Buffer<double> d((size_t)seldims[0]*seldims[1]);
+		ReadDouble0(ds, memspace, fspace, d.Get());
+		RowMajorToColMajor0(d.Get(), data.data(), seldims);
+	}
+}
+
+void Hdf5File::GetDouble(String name, const Vector<int> &start, const Vector<int> &count, MultiDimMatrixRowMajor<double> &d, 
+						 const Vector<int> &stride, const Vector<int> &block) {
+	const Dataset0 &ds = GetData0(name);
+	HidS fspace = H5Scopy(ds.space);		// The selection is not kept in the cache
+	
+	if (ds.clss != H5T_FLOAT)
+		throw Exc("HDF: Dataset is not double");
+	
+	bool colmajor = ds.colmajor;
+	HidS memspace;
+	Vector<int> seldims;
+	SelectHyperslab0(fspace, ds.dims, start, count, stride, block, colmajor, memspace, seldims);
+	
+	d.Resize(seldims);
+	
+	if (colmajor) {
+		size_t selsz = 1;
+		for (int i = 0; i < seldims.size(); ++i)
+			selsz *= (size_t)seldims[i];
+		Buffer<double> d_col(selsz);
+		ReadDouble0(ds, memspace, fspace, d_col.Get());
+		ColMajorToRowMajor0(d_col.Get(), d.begin(), seldims);
+	} else
+		ReadDouble0(ds, memspace, fspace, d.begin());
+}
+
+// Filters encoded and decoded by WriteChunks0() and ReadChunks0()
+struct ChunkFilter0 {
+	H5Z_filter_t id;
+	size_t elsize;		// Shuffle element size
+	int level;			// Deflate or Zstandard level, LZ4 block size
+};
+
+static bool GetChunkFilters0(hid_t dcpl, Vector<ChunkFilter0> &filters) {
+	int nfilters = H5Pget_nfilters(dcpl);
+	if (nfilters <= 0)
+		return false;
+	for (int i = 0; i < nfilters; ++i) {
+		unsigned flags, cd_values[8];
+		size_t cd_nelmts = 8;
+		ChunkFilter0 &f = filters.Add();
+		f.id = H5Pget_filter2(dcpl, (unsigned)i, &flags, &cd_nelmts, cd_values, 0, NULL, NULL);
+		if (f.id != H5Z_FILTER_DEFLATE && f.id != H5Z_FILTER_SHUFFLE && f.id != H5Z_FILTER_FLETCHER32
+#ifdef H5_HAVE_FILTER_LZ4
+			&& f.id != H5Z_FILTER_LZ4
+#endif
+#ifdef H5_HAVE_FILTER_ZSTD
+			&& f.id != H5Z_FILTER_ZSTD
+#endif
+			)
+			return false;
+		f.elsize = cd_nelmts > 0 && cd_values[0] > 0 ? cd_values[0] : sizeof(double);
+		if (f.id == H5Z_FILTER_DEFLATE)
+			f.level = cd_nelmts > 0 ? (int)cd_values[0] : Z_DEFAULT_COMPRESSION;
+		else
+			f.level = cd_nelmts > 0 ? (int)cd_values[0] : 0;
+	}
+	return true;
+}
+
+static uint32_t Get32be0(const byte *p) {
+	return ((uint32_t)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+static void Set32be0(byte *p, uint32_t v) {
+	p[0] = byte(v >> 24);
+	p[1] = byte(v >> 16);
+	p[2] = byte(v >> 8);
+	p[3] = byte(v);
+}
+
+static void DecodeChunk0(const Vector<ChunkFilter0> &filters, uint32_t mask, Buffer<byte> &buf, size_t &len, size_t chunkbytes) {
+	for (int i = filters.size()-1; i >= 0; --i) {
+		if (mask & (1u << i))		// Optional filter skipped when writing
+			continue;
+		const ChunkFilter0 &f = filters[i];
+		if (f.id == H5Z_FILTER_FLETCHER32) {
+			if (len < 4)
+				throw Exc("HDF: Wrong chunk size");
+			len -= 4;
+			const byte *p = ~buf + len;
+			uint32_t stored = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+			uint32_t sum = H5_checksum_fletcher32(~buf, len);
+			uint32_t reversed = ((sum & 0x00ff00ff) << 8) | ((sum >> 8) & 0x00ff00ff);	// Written before HDF5 1.6.3
+			if (stored != sum && stored != reversed)
+				throw Exc("HDF: Data error detected by Fletcher32 checksum");
+		} else if (f.id == H5Z_FILTER_DEFLATE) {
+			Buffer<byte> out(chunkbytes);
+			uLongf outlen = (uLongf)chunkbytes;
+			if (uncompress(~out, &outlen, ~buf, (uLong)len) != Z_OK)
+				throw Exc("HDF: Impossible to inflate chunk");
+			buf = pick(out);
+			len = outlen;
+#ifdef H5_HAVE_FILTER_LZ4
+		} else if (f.id == H5Z_FILTER_LZ4) {		// Sizes in big-endian, and blocks that don't shrink stored as is
+			if (len < 12)
+				throw Exc("HDF: Wrong chunk size");
+			const byte *p = ~buf, *end = p + len;
+			uint64_t orig = ((uint64_t)Get32be0(p) << 32) | Get32be0(p + 4);
+			size_t block = Get32be0(p + 8);
+			p += 12;
+			if (orig > chunkbytes || (orig > 0 && block == 0))
+				throw Exc("HDF: Wrong chunk size");
+			size_t outlen = (size_t)orig;
+			Buffer<byte> out(max<size_t>(outlen, 1));
+			for (size_t done = 0; done < outlen; ) {
+				size_t n = min(block, outlen - done);
+				if (end - p < 4)
+					throw Exc("HDF: Wrong chunk size");
+				size_t complen = Get32be0(p);
+				p += 4;
+				if ((size_t)(end - p) < complen)
+					throw Exc("HDF: Wrong chunk size");
+				if (complen == n)
+					memcpy(~out + done, p, n);
+				else if (LZ4_decompress_safe((const char *)p, (char *)~out + done, (int)complen, (int)n) != (int)n)
+					throw Exc("HDF: Impossible to decompress LZ4 chunk");
+				p += complen;
+				done += n;
+			}
+			buf = pick(out);
+			len = outlen;
+#endif
+#ifdef H5_HAVE_FILTER_ZSTD
+		} else if (f.id == H5Z_FILTER_ZSTD) {
+			unsigned long long orig = ZSTD_getFrameContentSize(~buf, len);
+			if (orig > chunkbytes)		// Also the unknown and error values
+				throw Exc("HDF: Wrong chunk size");
+			size_t outlen = (size_t)orig;
+			Buffer<byte> out(max<size_t>(outlen, 1));
+			size_t ret = ZSTD_decompress(~out, outlen, ~buf, len);
+			if (ZSTD_isError(ret) || ret != outlen)
+				throw Exc("HDF: Impossible to decompress Zstandard chunk");
+			buf = pick(out);
+			len = outlen;
+#endif
+		} else if (f.id == H5Z_FILTER_SHUFFLE) {
+			size_t es = f.elsize, n = len/es;
+			if (es > 1 && n > 1) {
+				Buffer<byte> out(len);
+				H5Z_shuffle_buf(~out, ~buf, len, (unsigned)es, true);
+				buf = pick(out);
+			}
+		}
+	}
+	if (len != chunkbytes)
+		throw Exc("HDF: Wrong chunk size");
+}
+
+static void EncodeChunk0(const Vector<ChunkFilter0> &filters, Buffer<byte> &buf, size_t &len) {
+	for (const ChunkFilter0 &f : filters) {
+		if (f.id == H5Z_FILTER_SHUFFLE) {
+			size_t es = f.elsize, n = len/es;
+			if (es > 1 && n > 1) {
+				Buffer<byte> out(len);
+				H5Z_shuffle_buf(~out, ~buf, len, (unsigned)es, false);
+				buf = pick(out);
+			}
+		} else if (f.id == H5Z_FILTER_DEFLATE) {
+			uLongf outlen = compressBound((uLong)len);
+			Buffer<byte> out(outlen);
+			if (compress2(~out, &outlen, ~buf, (uLong)len, f.level) != Z_OK)
+				throw Exc("HDF: Impossible to deflate chunk");
+			buf = pick(out);
+			len = outlen;
+#ifdef H5_HAVE_FILTER_LZ4
+		} else if (f.id == H5Z_FILTER_LZ4) {
+			if (len > INT32_MAX)
+				throw Exc("HDF: Chunk is too large for LZ4");
+			size_t block = f.level > 0 ? min<size_t>((size_t)f.level, len) : min<size_t>(1 << 30, len);
+			size_t nblocks = len > 0 ? (len - 1)/block + 1 : 0;
+			Buffer<byte> out(12 + 4*nblocks + len);
+			byte *p = ~out;
+			Set32be0(p, uint32_t((uint64_t)len >> 32));
+			Set32be0(p + 4, uint32_t(len));
+			Set32be0(p + 8, uint32_t(block));
+			p += 12;
+			for (size_t done = 0; done < len; done += block) {
+				size_t n = min(block, len - done);
+				int complen = n > 1 ? LZ4_compress_default((const char *)~buf + done, (char *)p + 4, (int)n, (int)n - 1) : 0;
+				if (complen <= 0) {
+					memcpy(p + 4, ~buf + done, n);
+					complen = (int)n;
+				}
+				Set32be0(p, (uint32_t)complen);
+				p += 4 + complen;
+			}
+			len = p - ~out;
+			buf = pick(out);
+#endif
+#ifdef H5_HAVE_FILTER_ZSTD
+		} else if (f.id == H5Z_FILTER_ZSTD) {
+			int level = f.level != 0 ? minmax(f.level, ZSTD_minCLevel(), ZSTD_maxCLevel()) : ZSTD_CLEVEL_DEFAULT;
+			size_t outlen = ZSTD_compressBound(len);
+			Buffer<byte> out(outlen);
+			outlen = ZSTD_compress(~out, outlen, ~buf, len, level);
+			if (ZSTD_isError(outlen))
+				throw Exc("HDF: Impossible to compress Zstandard chunk");
+			buf = pick(out);
+			len = outlen;
+#endif
+		} else if (f.id == H5Z_FILTER_FLETCHER32) {
+			Buffer<byte> out(len + 4);
+			memcpy(~out, ~buf, len);
+			uint32_t sum = H5_checksum_fletcher32(~buf, len);
+			byte *p = ~out + len;
+			p[0] = byte(sum);
+			p[1] = byte(sum >> 8);
+			p[2] = byte(sum >> 16);
+			p[3] = byte(sum >> 24);
+			buf = pick(out);
+			len += 4;
+		}
+	}
+}
+
+void Hdf5File::ReadDouble0(const Dataset0 &ds, hid_t memspace, hid_t fspace, double *data) {
+	if (parallel_decode && ReadChunks0(ds, memspace, fspace, data))
+		return;
+	if (H5Dread(ds.id, H5T_NATIVE_DOUBLE, memspace, fspace, H5P_DEFAULT, data) < 0) 
 		throw Exc("HDF: Impossible to read data");
 }
+
+// Reads the raw chunks in the selection and decodes them in parallel, outside the library.
+// Returns false if the dataset or the selection are not supported, so that H5Dread() is used
+bool Hdf5File::ReadChunks0(const Dataset0 &ds, hid_t memspace, hid_t fspace, double *data) {
+	int rank = ds.dims.size();
+	if (rank == 0 || H5Tequal(ds.type, H5T_NATIVE_DOUBLE) <= 0)
+		return false;
+	if (memspace != H5S_ALL && H5Sget_select_type(memspace) != H5S_SEL_ALL)
+		return false;
+	
+	HidP dcpl = H5Dget_create_plist(ds.id);
+	if (dcpl < 0 || H5Pget_layout(dcpl) != H5D_CHUNKED)
+		return false;
+	Vector<ChunkFilter0> filters;
+	if (!GetChunkFilters0(dcpl, filters))
+		return false;
+	
+	Buffer<hsize_t> chunk(rank), start(rank), stride(rank), count(rank), block(rank);
+	if (H5Pget_chunk(dcpl, rank, chunk) != rank)
+		return false;
+	if (fspace == H5S_ALL) {
+		for (int i = 0; i < rank; ++i) {
+			start[i] = 0;
+			count[i] = 1;
+			stride[i] = block[i] = (hsize_t)ds.dims[i];
+		}
+	} else if (H5Sis_regular_hyperslab(fspace) <= 0 || 
+			   H5Sget_regular_hyperslab(fspace, start, stride, count, block) < 0)
+		return false;
+	
+	// Selection bounds and strides of the chunks and of the selection in memory
+	Vector<int64> lo(rank), hi(rank), cstride(rank), mstride(rank);
+	int64 nexpected = 1;
+	for (int i = rank-1; i >= 0; --i) {
+		lo[i] = (int64)start[i];
+		hi[i] = (int64)(start[i] + (count[i]-1)*stride[i] + block[i]);
+		nexpected *= (hi[i] + chunk[i] - 1)/chunk[i] - lo[i]/chunk[i];
+		cstride[i] = i == rank-1 ? 1 : cstride[i+1]*(int64)chunk[i+1];
+		mstride[i] = i == rank-1 ? 1 : mstride[i+1]*(int64)(count[i+1]*block[i+1]);
+	}
+	if (nexpected < 2)
+		return false;
 	
+	size_t chunkbytes = sizeof(double);
+	for (int i = 0; i < rank; ++i)
+		chunkbytes *= (size_t)chunk[i];
+	double fill = 0;		// Chunks never written are read as the fill value
+	H5Pget_fill_value(dcpl, H5T_NATIVE_DOUBLE, &fill);
+	
+	struct Raw0 {
+		Buffer<byte> buf;
+		size_t len;
+		uint32_t mask;
+		bool missing;
+		Vector<Vector<int64>> src, dst;		// Selected positions in the chunk and in memory, by dimension
+	};
+	Array<Raw0> raws;		// The chunks being decoded
+	size_t rawbytes = 0;
+	const size_t maxrawbytes = 64 << 20;
+	int maxraws = 4*CPU_Cores();
+	
+	// Only the chunks in the selection bounds are looked up, in the order of their offsets
+	Buffer<hsize_t> offset(rank), first(rank), last(rank);
+	for (int i = 0; i < rank; ++i) {
+		offset[i] = first[i] = (hsize_t)lo[i]/chunk[i]*chunk[i];
+		last[i] = (hsize_t)(hi[i] - 1)/chunk[i]*chunk[i];
+	}
+	CoWork co;
+	for (bool done = false; !done; ) {
+		Raw0 &raw = raws.Add();
+		raw.src.SetCount(rank);
+		raw.dst.SetCount(rank);
+		bool empty = false;
+		for (int i = 0; i < rank && !empty; ++i) {
+			int64 end = min((int64)(offset[i] + chunk[i]), hi[i]);
+			for (int64 x = max((int64)offset[i], lo[i]); x < end; ++x) {
+				int64 r = x - lo[i], q = r/(int64)stride[i], p = r%(int64)stride[i];
+				if (p < (int64)block[i]) {
+					raw.src[i] << x - (int64)offset[i];
+					raw.dst[i] << q*(int64)block[i] + p;
+				}
+			}
+			empty = raw.src[i].IsEmpty();
+		}
+		haddr_t addr = HADDR_UNDEF;
+		hsize_t size = 0;
+		if (empty)				// Between the strides
+			raws.Drop();
+		else if (H5Dget_chunk_info_by_coord(ds.id, offset, &raw.mask, &addr, &size) < 0)
+			throw Exc("HDF: Impossible to get chunk info");
+		else {
+			raw.missing = addr == HADDR_UNDEF;
+			if (!raw.missing) {
+				raw.len = (size_t)size;
+				raw.buf.Alloc(max<size_t>(raw.len, 1));
+				if (H5Dread_chunk(ds.id, H5P_DEFAULT, offset, &raw.mask, ~raw.buf) < 0)
+					throw Exc("HDF: Impossible to read chunk");
+				rawbytes += raw.len + chunkbytes;
+			}
+			
+			Raw0 *praw = &raw;
+			co & [=, &filters, &cstride, &mstride] {
+				Raw0 &raw = *praw;
+				if (!raw.missing)
+					DecodeChunk0(filters, raw.mask, raw.buf, raw.len, chunkbytes);
+				const double *src = (const double *)~raw.buf;
+				const Vector<int64> &lsrc = raw.src[rank-1], &ldst = raw.dst[rank-1];
+				Vector<int> idx(rank-1, 0);
+				for (;;) {
+					int64 srcbase = 0, dstbase = 0;
+					for (int i = 0; i < rank-1; ++i) {
+						srcbase += raw.src[i][idx[i]]*cstride[i];
+						dstbase += raw.dst[i][idx[i]]*mstride[i];
+					}
+					for (int j = 0; j < lsrc.size();) {		// Copies the contiguous runs
+						int k = j + 1;
+						while (k < lsrc.size() && lsrc[k] == lsrc[k-1] + 1 && ldst[k] == ldst[k-1] + 1)
+							k++;
+						if (raw.missing)
+							std::fill(data + dstbase + ldst[j], data + dstbase + ldst[k-1] + 1, fill);
+						else
+							memcpy(data + dstbase + ldst[j], src + srcbase + lsrc[j], (k - j)*sizeof(double));
+						j = k;
+					}
+					int i = rank-2;
+					for (; i >= 0 && ++idx[i] == raw.src[i].size(); --i)
+						idx[i] = 0;
+					if (i < 0)
+						break;
+				}
+				raw.buf.Clear();
+			};
+		}
+		
+		int i = rank-1;
+		for (; i >= 0 && (offset[i] += chunk[i]) > last[i]; --i)
+			offset[i] = first[i];
+		done = i < 0;
+		if (rawbytes >= maxrawbytes || raws.size() >= maxraws) {	// Bounds the memory of the chunks in flight
+			co.Finish();
+			raws.Clear();
+			rawbytes = 0;
+		}
+	}
+	co.Finish();
+	return true;
+}
+
+Hdf5File::Batch::Item &Hdf5File::Batch::Add(String name, H5T_class_t clss, hid_t memtype) {
+	Item &it = items.Add();
+	it.name = name;
+	it.clss = clss;
+	it.memtype = memtype;
+	return it;
+}
+
+Hdf5File::Batch &Hdf5File::Batch::Get(String name, int &d) {
+	Item &it = Add(name, H5T_INTEGER, H5T_NATIVE_INT);
+	it.Prepare = [&d](const Vector<int> &, bool, int sz)->void * {
+		if (sz != 1) 
+			throw Exc("HDF: Size is not 1");
+		return &d;
+	};
+	return *this;
+}
+
+Hdf5File::Batch &Hdf5File::Batch::Get(String name, double &d) {
+	Item &it = Add(name, H5T_FLOAT, H5T_NATIVE_DOUBLE);
+	it.Prepare = [&d](const Vector<int> &, bool, int sz)->void * {
+		if (sz != 1) 
+			throw Exc("HDF: Size is not 1");
+		return &d;
+	};
+	return *this;
+}
+
+static void CheckVector0(const Vector<int> &dims) {
+	if (!(dims.size() == 1 || (dims.size() == 2 && (dims[0] == 1 || dims[1] == 1))))
+		throw Exc("HDF: Dimension different than one");
+}
+
+Hdf5File::Batch &Hdf5File::Batch::Get(String name, Eigen::VectorXd &data) {
+	Item &it = Add(name, H5T_FLOAT, H5T_NATIVE_DOUBLE);
+	it.Prepare = [&data](const Vector<int> &dims, bool, int sz)->void * {
+		CheckVector0(dims);
+		data.resize(sz);
+		return data.data();
+	};
+	return *this;
+}
+
+Hdf5File::Batch &Hdf5File::Batch::Get(String name, Vector<double> &data) {
+	Item &it = Add(name, H5T_FLOAT, H5T_NATIVE_DOUBLE);
+	it.Prepare = [&data](const Vector<int> &dims, bool, int sz)->void * {
+		CheckVector0(dims);
+		data.SetCount(sz);
+		return data.begin();
+	};
+	return *this;
+}
+
+Hdf5File::Batch &Hdf5File::Batch::Get(String name, Eigen::MatrixXd &data) {
+	Item &it = Add(name, H5T_FLOAT, H5T_NATIVE_DOUBLE);
+	it.Prepare = [&it, &data](const Vector<int> &dims, bool colmajor, int sz)->void * {
+		if (dims.size() != 2)
+			throw Exc("HDF: Dimension different than two");
+		if (colmajor) {
+			data.resize(dims[1], dims[0]);
+			return data.data();
+		}
+		data.resize(dims[0], dims[1]);
+		it.dims = clone(dims);
+		it.d_row.Alloc(sz);
+		it.Finish = [&it, &data] {RowMajorToColMajor0(~it.d_row, data.data(), it.dims);};
+		return ~it.d_row;
+	};
+	return *this;
+}
+
+Hdf5File::Batch &Hdf5File::Batch::Get(String name, MultiDimMatrixRowMajor<double> &d) {
+	Item &it = Add(name, H5T_FLOAT, H5T_NATIVE_DOUBLE);
+	it.Prepare = [&it, &d](const Vector<int> &dims, bool colmajor, int sz)->void * {
+		if (!colmajor) {
+			d.Resize(dims);
+			return d.begin();
+		}
+		it.dims = Reverse0(dims);
+		d.Resize(it.dims);
+		it.d_row.Alloc(sz);
+		it.Finish = [&it, &d] {ColMajorToRowMajor0(~it.d_row, d.begin(), it.dims);};
+		return ~it.d_row;
+	};
+	return *this;
+}
+
+void Hdf5File::GetMany(Batch &batch) {
+	Array<HidD> held;			// Cached datasets may be evicted while the batch is prepared
+	VectorMap<String, int> nread;	// A dataset can be only once in each H5Dread_multi()
+	Vector<Vector<hid_t>> dset_ids, mem_types;
+	Vector<Vector<void *>> bufs;
+	
+	for (int i = 0; i < batch.items.GetCount(); ++i) {
+		Batch::Item &it = batch.items[i];
+		it.Finish = Function<void ()>();
+		
+		const Dataset0 &ds = GetData0(it.name);
+		if (ds.clss != it.clss)
+			throw Exc(F("HDF: Dataset '%s' is not %s", it.name, it.clss == H5T_INTEGER ? "integer" : "double"));
+		void *buf = it.Prepare(ds.dims, ds.colmajor, ds.sz);
+		if (ds.sz == 0)
+			continue;
+		
+		H5Iinc_ref(ds.id);
+		held.Add() = (hid_t)ds.id;
+		int round = nread.GetAdd(GetDatasetKey0(it.name), 0)++;
+		if (round >= dset_ids.size()) {
+			dset_ids.Add();
+			mem_types.Add();
+			bufs.Add();
+		}
+		dset_ids[round] << ds.id;
+		mem_types[round] << it.memtype;
+		bufs[round] << buf;
+	}
+	for (int r = 0; r < dset_ids.size(); ++r) {
+		Vector<hid_t> spaces(dset_ids[r].size(), H5S_ALL);
+		if (H5Dread_multi((size_t)dset_ids[r].size(), dset_ids[r].begin(), mem_types[r].begin(), 
+						  spaces.begin(), spaces.begin(), H5P_DEFAULT, bufs[r].begin()) < 0)
+			throw Exc("HDF: Impossible to read data");
+	}
+	
+	for (int i = 0; i < batch.items.GetCount(); ++i) {
+		Batch::Item &it = batch.items[i];
+		if (it.Finish) {
+			it.Finish();
+			it.Finish = Function<void ()>();
+		}
+		it.d_row.Clear();
+	}
+}
+
 void Hdf5File::SetAttributes0(hid_t dset_id, String attribute, String val) {
+	if (H5Aexists(dset_id, ~attribute) > 0) {
+		if (GetAttribute0(dset_id, attribute) == val)
+			return;
+		if (H5Adelete(dset_id, ~attribute) < 0)
+			throw Exc("HDF: Impossible to replace attribute");
+	}
+	
     hid_t attr_id_desc = H5Screate(H5S_SCALAR);
     hid_t attr_type_desc = H5Tcopy(H5T_C_S1);
     H5Tset_size(attr_type_desc, H5T_VARIABLE);
@@ -410,29 +1347,389 @@ void Hdf5File::SetAttributes0(hid_t dset_id, String attribute, String val) {
     H5Sclose(attr_id_desc);
 }
 
+String Hdf5File::GetAttribute0(hid_t obj_id, String attribute) {
+	if (H5Aexists(obj_id, ~attribute) <= 0)
+		return Null;
+	
+	hid_t attr_id = H5Aopen(obj_id, ~attribute, H5P_DEFAULT);
+	if (attr_id < 0)
+		return Null;
+	String ret;
+	hid_t attr_type = H5Aget_type(attr_id);
+	if (H5Tget_class(attr_type) == H5T_STRING && H5Tis_variable_str(attr_type) > 0) {
+		char *p = NULL;
+		if (H5Aread(attr_id, attr_type, &p) >= 0 && p) {
+			ret = p;
+			H5free_memory(p);
+		}
+	}
+	H5Tclose(attr_type);
+	H5Aclose(attr_id);
+	return ret;
+}
+
+Vector<int> Hdf5File::Reverse0(const Vector<int> &v) {
+	Vector<int> ret(v.size());
+	for (int i = 0; i < v.size(); ++i)
+		ret[i] = v[v.size()-1-i];
+	return ret;
+}
+
+// Copies between row-major and column-major arrays. The two axes that are contiguous 
+// in one of the layouts are walked in square tiles, and the tiles are spread over the threads
+void Hdf5File::ChangeMajor0(const double *src, double *dst, const Vector<int> &dims, bool tocolmajor) {
+	const int rank = dims.size();
+	size_t sz = 1;
+	for (int i = 0; i < rank; ++i)
+		sz *= (size_t)dims[i];
+	if (sz == 0)
+		return;
+	if (rank < 2) {
+		memcpy(dst, src, sz*sizeof(double));
+		return;
+	}
+	Buffer<size_t> rstride(rank), cstride(rank);
+	rstride[rank-1] = cstride[0] = 1;
+	for (int i = rank-2; i >= 0; --i)
+		rstride[i] = rstride[i+1]*(size_t)dims[i+1];
+	for (int i = 1; i < rank; ++i)
+		cstride[i] = cstride[i-1]*(size_t)dims[i-1];
+	
+	const size_t na = (size_t)dims[0], nb = (size_t)dims[rank-1];
+	const size_t sa = tocolmajor ? rstride[0] : 1,       sb = tocolmajor ? 1 : cstride[rank-1],
+				 da = tocolmajor ? 1 : rstride[0],       db = tocolmajor ? cstride[rank-1] : 1;
+	const size_t tile = 32, ntiles = (na + tile - 1)/tile;
+	const size_t nunits = ntiles*(sz/(na*nb));
+	
+	auto Run = [&](int from, int to) {
+		for (int u = from; u < to; ++u) {
+			size_t mid = (size_t)u/ntiles, a0 = ((size_t)u % ntiles)*tile;
+			size_t roff = 0, coff = 0;
+			for (int i = rank-2; i > 0; --i) {
+				size_t id = mid % (size_t)dims[i];
+				mid /= (size_t)dims[i];
+				roff += id*rstride[i];
+				coff += id*cstride[i];
+			}
+			const double *s = src + (tocolmajor ? roff : coff);
+			double *d = dst + (tocolmajor ? coff : roff);
+			size_t a1 = min(a0 + tile, na);
+			for (size_t b0 = 0; b0 < nb; b0 += tile) {
+				size_t b1 = min(b0 + tile, nb);
+				for (size_t a = a0; a < a1; ++a)
+					for (size_t b = b0; b < b1; ++b)
+						d[a*da + b*db] = s[a*sa + b*sb];
+			}
+		}
+	};
+	if (sz < 65536)
+		Run(0, int(nunits));
+	else
+		CoPartition(0, int(nunits), Run);
+}
+
+void Hdf5File::TransposeInPlace0(double *d, int n) {
+	const int tile = 32, ntiles = (n + tile - 1)/tile;
+	
+	auto Run = [&](int from, int to) {
+		for (int t = from; t < to; ++t) {
+			int i0 = t*tile, i1 = min(i0 + tile, n);
+			for (int j0 = i0; j0 < n; j0 += tile) {
+				int j1 = min(j0 + tile, n);
+				for (int i = i0; i < i1; ++i)
+					for (int j = max(j0, i + 1); j < j1; ++j)
+						Swap(d[(size_t)i*n + j], d[(size_t)j*n + i]);
+			}
+		}
+	};
+	if ((size_t)n*n < 65536)
+		Run(0, ntiles);
+	else
+		CoPartition(0, ntiles, Run);
+}
+
 Hdf5File &Hdf5File::SetDescription(String description) {
+	if (IsAsync0()) {
+		Async0([this, description] {SetDescription(description);}, description.GetCount());
+		return *this;
+	}
 	if (!IsNull(description))
 		SetAttributes0(dts_id, "description", description);
 	return *this;
 }
 
 Hdf5File &Hdf5File::SetUnits(String units) {
+	if (IsAsync0()) {
+		Async0([this, units] {SetUnits(units);}, units.GetCount());
+		return *this;
+	}
 	if (!IsNull(units))
 		SetAttributes0(dts_id, "units", units);
 	return *this;
 }
     
-Hdf5File &Hdf5File::Set(String name, int d) {
-	if (ExistDataset(name))
+Hdf5Storage &Hdf5Storage::operator=(const Hdf5Storage &s) {
+	chunk = clone(s.chunk);
+	autochunk = s.autochunk;
+	shuffle = s.shuffle;
+	bitshuffle = s.bitshuffle;
+	deflate = s.deflate;
+	lz4 = s.lz4;
+	zstd = s.zstd;
+	fletcher32 = s.fletcher32;
+	scaleoffset = s.scaleoffset;
+	colmajor = s.colmajor;
+	return *this;
+}
+
+Hdf5Storage &Hdf5Storage::Contiguous() {
+	chunk.Clear();
+	autochunk = shuffle = bitshuffle = lz4 = fletcher32 = false;
+	deflate = zstd = scaleoffset = -1;
+	return *this;
+}
+
+Hdf5Storage &Hdf5Storage::Chunk(const Vector<int> &_chunk) {
+	for (int i = 0; i < _chunk.size(); ++i)
+		if (_chunk[i] < 1)
+			throw Exc("HDF: Chunk dimensions have to be positive");
+	chunk = clone(_chunk);
+	return *this;
+}
+
+bool Hdf5Storage::IsChunked() const {
+	return !chunk.IsEmpty() || autochunk || shuffle || bitshuffle || deflate >= 0 || lz4 || zstd >= 0 || fletcher32 || scaleoffset >= 0;
+}
+
+// Chunk shape heuristic from h5py: halve the dimensions in turn until the chunk 
+// is near a target size that grows with the dataset size, between 8 KB and 1 MB
+void Hdf5Storage::GuessChunk(int rank, const hsize_t *dims, size_t typesize, hsize_t *chunk) {
+	const double base = 16*1024, minsz = 8*1024, maxsz = 1024*1024;
+	
+	double dset_size = (double)typesize;
+	for (int i = 0; i < rank; ++i) {
+		chunk[i] = max<hsize_t>(dims[i], 1);
+		dset_size *= (double)chunk[i];
+	}
+	double target = base*pow(2, log10(dset_size/(1024.*1024)));
+	target = minmax(target, minsz, maxsz);
+	
+	for (int idx = 0; ; ++idx) {
+		double chunk_size = (double)typesize, nelem = 1;
+		for (int i = 0; i < rank; ++i) 
+			nelem *= (double)chunk[i];
+		chunk_size *= nelem;
+		if ((chunk_size < target || fabs(chunk_size - target)/target < 0.5) && chunk_size < maxsz)
+			break;
+		if (nelem == 1)
+			break;
+		hsize_t &c = chunk[idx % rank];
+		c = (c + 1)/2;
+	}
+}
+
+hid_t Hdf5Storage::GetDcpl(int rank, const hsize_t *dims, H5T_class_t clss, size_t typesize, const hsize_t *maxdims) const {
+	auto IsUnlimited = [&](int i) {return maxdims && maxdims[i] == H5S_UNLIMITED;};
+	
+	bool extendable = false;
+	for (int i = 0; i < rank; ++i) 
+		extendable = extendable || IsUnlimited(i);
+	
+	if ((!IsChunked() && !extendable) || rank < 1)	// Extendable datasets have to be chunked
+		return H5P_DEFAULT;
+	for (int i = 0; i < rank; ++i)
+		if (dims[i] == 0 && !IsUnlimited(i))		// Chunked fixed size datasets cannot be empty
+			return H5P_DEFAULT;
+	
+	Buffer<hsize_t> cdims(rank);
+	if (!chunk.IsEmpty()) {
+		if (chunk.size() != rank)
+			throw Exc(F("HDF: Chunk has to have %d dimensions", rank));
+		for (int i = 0; i < rank; ++i)
+			cdims[i] = IsUnlimited(i) ? max(chunk[i], 1) : min<hsize_t>((hsize_t)chunk[i], dims[i]);
+	} else {
+		Buffer<hsize_t> gdims(rank);		// Unlimited dimensions are guessed as 1024 long, like h5py
+		for (int i = 0; i < rank; ++i)
+			gdims[i] = IsUnlimited(i) ? max<hsize_t>(dims[i], 1024) : dims[i];
+		GuessChunk(rank, gdims, typesize, cdims);
+	}
+	
+	HidP dcpl = H5Pcreate(H5P_DATASET_CREATE);
+	if (dcpl < 0)
+		throw Exc("HDF: Error creating property list");
+	if (H5Pset_chunk(dcpl, rank, cdims) < 0)
+		throw Exc("HDF: Error setting chunk");
+	if (scaleoffset >= 0) {
+		herr_t ret;
+		if (clss == H5T_FLOAT)
+			ret = H5Pset_scaleoffset(dcpl, H5Z_SO_FLOAT_DSCALE, scaleoffset);
+		else
+			ret = H5Pset_scaleoffset(dcpl, H5Z_SO_INT, H5Z_SO_INT_MINBITS_DEFAULT);
+		if (ret < 0)
+			throw Exc("HDF: Error setting scale-offset filter");
+	}
+	if (bitshuffle) {		// LZ4 and Zstandard are done by the bitshuffle filter, block by block
+		if (H5Zfilter_avail(H5Z_FILTER_BITSHUFFLE) <= 0)
+			throw Exc("HDF: Bitshuffle filter is not available");
+		unsigned cd[H5Z_BSHUF_USER_NPARMS] = {0, H5Z_BSHUF_COMPRESS_NONE, 0};
+		if (lz4) {
+			if (H5Zfilter_avail(H5Z_FILTER_LZ4) <= 0)
+				throw Exc("HDF: LZ4 filter is not available");
+			cd[1] = H5Z_BSHUF_COMPRESS_LZ4;
+		} else if (zstd >= 0) {
+			if (H5Zfilter_avail(H5Z_FILTER_ZSTD) <= 0)
+				throw Exc("HDF: Zstandard filter is not available");
+			cd[1] = H5Z_BSHUF_COMPRESS_ZSTD;
+			cd[2] = (unsigned)min(zstd, 22);
+		}
+		if (H5Pset_filter(dcpl, H5Z_FILTER_BITSHUFFLE, H5Z_FLAG_OPTIONAL, H5Z_BSHUF_USER_NPARMS, cd) < 0)
+			throw Exc("HDF: Error setting bitshuffle filter");
+	} else if (shuffle && H5Pset_shuffle(dcpl) < 0)
+		throw Exc("HDF: Error setting shuffle filter");
+	if (deflate >= 0) {
+		if (H5Zfilter_avail(H5Z_FILTER_DEFLATE) <= 0)
+			throw Exc("HDF: Deflate filter is not available");
+		if (H5Pset_deflate(dcpl, (unsigned)min(deflate, 9)) < 0)
+			throw Exc("HDF: Error setting deflate filter");
+	}
+	if (lz4 && !bitshuffle) {
+		if (H5Zfilter_avail(H5Z_FILTER_LZ4) <= 0)
+			throw Exc("HDF: LZ4 filter is not available");
+		if (H5Pset_filter(dcpl, H5Z_FILTER_LZ4, H5Z_FLAG_OPTIONAL, 0, NULL) < 0)
+			throw Exc("HDF: Error setting LZ4 filter");
+	}
+	if (zstd >= 0 && !bitshuffle) {
+		if (H5Zfilter_avail(H5Z_FILTER_ZSTD) <= 0)
+			throw Exc("HDF: Zstandard filter is not available");
+		unsigned level = (unsigned)min(zstd, 22);
+		if (H5Pset_filter(dcpl, H5Z_FILTER_ZSTD, H5Z_FLAG_OPTIONAL, 1, &level) < 0)
+			throw Exc("HDF: Error setting Zstandard filter");
+	}
+	if (fletcher32 && H5Pset_fletcher32(dcpl) < 0)
+		throw Exc("HDF: Error setting Fletcher32 filter");
+	
+	return dcpl.Detach();
+}
+
+// Whether the filters of a new dataset would be the ones of a dataset already created.
+// Creating a dataset adds its own values to the ones of the filters: before them with
+// bitshuffle (version and element size), after them with the others
+static bool SameFilters0(hid_t dcpl, hid_t odcpl) {
+	int nfilters = H5Pget_nfilters(dcpl);
+	if (nfilters < 0 || nfilters != H5Pget_nfilters(odcpl))
+		return false;
+	for (int i = 0; i < nfilters; ++i) {
+		unsigned flags, oflags, cd[32], ocd[32];
+		size_t ncd = 32, oncd = 32;
+		H5Z_filter_t filter = H5Pget_filter2(dcpl, (unsigned)i, &flags, &ncd, cd, 0, NULL, NULL);
+		if (filter < 0 || filter != H5Pget_filter2(odcpl, (unsigned)i, &oflags, &oncd, ocd, 0, NULL, NULL))
+			return false;
+		size_t local = filter == H5Z_FILTER_BITSHUFFLE ? 3 : 0;
+		if (flags != oflags || ncd > 32 || oncd > 32 || local + ncd > oncd)
+			return false;
+		for (size_t j = 0; j < ncd; ++j)
+			if (cd[j] != ocd[local + j])
+				return false;
+	}
+	return true;
+}
+
+// Opens the existing dataset in dts_id if the new data fits in it, as deleting a dataset does not free 
+// its file space. It has to have the same type, rank, dimensions and storage, or be extendable
+bool Hdf5File::ReuseDataset0(String name, hid_t type, int rank, const hsize_t *dims, const Hdf5Storage *storage) {
+	HidD ds = H5Dopen2(Last(group_ids), ~name, GetDapl0());
+	if (ds < 0)
+		return false;
+	
+	HidT dtype = H5Dget_type(ds);
+	H5T_class_t clss = H5Tget_class(type);
+	if (H5Tget_class(dtype) != clss || H5Tget_size(dtype) != H5Tget_size(type))
+		return false;
+	if (clss == H5T_INTEGER && H5Tget_sign(dtype) != H5Tget_sign(type))
+		return false;
+	if (clss == H5T_STRING && H5Tis_variable_str(dtype) != H5Tis_variable_str(type))
+		return false;
+	
+	HidS space = H5Dget_space(ds);
+	if (H5Sget_simple_extent_type(space) != H5S_SIMPLE || H5Sget_simple_extent_ndims(space) != rank)
+		return false;
+	Buffer<hsize_t> odims(rank), omaxdims(rank);
+	H5Sget_simple_extent_dims(space, odims, omaxdims);
+	bool samedims = true, extendable = false;
+	for (int i = 0; i < rank; ++i) {
+		if (omaxdims[i] != H5S_UNLIMITED && dims[i] > omaxdims[i])
+			return false;
+		samedims = samedims && odims[i] == dims[i];
+		extendable = extendable || omaxdims[i] == H5S_UNLIMITED;
+	}
+	
+	if (IsColMajor0(ds) != (storage && storage->IsColMajor() && rank > 1))
+		return false;
+	
+	HidP odcpl = H5Dget_create_plist(ds);
+	bool ochunked = H5Pget_layout(odcpl) == H5D_CHUNKED;
+	if (!samedims && !ochunked)
+		return false;
+	
+	// Layout, chunks and filters have to be the requested ones, as if it were created again
+	hid_t id = H5P_DEFAULT;
+	if (storage)
+		id = storage->GetDcpl(rank, dims, clss, H5Tget_size(type), extendable ? (const hsize_t *)omaxdims : NULL);
+	if (id == H5P_DEFAULT) {
+		if (H5Pget_layout(odcpl) != H5D_CONTIGUOUS || H5Pget_nfilters(odcpl) != 0)
+			return false;
+	} else {
+		HidP dcpl = id;
+		if (!ochunked || !SameFilters0(dcpl, odcpl))
+			return false;
+		Buffer<hsize_t> cdims(rank), ocdims(rank);
+		if (H5Pget_chunk(dcpl, rank, cdims) != rank || H5Pget_chunk(odcpl, rank, ocdims) != rank)
+			return false;
+		for (int i = 0; i < rank; ++i)
+			if (cdims[i] != ocdims[i])
+				return false;
+	}
+	
+	if (!samedims && H5Dset_extent(ds, dims) < 0)
+		return false;
+	
+	dts_id = ds.Detach();
+	return true;
+}
+
+void Hdf5File::CreateDataset0(String name, hid_t type, int rank, const hsize_t *dims, const Hdf5Storage *storage, const hsize_t *maxdims) {
+	InvalidateCache0(name);
+	DiscardAppend0(name);
+	if (ExistDataset(name)) {
+		if (!maxdims && ReuseDataset0(name, type, rank, dims, storage))
+			return;
 		Delete(name);
+	}
 	
-	hsize_t dims[1] = {1};
-    HidS dataspace_id = H5Screate_simple(1, dims, NULL);
+    HidS dataspace_id = H5Screate_simple(rank, dims, maxdims);
     if (dataspace_id < 0) 
         throw Exc("HDF: Error creating dataspace");
     
-    if ((dts_id = H5Dcreate2(Last(group_ids), name, H5T_NATIVE_INT, dataspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+    HidP dcpl;
+    if (storage) {
+        hid_t id = storage->GetDcpl(rank, dims, H5Tget_class(type), H5Tget_size(type), maxdims);
+        if (id != H5P_DEFAULT)
+            dcpl = id;
+    }
+    
+    if ((dts_id = H5Dcreate2(Last(group_ids), name, type, dataspace_id, H5P_DEFAULT, dcpl >= 0 ? (hid_t)dcpl : H5P_DEFAULT, H5P_DEFAULT)) < 0)
         throw Exc("HDF: Error creating dataset");
+    
+    IndexName0(name, H5O_TYPE_DATASET);
+}
+
+Hdf5File &Hdf5File::Set(String name, int d) {
+	if (IsAsync0()) {
+		Async0([this, name, d] {Set(name, d);}, sizeof(d));
+		return *this;
+	}
+	hsize_t dims[1] = {1};
+	CreateDataset0(name, H5T_NATIVE_INT, 1, dims, NULL);
 
     if (H5Dwrite(dts_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &d) < 0) 
         throw Exc("HDF: Error writing data to dataset");
@@ -441,16 +1738,12 @@ Hdf5File &Hdf5File::Set(String name, int d) {
 }
 
 Hdf5File &Hdf5File::Set(String name, double d) {
-	if (ExistDataset(name))
-		Delete(name);
-		
+	if (IsAsync0()) {
+		Async0([this, name, d] {Set(name, d);}, sizeof(d));
+		return *this;
+	}
 	hsize_t dims[1] = {1};
-    HidS dataspace_id = H5Screate_simple(1, dims, NULL);
-    if (dataspace_id < 0) 
-        throw Exc("HDF: Error creating dataspace");
-    
-    if ((dts_id = H5Dcreate2(Last(group_ids), name, H5T_NATIVE_DOUBLE, dataspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
-        throw Exc("HDF: Error creating dataset");
+	CreateDataset0(name, H5T_NATIVE_DOUBLE, 1, dims, NULL);
 
     if (H5Dwrite(dts_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, &d) < 0) 
         throw Exc("HDF: Error writing data to dataset");
@@ -459,19 +1752,17 @@ Hdf5File &Hdf5File::Set(String name, double d) {
 }
 
 Hdf5File &Hdf5File::Set(String name, const char *d) {
-	if (ExistDataset(name))
-		Delete(name);
-		
-    hid_t datatype_id = H5Tcopy(H5T_C_S1);
+	if (IsAsync0()) {
+		String str = d;
+		Async0([this, name, str] {Set(name, ~str);}, str.GetCount());
+		return *this;
+	}
+	
+    HidT datatype_id = H5Tcopy(H5T_C_S1);
     H5Tset_size(datatype_id, H5T_VARIABLE);
     
 	hsize_t dims[1] = {1};
-    HidS dataspace_id = H5Screate_simple(1, dims, NULL);
-    if (dataspace_id < 0) 
-        throw Exc("HDF: Error creating dataspace");
-    
-    if ((dts_id = H5Dcreate2(Last(group_ids), name, datatype_id, dataspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
-        throw Exc("HDF: Error creating dataset");
+	CreateDataset0(name, datatype_id, 1, dims, NULL);
 
     if (H5Dwrite(dts_id, datatype_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, &d) < 0) 
         throw Exc("HDF: Error writing data to dataset");
@@ -479,88 +1770,445 @@ Hdf5File &Hdf5File::Set(String name, const char *d) {
     return *this;
 }
 
-Hdf5File &Hdf5File::Set(String name, const Eigen::VectorXd &d) {
-	if (ExistDataset(name))
-		Delete(name);
-		
+Hdf5File &Hdf5File::Set(String name, const Eigen::VectorXd &d, const Hdf5Storage &storage) {
+	if (IsAsync0()) {
+		Async0([this, name, d, storage] {Set(name, d, storage);}, d.size()*sizeof(double));
+		return *this;
+	}
 	hsize_t dims[1];
 	dims[0] = (hsize_t)d.size();
-    HidS dataspace_id = H5Screate_simple(1, dims, NULL);
-    if (dataspace_id < 0) 
-        throw Exc("HDF: Error creating dataspace");
-    
-    if ((dts_id = H5Dcreate2(Last(group_ids), name, H5T_NATIVE_DOUBLE, dataspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
-        throw Exc("HDF: Error creating dataset");
+	CreateDataset0(name, H5T_NATIVE_DOUBLE, 1, dims, &storage);
 
-    if (H5Dwrite(dts_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, d.data()) < 0) 
-        throw Exc("HDF: Error writing data to dataset");
+    WriteDouble0(d.data());
     
     return *this;
 }
 
-Hdf5File &Hdf5File::Set(String name, const Vector<double> &d) {
-	if (ExistDataset(name))
-		Delete(name);
-		
+Hdf5File &Hdf5File::Set(String name, const Vector<double> &d, const Hdf5Storage &storage) {
+	if (IsAsync0()) {
+		Eigen::VectorXd v = Eigen::Map<const Eigen::VectorXd>(d.begin(), d.size());
+		Async0([this, name, v, storage] {Set(name, v, storage);}, v.size()*sizeof(double));
+		return *this;
+	}
 	hsize_t dims[1];
 	dims[0] = (hsize_t)d.size();
-    HidS dataspace_id = H5Screate_simple(1, dims, NULL);
-    if (dataspace_id < 0) 
-        throw Exc("HDF: Error creating dataspace");
-    
-    if ((dts_id = H5Dcreate2(Last(group_ids), name, H5T_NATIVE_DOUBLE, dataspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
-        throw Exc("HDF: Error creating dataset");
+	CreateDataset0(name, H5T_NATIVE_DOUBLE, 1, dims, &storage);
 
-    if (H5Dwrite(dts_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, d.begin()) < 0) 
-        throw Exc("HDF: Error writing data to dataset");
+    WriteDouble0(d.begin());
     
     return *this;
 }
 
-Hdf5File &Hdf5File::Set(String name, const Eigen::MatrixXd &data) {
-	if (ExistDataset(name))
-		Delete(name);
-		
+Hdf5File &Hdf5File::Set(String name, const Eigen::MatrixXd &data, const Hdf5Storage &storage) {
+	if (IsAsync0()) {
+		Async0([this, name, data, storage] {Set(name, data, storage);}, data.size()*sizeof(double));
+		return *this;
+	}
+	bool colmajor = storage.IsColMajor();
 	hsize_t dims[2];
-	dims[0] = (hsize_t)data.rows();
-	dims[1] = (hsize_t)data.cols();
-    HidS dataspace_id = H5Screate_simple(2, dims, NULL);
-	if (dataspace_id < 0) 
-        throw Exc("HDF: Error creating dataspace");
-    
-	if ((dts_id = H5Dcreate2(Last(group_ids), name, H5T_NATIVE_DOUBLE, dataspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
-        throw Exc("HDF: Error creating dataset");
+	dims[colmajor ? 1 : 0] = (hsize_t)data.rows();
+	dims[colmajor ? 0 : 1] = (hsize_t)data.cols();
+	CreateDataset0(name, H5T_NATIVE_DOUBLE, 2, dims, &storage);
 	
-	Vector<double> d;
-	CopyRowMajor(data, d);
-
-    if (H5Dwrite(dts_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, d.begin()) < 0) 
-        throw Exc("HDF: Error writing data to dataset");
-    
+	if (colmajor) {
+		SetAttributes0(dts_id, "layout", "col_major");
+		WriteDouble0(data.data());
+	} else {
+		Buffer<double> d((size_t)data.size());
+		ColMajorToRowMajor0(data.data(), d.Get(), Vector<int>{int(data.rows()), int(data.cols())});
+	    WriteDouble0(d.Get());
+	}
     return *this;
 }
 
-Hdf5File &Hdf5File::Set(String name, const MultiDimMatrixRowMajor<double> &d) {
-	if (ExistDataset(name))
-		Delete(name);
-		
-	Buffer<hsize_t> dims((hsize_t)d.GetNumAxis());
-	for (int i = 0; i < d.GetNumAxis(); ++i)
-		dims[i] = (hsize_t)d.size(i);
-    HidS dataspace_id = H5Screate_simple(d.GetNumAxis(), dims, NULL);
-    if (dataspace_id < 0) 
-        throw Exc("HDF: Error creating dataspace");
-    
-    if ((dts_id = H5Dcreate2(Last(group_ids), name, H5T_NATIVE_DOUBLE, dataspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
-        throw Exc("HDF: Error creating dataset");
+Hdf5File &Hdf5File::Set(String name, const MultiDimMatrixRowMajor<double> &d, const Hdf5Storage &storage) {
+	Vector<int> dims(d.GetNumAxis());
+	size_t sz = 1;
+	for (int i = 0; i < dims.size(); ++i)
+		sz *= (size_t)(dims[i] = d.size(i));
 	
-    if (H5Dwrite(dts_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, d.begin()) < 0) 
-        throw Exc("HDF: Error writing data to dataset");
-    
-    return *this;
+	if (IsAsync0()) {
+		Buffer<double> data(sz);
+		memcpy(~data, d.begin(), sz*sizeof(double));
+		Async0([this, name, data = pick(data), dims = pick(dims), storage] {SetRowMajor0(name, ~data, dims, storage);}, 
+			   sz*sizeof(double));
+		return *this;
+	}
+	SetRowMajor0(name, d.begin(), dims, storage);
+	return *this;
+}
+
+void Hdf5File::SetRowMajor0(String name, const double *d, const Vector<int> &dims, const Hdf5Storage &storage) {
+	Buffer<hsize_t> hdims(dims.size());
+	for (int i = 0; i < dims.size(); ++i)
+		hdims[i] = (hsize_t)dims[i];
+	CreateDataset0(name, H5T_NATIVE_DOUBLE, dims.size(), hdims, &storage);
+	
+    WriteDouble0(d);
+}
+
+void Hdf5File::WriteDouble0(const double *data) {
+	if (parallel_encode && WriteChunks0(data))
+		return;
+	if (H5Dwrite(dts_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0) 
+		throw Exc("HDF: Error writing data to dataset");
+}
+
+// Splits the data of the whole dataset in chunks, encodes them in parallel and writes them in order.
+// Returns false if the dataset is not supported, so that H5Dwrite() is used
+bool Hdf5File::WriteChunks0(const double *data) {
+	HidT type = H5Dget_type(dts_id);
+	if (type < 0 || H5Tequal(type, H5T_NATIVE_DOUBLE) <= 0)
+		return false;
+	HidP dcpl = H5Dget_create_plist(dts_id);
+	if (dcpl < 0 || H5Pget_layout(dcpl) != H5D_CHUNKED)
+		return false;
+	Vector<ChunkFilter0> filters;
+	if (!GetChunkFilters0(dcpl, filters))
+		return false;
+	HidS space = H5Dget_space(dts_id);
+	int rank = H5Sget_simple_extent_ndims(space);
+	if (rank <= 0)
+		return false;
+	Buffer<hsize_t> dims(rank), chunk(rank);
+	if (H5Sget_simple_extent_dims(space, dims, NULL) < 0 || H5Pget_chunk(dcpl, rank, chunk) != rank)
+		return false;
+	
+	Vector<int64> nchunks(rank), dstride(rank), cstride(rank);
+	int64 total = 1;
+	size_t chunksz = 1;
+	for (int i = rank-1; i >= 0; --i) {
+		nchunks[i] = ((int64)dims[i] + (int64)chunk[i] - 1)/(int64)chunk[i];
+		dstride[i] = i == rank-1 ? 1 : dstride[i+1]*(int64)dims[i+1];
+		cstride[i] = i == rank-1 ? 1 : cstride[i+1]*(int64)chunk[i+1];
+		total *= nchunks[i];
+		chunksz *= (size_t)chunk[i];
+	}
+	if (total < 2)
+		return false;
+	
+	double fill = 0;
+	H5Pget_fill_value(dcpl, H5T_NATIVE_DOUBLE, &fill);
+	
+	struct Encoded0 {
+		Buffer<hsize_t> offset;
+		Buffer<byte> buf;
+		size_t len;
+	};
+	int64 batch = 4*max(CPU_Cores(), 1);
+	Array<Encoded0> pending;		// Encoded, to be written
+	for (int64 first = 0; first < total || !pending.IsEmpty(); first += batch) {
+		Array<Encoded0> next;
+		CoWork co;
+		for (int64 c = first; c < min(first + batch, total); ++c) {
+			Encoded0 *pe = &next.Add();
+			co & [=, &filters, &nchunks, &dstride, &cstride, &dims, &chunk] {
+				Encoded0 &e = *pe;
+				e.offset.Alloc(rank);
+				Vector<int64> extent(rank);
+				bool edge = false;
+				int64 r = c;
+				for (int i = rank-1; i >= 0; --i) {
+					e.offset[i] = (hsize_t)(r % nchunks[i])*chunk[i];
+					extent[i] = min((int64)chunk[i], (int64)(dims[i] - e.offset[i]));
+					edge = edge || extent[i] < (int64)chunk[i];
+					r /= nchunks[i];
+				}
+				e.len = chunksz*sizeof(double);
+				e.buf.Alloc(e.len);
+				double *dst = (double *)~e.buf;
+				if (edge)			// Past the dataset end
+					std::fill(dst, dst + chunksz, fill);
+				Vector<int64> idx(rank-1, 0);
+				for (;;) {			// Copies the rows
+					int64 srcbase = (int64)e.offset[rank-1], dstbase = 0;
+					for (int i = 0; i < rank-1; ++i) {
+						srcbase += ((int64)e.offset[i] + idx[i])*dstride[i];
+						dstbase += idx[i]*cstride[i];
+					}
+					memcpy(dst + dstbase, data + srcbase, extent[rank-1]*sizeof(double));
+					int i = rank-2;
+					for (; i >= 0 && ++idx[i] == extent[i]; --i)
+						idx[i] = 0;
+					if (i < 0)
+						break;
+				}
+				EncodeChunk0(filters, e.buf, e.len);
+			};
+		}
+		for (int i = 0; i < pending.size(); ++i)	// Written while the next ones are encoded
+			if (H5Dwrite_chunk(dts_id, H5P_DEFAULT, 0, pending[i].offset, pending[i].len, ~pending[i].buf) < 0)
+				throw Exc("HDF: Error writing chunk");
+		co.Finish();
+		pending = pick(next);
+	}
+	return true;
+}
+
+Hdf5File &Hdf5File::ParallelDecode(bool set) {
+	Sync0();
+	
+	parallel_decode = set;
+	return *this;
+}
+
+Hdf5File &Hdf5File::ParallelEncode(bool set) {
+	Sync0();		// The background writes use it
+	
+	parallel_encode = set;
+	return *this;
+}
+
+Hdf5File &Hdf5File::SetStorage(const Hdf5Storage &_storage) {
+	Sync0();
+	
+	storage = _storage;
+	return *this;
+}
+
+bool Hdf5File::IsAsync0() const {
+	return async && Thread::GetCurrentId() != async_thread.GetId();
+}
+
+Hdf5File &Hdf5File::Async(bool set, int64 maxbytes) {
+	if (!set) {
+		String error = StopAsync0();
+		if (!IsNull(error))
+			throw Exc(error);
+		return *this;
+	}
+	if (!IsOpened())
+		throw Exc("HDF: File has to be opened before writing in background");
+#ifndef H5_HAVE_THREADSAFE
+	throw Exc("HDF: Writing in background needs the library built thread-safe");
+#endif
+	async_maxbytes = maxbytes;
+	if (async)
+		return *this;
+	
+	async = true;
+	async_stop = false;
+	async_thread.Run([this] {AsyncRun0();});
+	return *this;
+}
+
+void Hdf5File::AsyncRun0() {
+	for (;;) {
+		Function<void ()> *run;
+		{
+			Mutex::Lock __(async_mutex);
+			while (async_jobs.IsEmpty() && !async_stop)
+				async_job.Wait(async_mutex);
+			if (async_jobs.IsEmpty())
+				return;
+			run = &async_jobs[0].run;		// Array elements do not move when others are added
+		}
+		String error;
+		try {
+			(*run)();
+		} catch (Exc e) {
+			error = e;
+		} catch (...) {
+			error = "HDF: Unknown error writing in background";
+		}
+		Mutex::Lock __(async_mutex);
+		if (IsNull(error)) {
+			async_bytes -= async_jobs[0].bytes;
+			async_jobs.Remove(0);
+		} else {				// The next writes are discarded, as they may depend on the failed one
+			if (IsNull(async_error))
+				async_error = error;
+			async_jobs.Clear();
+			async_bytes = 0;
+		}
+		async_done.Broadcast();
+	}
+}
+
+// Queues a write. It waits if the queue is full
+void Hdf5File::Async0(Function<void ()> run, int64 bytes) {
+	Mutex::Lock __(async_mutex);
+	while (!async_jobs.IsEmpty() && async_bytes + bytes > async_maxbytes && IsNull(async_error))
+		async_done.Wait(async_mutex);
+	if (!IsNull(async_error)) {
+		String error = async_error;
+		async_error.Clear();
+		throw Exc(error);
+	}
+	AsyncJob0 &job = async_jobs.Add();
+	job.run = pick(run);
+	job.bytes = bytes;
+	async_bytes += bytes;
+	async_job.Signal();
+}
+
+// Waits for the queued writes. Their errors are thrown here
+void Hdf5File::Sync0() {
+	if (!IsAsync0())
+		return;
+	Mutex::Lock __(async_mutex);
+	while (!async_jobs.IsEmpty())
+		async_done.Wait(async_mutex);
+	if (!IsNull(async_error)) {
+		String error = async_error;
+		async_error.Clear();
+		throw Exc(error);
+	}
+}
+
+// Ends the background thread after the queued writes. Returns their error, if any
+String Hdf5File::StopAsync0() {
+	if (!async)
+		return Null;
+	{
+		Mutex::Lock __(async_mutex);
+		async_stop = true;
+		async_job.Signal();
+	}
+	async_thread.Wait();
+	async = false;
+	String error = async_error;
+	async_error.Clear();
+	return error;
+}
+
+Hdf5File::Append0 &Hdf5File::GetAppend0(String name, int ncols) {
+	Sync0();
+	
+	String key = GetDatasetKey0(name);
+	int id = appends.Find(key);
+	if (id >= 0) {
+		Append0 &a = appends[id];
+		if (a.ncols != ncols)
+			throw Exc(F("HDF: Appended data to '%s' has %d columns instead of %d", name, ncols, a.ncols));
+		return a;
+	}
+	
+	int rank = ncols > 0 ? 2 : 1;
+	hsize_t cdims[2];
+	if (ExistDataset(name)) {		// Appends to a dataset from a previous session
+		const Dataset0 &ds = GetData0(name);
+		hsize_t maxdims[2];
+		if (ds.clss != H5T_FLOAT || ds.dims.size() != rank || ds.colmajor)
+			throw Exc(F("HDF: Dataset '%s' cannot be appended", name));
+		H5Sget_simple_extent_dims(ds.space, NULL, maxdims);
+		if (maxdims[0] != H5S_UNLIMITED)
+			throw Exc(F("HDF: Dataset '%s' is not extendable", name));
+		if (rank == 2 && ds.dims[1] != ncols)
+			throw Exc(F("HDF: Appended data to '%s' has %d columns instead of %d", name, ncols, ds.dims[1]));
+		HidP dcpl = H5Dget_create_plist(ds.id);
+		if (H5Pget_chunk(dcpl, rank, cdims) < 0)
+			throw Exc(F("HDF: Impossible to get the chunk of '%s'", name));
+	} else {
+		hsize_t dims[2] = {0, (hsize_t)ncols}, maxdims[2] = {H5S_UNLIMITED, (hsize_t)ncols};
+		Hdf5Storage rowstorage = storage;
+		CreateDataset0(name, H5T_NATIVE_DOUBLE, rank, dims, &rowstorage.ColMajor(false), maxdims);
+		HidP dcpl = H5Dget_create_plist(dts_id);
+		if (H5Pget_chunk(dcpl, rank, cdims) < 0)
+			throw Exc(F("HDF: Impossible to get the chunk of '%s'", name));
+	}
+	Append0 &a = appends.Add(key);
+	a.ncols = ncols;
+	a.chunkrows = (int)cdims[0];
+	return a;
+}
+
+void Hdf5File::Append0::Add(const double *d, int nrows) {
+	int n = nrows*max(ncols, 1), n0 = data.size();
+	data.SetCount(n0 + n);
+	memcpy(data.begin() + n0, d, n*sizeof(double));
+	this->nrows += nrows;
+}
+
+// Writes the buffered rows. If not all, only whole chunks are written 
+void Hdf5File::FlushAppend0(String key, Append0 &a, bool all) {
+	int nrows = all ? a.nrows : a.nrows - a.nrows % a.chunkrows;
+	if (nrows == 0)
+		return;
+	
+	InvalidateCache0(key);		// Its dimensions change
+	
+	int rank = a.ncols > 0 ? 2 : 1;
+	hsize_t dims[2], start[2] = {0, 0}, count[2] = {(hsize_t)nrows, (hsize_t)a.ncols};
+	
+	HidD ds = H5Dopen2(file_id, ~key, GetDapl0());
+	if (ds < 0)
+		throw Exc(F("HDF: Impossible to open dataset '%s'", key));
+	HidS space = H5Dget_space(ds);
+	H5Sget_simple_extent_dims(space, dims, NULL);
+	start[0] = dims[0];
+	dims[0] += nrows;
+	if (H5Dset_extent(ds, dims) < 0)
+		throw Exc(F("HDF: Impossible to extend dataset '%s'", key));
+	
+	space = H5Dget_space(ds);
+	if (H5Sselect_hyperslab(space, H5S_SELECT_SET, start, NULL, count, NULL) < 0)
+		throw Exc("HDF: Error selecting hyperslab");
+	HidS memspace = H5Screate_simple(rank, count, NULL);
+	if (H5Dwrite(ds, H5T_NATIVE_DOUBLE, memspace, space, H5P_DEFAULT, a.data.begin()) < 0)
+		throw Exc("HDF: Error writing data to dataset");
+	
+	a.data.Remove(0, nrows*max(a.ncols, 1));
+	a.nrows -= nrows;
+}
+
+// Pending appends are lost when the dataset is replaced or deleted
+void Hdf5File::DiscardAppend0(String name) {
+	String key = GetDatasetKey0(name);
+	String group = key + "/";
+	for (int i = appends.GetCount()-1; i >= 0; --i) {
+		const String &k = appends.GetKey(i);
+		if (k == key || k.StartsWith(group))
+			appends.Remove(i);
+	}
+}
+
+void Hdf5File::Append(String name, double d) {
+	Append0 &a = GetAppend0(name, 0);
+	a.Add(&d, 1);
+	FlushAppend0(GetDatasetKey0(name), a, false);
+}
+
+void Hdf5File::Append(String name, const Eigen::VectorXd &row) {
+	if (row.size() == 0)		// It would be taken as a series of numbers
+		throw Exc(F("HDF: Empty row appended to '%s'", name));
+	Append0 &a = GetAppend0(name, int(row.size()));
+	a.Add(row.data(), 1);
+	FlushAppend0(GetDatasetKey0(name), a, false);
+}
+
+void Hdf5File::Append(String name, const Vector<double> &row) {
+	if (row.IsEmpty())
+		throw Exc(F("HDF: Empty row appended to '%s'", name));
+	Append0 &a = GetAppend0(name, row.size());
+	a.Add(row.begin(), 1);
+	FlushAppend0(GetDatasetKey0(name), a, false);
+}
+
+void Hdf5File::Append(String name, const Eigen::MatrixXd &rows) {
+	if (rows.rows() == 0)
+		return;
+	if (rows.cols() == 0)
+		throw Exc(F("HDF: Empty rows appended to '%s'", name));
+	Append0 &a = GetAppend0(name, int(rows.cols()));
+	Buffer<double> d((size_t)rows.size());
+	ColMajorToRowMajor0(rows.data(), d.Get(), Vector<int>{int(rows.rows()), int(rows.cols())});
+	a.Add(d.Get(), int(rows.rows()));
+	FlushAppend0(GetDatasetKey0(name), a, false);
+}
+
+void Hdf5File::Flush() {
+	Sync0();
+	
+	for (int i = 0; i < appends.GetCount(); ++i)
+		FlushAppend0(appends.GetKey(i), appends[i], true);
+	if (file_id >= 0 && H5Fflush(file_id, H5F_SCOPE_GLOBAL) < 0)
+		throw Exc("HDF: Error flushing file");
 }
 
 String Hdf5File::GetLastError() {
+	Sync0();
+	
 	String str;
 
 	auto WalkCallback = [](unsigned /*n*/, const H5E_error2_t *err_desc, void *client_data) {
@@ -574,5 +2222,11 @@ String Hdf5File::GetLastError() {
     return str;
 }
 
+void Hdf5File::SurpressErrorMsgs() {
+	Sync0();
+	
+	ErrorsOffLock0 __;
+	H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+}
 
 }
\ No newline at end of file
@@ -17,6 +17,7 @@ public:
 	Hid(hid_t _id) : id(_id) {};
 	virtual void Close() = 0;
 	operator hid_t() const   {return id;};
+	hid_t Detach()			 {hid_t ret = id; id = -1; return ret;}
 	
 protected:
 	hid_t id = -1;	
@@ -79,16 +80,95 @@ public:
     }
 };
 
+class HidT : public Hid {
+public:
+	HidT() {}
+	HidT(hid_t _id) : Hid(_id) {};
+	~HidT() 			 {Close();}
+	
+	void Close() {
+        if (id >= 0)
+            H5Tclose(id);
+        id = -1;
+    }
+	
+	HidT& operator=(hid_t newId) {
+        Close();
+        id = newId;
+        return *this;
+    }
+};
+
+class HidP : public Hid {
+public:
+	HidP() {}
+	HidP(hid_t _id) : Hid(_id) {};
+	~HidP() 			 {Close();}
+	
+	void Close() {
+        if (id >= 0)
+            H5Pclose(id);
+        id = -1;
+    }
+	
+	HidP& operator=(hid_t newId) {
+        Close();
+        id = newId;
+        return *this;
+    }
+};
+
+// Dataset creation options: chunking and filters
+class Hdf5Storage {
+public:
+	Hdf5Storage() {}
+	Hdf5Storage(const Hdf5Storage &s)		{*this = s;}
+	Hdf5Storage &operator=(const Hdf5Storage &s);
+	
+	Hdf5Storage &Contiguous();
+	Hdf5Storage &Chunk(const Vector<int> &_chunk);			// Chunk shape. Clipped to the dataset dimensions
+	Hdf5Storage &AutoChunk(bool set = true)		{autochunk = set;	return *this;}
+	Hdf5Storage &Shuffle(bool set = true)		{shuffle = set;		return *this;}
+	Hdf5Storage &BitShuffle(bool set = true)	{bitshuffle = set;	return *this;}	// Instead of Shuffle(). Compresses with LZ4() or Zstd() itself, like h5py
+	Hdf5Storage &Deflate(int level = 6)			{deflate = level;	return *this;}	// 0 to 9. -1 disables it
+	Hdf5Storage &LZ4(bool set = true)			{lz4 = set;			return *this;}	// Faster than deflate, with less ratio. Needs the LZ4 flag outside Windows
+	Hdf5Storage &Zstd(int level = 3)			{zstd = level;		return *this;}	// 1 to 22, 0 is the default level. -1 disables it. Needs the ZSTD flag outside Windows
+	Hdf5Storage &Fletcher32(bool set = true)	{fletcher32 = set;	return *this;}
+	Hdf5Storage &ScaleOffset(int digits)		{scaleoffset = digits; return *this;}	// Decimal digits kept in floats (lossy). -1 disables it
+	Hdf5Storage &ColMajor(bool set = true)		{colmajor = set;	return *this;}	// Eigen matrices and tensors are written as is, with reversed dimensions
+	
+	bool IsColMajor() const						{return colmajor;}
+	
+	bool IsChunked() const;
+	hid_t GetDcpl(int rank, const hsize_t *dims, H5T_class_t clss, size_t typesize, const hsize_t *maxdims = NULL) const;
+	
+	static void GuessChunk(int rank, const hsize_t *dims, size_t typesize, hsize_t *chunk);
+	
+private:
+	Vector<int> chunk;
+	bool autochunk = false;
+	bool shuffle = false;
+	bool bitshuffle = false;
+	int deflate = -1;
+	bool lz4 = false;
+	int zstd = -1;
+	bool fletcher32 = false;
+	int scaleoffset = -1;
+	bool colmajor = false;
+};
+
 class Hdf5File {
 public:
 	Hdf5File()				{}
 	Hdf5File(String file)	{Open(file);}
-	~Hdf5File()				{Close();}
+	~Hdf5File()				{Close0();}
 	
 	void Create(String file);		
 	void Open(String file, unsigned mode = H5F_ACC_RDWR);
+	void OpenMapped(String file);			// Read-only, memory-mapped where available, so that Map() can be used
 	bool IsOpened();
-	void Close();
+	bool IsMapped() const					{return mapped != NULL;}
+	void Close();			// Throws the errors of background writes and pending appends. The destructor does not
 	
 	bool ChangeGroup(String group);
 	Vector<String> ListGroup(bool groups, bool datasets);
@@ -102,6 +182,27 @@ public:
 	bool ExistDataset(String name)		{return Exist(name, false);}
 	bool ExistGroup(String name)		{return Exist(name, true);}
 	
+	Hdf5File &IndexNames(bool set = true);	// Keeps in memory the names and types of the objects in the visited groups
+	
+	Hdf5File &SetCacheSize(int n);			// Maximum number of datasets kept open between reads. 0 disables the cache
+	int GetCacheSize() const				{return cache_size;}
+	int64 GetCacheHits() const				{return cache_hits;}
+	int64 GetCacheMisses() const			{return cache_misses;}
+	
+	// Chunk cache of each dataset opened from now on. 0 bytes goes back to the library default.
+	// Scan resistant keeps the chunks in repeated use when large selections are read once
+	Hdf5File &SetChunkCache(int64 bytes, int slots = 0, bool scanresistant = true);
+	H5D_chunk_cache_stats_t GetChunkCacheStats(String name);	// Counted since the dataset was opened
+	// Compressed datasets opened from now on read the next nchunks chunks at once into the chunk cache
+	// when their chunks are read in storage order. 0 disables it
+	Hdf5File &SetChunkPrefetch(int nchunks);
+	// Chunk addresses of each dataset opened from now on are read at once into memory, up to 48 bytes per
+	// written chunk, unless there are more than 2^20 of them. Only used with files opened with H5F_ACC_RDONLY
+	Hdf5File &SnapshotChunkIndex(bool set = true);
+	// Rebuilds the v1 B-tree chunk index of datasets from old files as a fixed or extensible array.
+	// Readers older than HDF5 1.10 cannot read it anymore. Returns false if there was nothing to do
+	bool OptimizeLayout(String name);
+	
 	bool Delete(String name);
 	
 	void GetType(String name, H5T_class_t &type, Vector<int> &dims);
@@ -122,79 +223,302 @@ public:
 	void GetDouble(String name, MultiDimMatrixRowMajor<double> &d);
 	template <int Rank>
 	void GetDouble(String name, Eigen::Tensor<double, Rank> &data) {
-		int sz;
-		HidO obj_id;
-		hid_t datatype_id, dspace;
-		Vector<int> dims;
-		GetData0(name, obj_id, datatype_id, dspace, sz, dims);
+		const Dataset0 &ds = GetData0(name);
 	
-		if (dims.size() != Rank)
-			throw Exc(F("Dimension different than %d", Rank));
+		if (ds.dims.size() != Rank)
+			throw Exc(F("HDF: Dimension different than %d", Rank));
 	
-		H5T_class_t clss = H5Tget_class(datatype_id);
-		if (clss != H5T_FLOAT)
-			throw Exc("Dataset is not double");
+		if (ds.clss != H5T_FLOAT)
+			throw Exc("HDF: Dataset is not double");
 		
-		Buffer<double> d_row(sz), d_col(sz);
-		if (H5Dread(obj_id, datatype_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, d_row.Get()) < 0) 
-			throw Exc("Impossible to read data");		
-
-		RowMajorToColMajor(~d_row, ~d_col, dims);
+		bool colmajor = ds.colmajor;
+		Vector<int> ldims = colmajor ? Reverse0(ds.dims) : clone(ds.dims);
 		
 		Eigen::array<Eigen::Index, Rank> dimensions;
 		for (int i = 0; i < Rank; ++i)
-			dimensions[i] = dims[i];
-
-		data = Eigen::TensorMap<Eigen::Tensor<double, Rank>>(~d_col, dimensions);
+			dimensions[i] = ldims[i];
+		data.resize(dimensions);
+		
+		if (colmajor) {
+			ReadDouble0(ds, H5S_ALL, H5S_ALL, data.data());
+		} else {
+			Buffer<double> d_row(ds.sz);
+			ReadDouble0(ds, H5S_ALL, H5S_ALL, d_row.Get());
+			RowMajorToColMajor0(~d_row, data.data(), ds.dims);
+		}
+	}
+	
+	// Partial reads. start, count, stride and block follow H5Sselect_hyperslab(), one value per dimension.
+	// stride and block default to 1. The selection is returned with dimensions count[i]*block[i]
+	// Column-major datasets take them in the order of the Eigen dimensions
+	void GetDouble(String name, const Vector<int> &start, const Vector<int> &count, Eigen::VectorXd &data, 
+				   const Vector<int> &stride = Vector<int>(), const Vector<int> &block = Vector<int>());
+	void GetDouble(String name, const Vector<int> &start, const Vector<int> &count, Vector<double> &data, 
+				   const Vector<int> &stride = Vector<int>(), const Vector<int> &block = Vector<int>());
+	void GetDouble(String name, const Vector<int> &start, const Vector<int> &count, Eigen::MatrixXd &data, 
+				   const Vector<int> &stride = Vector<int>(), const Vector<int> &block = Vector<int>());
+	void GetDouble(String name, const Vector<int> &start, const Vector<int> &count, MultiDimMatrixRowMajor<double> &data, 
+				   const Vector<int> &stride = Vector<int>(), const Vector<int> &block = Vector<int>());
+	template <int Rank>
+	void GetDouble(String name, const Vector<int> &start, const Vector<int> &count, Eigen::Tensor<double, Rank> &data, 
+				   const Vector<int> &stride = Vector<int>(), const Vector<int> &block = Vector<int>()) {
+		const Dataset0 &ds = GetData0(name);
+		HidS fspace = H5Scopy(ds.space);		// The selection is not kept in the cache
+	
+		if (ds.dims.size() != Rank)
+			throw Exc(F("HDF: Dimension different than %d", Rank));
+	
+		if (ds.clss != H5T_FLOAT)
+			throw Exc("HDF: Dataset is not double");
+		
+		bool colmajor = ds.colmajor;
+		HidS memspace;
+		Vector<int> seldims;
+		SelectHyperslab0(fspace, ds.dims, start, count, stride, block, colmajor, memspace, seldims);
+		
+		Eigen::array<Eigen::Index, Rank> dimensions;
+		size_t selsz = 1;
+		for (int i = 0; i < Rank; ++i)
+			selsz *= (size_t)(dimensions[i] = seldims[i]);
+		data.resize(dimensions);
+		
+		if (colmajor) {
+			ReadDouble0(ds, memspace, fspace, data.data());
+		} else {
+			Buffer<double> d_row(selsz);
+			ReadDouble0(ds, memspace, fspace, d_row.Get());
+			RowMajorToColMajor0(~d_row, data.data(), seldims);
+		}
 	}
 	
+	// Datasets in a file opened with OpenMapped() are used in place, without copies, if they are double, 
+	// of one or two dimensions and contiguous (no chunks or filters). The data is valid until Close()
+	typedef Eigen::Map<const Eigen::MatrixXd, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>> MapXd;
+	typedef Eigen::Map<const Eigen::VectorXd> MapVXd;
+	
+	bool CanMap(String name);
+	MapXd Map(String name);
+	MapVXd MapVector(String name);
+	
+	// List of datasets to be read together by GetMany()
+	class Batch {
+	public:
+		Batch &Get(String name, int &d);
+		Batch &Get(String name, double &d);
+		Batch &Get(String name, Eigen::VectorXd &data);
+		Batch &Get(String name, Vector<double> &data);
+		Batch &Get(String name, Eigen::MatrixXd &data);
+		Batch &Get(String name, MultiDimMatrixRowMajor<double> &d);
+		template <int Rank>
+		Batch &Get(String name, Eigen::Tensor<double, Rank> &data) {
+			Item &it = Add(name, H5T_FLOAT, H5T_NATIVE_DOUBLE);
+			it.Prepare = [&it, &data](const Vector<int> &dims, bool colmajor, int sz)->void * {
+				if (dims.size() != Rank)
+					throw Exc(F("HDF: Dimension different than %d", Rank));
+				Vector<int> ldims = colmajor ? Reverse0(dims) : clone(dims);
+				Eigen::array<Eigen::Index, Rank> dimensions;
+				for (int i = 0; i < Rank; ++i)
+					dimensions[i] = ldims[i];
+				data.resize(dimensions);
+				if (colmajor)
+					return data.data();
+				it.dims = clone(dims);
+				it.d_row.Alloc(sz);
+				it.Finish = [&it, &data] {RowMajorToColMajor0(~it.d_row, data.data(), it.dims);};
+				return ~it.d_row;
+			};
+			return *this;
+		}
+		
+		int GetCount() const	{return items.GetCount();}
+		void Clear()			{items.Clear();}
+		
+	private:
+		struct Item {
+			String name;
+			H5T_class_t clss;
+			hid_t memtype;
+			Function<void *(const Vector<int> &dims, bool colmajor, int sz)> Prepare;	// Sizes the destination and returns where to read
+			Function<void ()> Finish;													// Changes the layout if needed
+			Buffer<double> d_row;
+			Vector<int> dims;
+		};
+		Array<Item> items;
+		
+		Item &Add(String name, H5T_class_t clss, hid_t memtype);
+		
+		friend class Hdf5File;
+	};
+	
+	void GetMany(Batch &batch);		// Reads all the datasets in batch with a single H5Dread_multi()
+	
 	Hdf5File &Set(String name, int d);
 	Hdf5File &Set(String name, double d);
 	Hdf5File &Set(String name, const char *d);
-	Hdf5File &Set(String name, const Eigen::VectorXd &d);
-	Hdf5File &Set(String name, const Vector<double> &d);
-	Hdf5File &Set(String name, const Eigen::MatrixXd &d);
-	Hdf5File &Set(String name, const MultiDimMatrixRowMajor<double> &d);
+	Hdf5File &Set(String name, const Eigen::VectorXd &d)					{return Set(name, d, storage);}
+	Hdf5File &Set(String name, const Vector<double> &d)					{return Set(name, d, storage);}
+	Hdf5File &Set(String name, const Eigen::MatrixXd &d)					{return Set(name, d, storage);}
+	Hdf5File &Set(String name, const MultiDimMatrixRowMajor<double> &d)	{return Set(name, d, storage);}
+	Hdf5File &Set(String name, const Eigen::VectorXd &d, const Hdf5Storage &storage);
+	Hdf5File &Set(String name, const Vector<double> &d, const Hdf5Storage &storage);
+	Hdf5File &Set(String name, const Eigen::MatrixXd &d, const Hdf5Storage &storage);
+	Hdf5File &Set(String name, const MultiDimMatrixRowMajor<double> &d, const Hdf5Storage &storage);
+	template <int Rank>
+	Hdf5File &Set(String name, const Eigen::Tensor<double, Rank> &d)	{return Set<Rank>(name, d, storage);}
 	template <int Rank>
-	Hdf5File &Set(String name, const Eigen::Tensor<double, Rank> &d) {
-		if (ExistDataset(name))
-			Delete(name);
-			
+	Hdf5File &Set(String name, const Eigen::Tensor<double, Rank> &d, const Hdf5Storage &storage) {
+		if (IsAsync0()) {
+			Async0([this, name, d, storage] {Set<Rank>(name, d, storage);}, d.size()*sizeof(double));
+			return *this;
+		}
+		bool colmajor = storage.IsColMajor();
 		Buffer<hsize_t> dims(Rank);
 		Vector<int> dimensions(Rank);
 		hsize_t sz = 1;
 		for (int i = 0; i < Rank; ++i) {
-			sz *= dims[i] = d.dimension(i);
+			sz *= dims[colmajor ? Rank-1-i : i] = d.dimension(i);
 			dimensions[i] = int(d.dimension(i));
 		}
-	    HidS dataspace_id = H5Screate_simple(Rank, dims, NULL);
-		if (dataspace_id < 0) 
-			throw Exc("Error creating dataspace");
-	    
-		if ((dts_id = H5Dcreate2(Last(group_ids), name, H5T_NATIVE_DOUBLE, dataspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
-			throw Exc("Error creating dataset");
-		
-		Buffer<double> d_row(sz);
-		ColMajorToRowMajor(d.data(), ~d_row, dimensions);
+		CreateDataset0(name, H5T_NATIVE_DOUBLE, Rank, dims, &storage);
 		
-	    if (H5Dwrite(dts_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, ~d_row) < 0) 
-	        throw Exc("Error writing data to dataset");
-	    
+		if (colmajor) {
+			if (Rank > 1)		// Vectors are the same in both orders, as in Set() of VectorXd
+				SetAttributes0(dts_id, "layout", "col_major");
+			WriteDouble0(d.data());
+		} else {
+			Buffer<double> d_row(sz);
+			ColMajorToRowMajor0(d.data(), ~d_row, dimensions);
+		    WriteDouble0(~d_row);
+		}
 	    return *this;		
 	}
 	
+	// Adds rows to an extendable dataset, created on the first call with the current storage settings.
+	// Rows are buffered and written in whole chunks. The rest is written by Flush(), Close() or when the dataset is read
+	void Append(String name, double d);
+	void Append(String name, const Eigen::VectorXd &row);
+	void Append(String name, const Vector<double> &row);
+	void Append(String name, const Eigen::MatrixXd &rows);
+	void Flush();
+	
+	// Set(), SetDescription() and SetUnits() return at once, and a background thread writes the data in order.
+	// The rest of functions wait for it. maxbytes limits the queued data. Call it after Open() or Create().
+	// The library has to be built thread-safe, as other files may be used meanwhile
+	Hdf5File &Async(bool set = true, int64 maxbytes = 256*1024*1024);
+	bool IsAsync() const								{return async;}
+	
+	// Whole compressed chunks (deflate, LZ4, Zstandard, shuffle and fletcher32) are read and decoded in parallel by GetDouble(). 
+	// Other datasets and selections are read as usual
+	Hdf5File &ParallelDecode(bool set = true);
+	bool IsParallelDecode() const						{return parallel_decode;}
+	
+	// Whole datasets written by Set() are compressed in parallel, and their chunks written with H5Dwrite_chunk()
+	Hdf5File &ParallelEncode(bool set = true);
+	bool IsParallelEncode() const						{return parallel_encode;}
+	
+	Hdf5File &SetStorage(const Hdf5Storage &_storage);	// Default for the datasets created next
+	const Hdf5Storage &GetStorage() const				{return storage;}
+	
 	Hdf5File &SetDescription(String description);
 	Hdf5File &SetUnits(String units);
 	
 	String GetLastError();
-	void SurpressErrorMsgs() 				{H5Eset_auto2(H5E_DEFAULT, NULL, NULL);}
+	void SurpressErrorMsgs();
 
 private:
+	struct Dataset0 {		// Open dataset with its properties
+		HidD id;
+		HidT type;
+		HidS space;
+		H5T_class_t clss;
+		Vector<int> dims;
+		int sz;
+		bool colmajor;
+		int64 tick;
+	};
+	
+	struct Append0 {		// Rows pending to be appended
+		Vector<double> data;
+		int ncols;			// 0 for a one dimension dataset
+		int nrows = 0;
+		int chunkrows;
+		
+		void Add(const double *d, int nrows);
+	};
+	
+	String Close0();
+	
 	hid_t file_id = -1;
 	HidD dts_id;
+	const char *mapped = NULL;		// Start of the file mapping
+	int64 mapped_size = 0;
 	Vector<hid_t> group_ids;
+	Hdf5Storage storage;
+	bool index_names = false;
+	bool parallel_decode = false, parallel_encode = false;
+	ArrayMap<String, VectorMap<String, int>> name_index;		// group path -> object name -> H5O_type_t
+	
+	String GetGroupPath0();
+	static H5O_type_t GetObjType0(hid_t group_id, String name);
+	VectorMap<String, int> *GetNameIndex0(String name);
+	void IndexName0(String name, H5O_type_t type);
+	
+	ArrayMap<String, Append0> appends;		// Pending appends by full path
+	
+	Append0 &GetAppend0(String name, int ncols);
+	void FlushAppend0(String key, Append0 &a, bool all);
+	void DiscardAppend0(String name);
+	
+	struct AsyncJob0 {
+		Function<void ()> run;
+		int64 bytes;
+	};
+	bool async = false, async_stop = false;
+	Thread async_thread;
+	Mutex async_mutex;
+	ConditionVariable async_job, async_done;
+	Array<AsyncJob0> async_jobs;
+	int64 async_bytes = 0, async_maxbytes;
+	String async_error;
+	
+	bool IsAsync0() const;
+	void Async0(Function<void ()> run, int64 bytes);
+	void AsyncRun0();
+	void Sync0();
+	String StopAsync0();
+	
+	ArrayMap<String, Dataset0> datasets;		// Cache of open datasets by full path, least recently used are closed first
+	One<Dataset0> uncached;
+	int cache_size = 64;
+	int64 cache_tick = 0, cache_hits = 0, cache_misses = 0;
+	HidP dapl;						// Dataset access settings, if any
+	
+	hid_t GetDapl0() const			{return dapl >= 0 ? (hid_t)dapl : H5P_DEFAULT;}
+	hid_t Dapl0();
 	
-	void GetData0(String name, HidO &obj_id, hid_t &datatype_id, hid_t &dspace, int &sz, Vector<int> &dims);
+	void SetRowMajor0(String name, const double *d, const Vector<int> &dims, const Hdf5Storage &storage);
+	bool ReuseDataset0(String name, hid_t type, int rank, const hsize_t *dims, const Hdf5Storage *storage);
+	void CreateDataset0(String name, hid_t type, int rank, const hsize_t *dims, const Hdf5Storage *storage, const hsize_t *maxdims = NULL);
+	const Dataset0 &GetData0(String name);
+	void ReadDouble0(const Dataset0 &ds, hid_t memspace, hid_t fspace, double *data);
+	bool ReadChunks0(const Dataset0 &ds, hid_t memspace, hid_t fspace, double *data);
+	void WriteDouble0(const double *data);
+	bool WriteChunks0(const double *data);
+	const double *GetMapped0(const Dataset0 &ds);
+	const double *Map0(String name, const Dataset0 &ds);
+	void Open0(String file, unsigned mode, hid_t fapl);
+	String GetDatasetKey0(String name);
+	void InvalidateCache0(String name);
+	void ClearCache0();
+	static void SelectHyperslab0(hid_t dspace, const Vector<int> &dims, const Vector<int> &start, const Vector<int> &count, 
+				const Vector<int> &stride, const Vector<int> &block, bool colmajor, HidS &memspace, Vector<int> &seldims);
+	static String GetAttribute0(hid_t obj_id, String attribute);
+	static bool IsColMajor0(hid_t obj_id)	{return GetAttribute0(obj_id, "layout") == "col_major";}
+	static Vector<int> Reverse0(const Vector<int> &v);
+	static void ChangeMajor0(const double *src, double *dst, const Vector<int> &dims, bool tocolmajor);
+	static void RowMajorToColMajor0(const double *src, double *dst, const Vector<int> &dims)	{ChangeMajor0(src, dst, dims, true);}
+	static void ColMajorToRowMajor0(const double *src, double *dst, const Vector<int> &dims)	{ChangeMajor0(src, dst, dims, false);}
+	static void TransposeInPlace0(double *d, int n);
 	static void SetAttributes0(hid_t dset_id, String attribute, String val);
     static void SetAttributes(hid_t dset_id, String description, String units);
 };
@@ -249,6 +249,98 @@ bool IterateDataset(String file, bool printdata) {
     return true;
 }
 
+// Converts to the latest chunk index a dataset written for the earliest library versions, extendable only in
+// its last dimension
+void UpgradeLayout(String file) {
+	const int rows = 37, cols = 51;
+	Buffer<int> data(rows*cols), back(rows*cols);
+	for (int i = 0; i < rows*cols; ++i)
+		data[i] = i;
+	
+	hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+	H5Pset_libver_bounds(fapl, H5F_LIBVER_EARLIEST, H5F_LIBVER_LATEST);
+	hid_t file_id = H5Fcreate(file, H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+	hsize_t dims[2] = {rows, cols}, maxdims[2] = {rows, H5S_UNLIMITED}, chunk[2] = {8, 7};
+	hid_t space = H5Screate_simple(2, dims, maxdims);
+	hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+	H5Pset_chunk(dcpl, 2, chunk);
+	hid_t dataset_id = H5Dcreate2(file_id, "/dset_int", H5T_NATIVE_INT, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+	H5Dwrite(dataset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, ~data);
+	H5Dclose(dataset_id);
+	H5Pclose(dcpl);
+	H5Sclose(space);
+	H5Fclose(file_id);
+	H5Pclose(fapl);
+	{
+		Hdf5File hfile;
+		hfile.Open(file);
+		VERIFY(hfile.OptimizeLayout("dset_int") && !hfile.OptimizeLayout("dset_int"));
+	}
+	file_id = H5Fopen(file, H5F_ACC_RDONLY, H5P_DEFAULT);
+	dataset_id = H5Dopen2(file_id, "/dset_int", H5P_DEFAULT);
+	H5D_chunk_index_t idx;
+	VERIFY(H5Dget_chunk_index_type(dataset_id, &idx) >= 0 && idx == H5D_CHUNK_IDX_EARRAY);
+	H5Dread(dataset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, ~back);
+	VERIFY(memcmp(~data, ~back, rows*cols*sizeof(int)) == 0);
+	H5Dclose(dataset_id);
+	H5Fclose(file_id);
+	DeleteFile(file);
+}
+
+// Writes many datasets in one group. Each block takes about the same time, as finding a name before writing
+// it does not scan the group
+void ManyDatasets(String file) {
+	const int n = 100000, block = 10000;
+	Hdf5File hfile;
+	hfile.Create(file);
+	hfile.CreateGroup("many", true);
+	int t0 = msecs();
+	for (int i = 0; i < n; ++i) {
+		hfile.Set(F("value%d", i), i);
+		if ((i+1) % block == 0) {
+			UppLog() << F("\n%d datasets: %d ms for the last %d", i+1, msecs(t0), block);
+			t0 = msecs();
+		}
+	}
+	for (int i = 0; i < n; i += 1000)
+		VERIFY(hfile.ExistDataset(F("value%d", i)) && !hfile.ExistGroup(F("value%d", i)));
+	VERIFY(!hfile.ExistDataset(F("value%d", n)));
+	t0 = msecs();
+	for (int i = 0; i < 2*n; ++i)		// Half of them missing
+		hfile.ExistDataset(F("value%d", i));
+	UppLog() << F("\n%d lookups: %d ms\n", 2*n, msecs(t0));
+	hfile.Close();
+	DeleteFile(file);
+}
+
+// Reads different files from a thread pool. The library has to be built thread-safe
+void ConcurrentRead(String folder) {
+	const int nfiles = 8;
+	for (int i = 0; i < nfiles; ++i) {
+		Hdf5File hfile;
+		hfile.Create(AppendFileName(folder, F("concurrent%d.h5", i)));
+		Eigen::MatrixXd m(200, 100);
+		m.setConstant(i);
+		hfile.Set("matrix", m, Hdf5Storage().Deflate(1));
+		hfile.Set("index", i);
+	}
+	CoWork co;
+	for (int it = 0; it < 20*nfiles; ++it)
+		co & [=] {
+			int i = it % nfiles;
+			Hdf5File hfile;
+			hfile.Open(AppendFileName(folder, F("concurrent%d.h5", i)), H5F_ACC_RDONLY);
+			Eigen::MatrixXd m;
+			hfile.GetDouble("matrix", m);
+			VERIFY(m(199, 99) == i);
+			VERIFY(hfile.GetInt("index") == i);
+		};
+	co.Finish();
+	
+	for (int i = 0; i < nfiles; ++i)
+		DeleteFile(AppendFileName(folder, F("concurrent%d.h5", i)));
+}
+
 CONSOLE_APP_MAIN
 {
 	StdLogSetup(LOG_COUT|LOG_FILE);
@@ -265,6 +357,7 @@ CONSOLE_APP_MAIN
 				WriteDataset(file);
 				IterateDataset(file, true);
 				ReadDataset(file);
+				UpgradeLayout(AppendFileName(GetExeFolder(), "upgrade.h5"));
 			}
 			UppLog() << "\nHDF5 wrapper test\n";
 			String file = AppendFileName(GetExeFolder(), "datalib.h5");
@@ -280,9 +373,25 @@ CONSOLE_APP_MAIN
 				Eigen::MatrixXd a(2, 3);
 				a << 1, 2, 3, 11, 22, 33;
 				hfile.Set("matrix_double", a).SetDescription("This is matrix of double").SetUnits("kg-m^2 (rotation); kg (translation)");
+				hfile.Set("matrix_double_col", a, Hdf5Storage().ColMajor()).SetDescription("Same matrix, stored column-major");
 				Eigen::Tensor<double, 4> m(2, 3, 7, 1);
 				m(0, 2, 5, 0) = 123.45;
-				hfile.Set<4>("multi_matrix", m);
+				hfile.Set<4>("multi_matrix", m, Hdf5Storage().Shuffle().Deflate(6));
+				Eigen::MatrixXd big(200, 150);
+				for (int r = 0; r < big.rows(); ++r)
+					for (int c = 0; c < big.cols(); ++c)
+						big(r, c) = r*c;
+				hfile.Set("matrix_deflate", big, Hdf5Storage().Chunk({50, 50}).Shuffle().Deflate(4));
+				hfile.ParallelEncode().Set("matrix_deflate_par", big, Hdf5Storage().Chunk({50, 50}).Shuffle().Deflate(4));
+#ifdef H5_HAVE_FILTER_LZ4
+				hfile.Set("matrix_lz4", big, Hdf5Storage().Chunk({50, 50}).Shuffle().LZ4());
+				hfile.Set("matrix_bitshuffle", big, Hdf5Storage().Chunk({50, 50}).BitShuffle().LZ4());
+#endif
+#ifdef H5_HAVE_FILTER_ZSTD
+				hfile.Set("matrix_zstd", big, Hdf5Storage().Chunk({50, 50}).Shuffle().Zstd(3));
+#endif
+				for (int i = 0; i < 10; ++i)
+					hfile.Append("time_series", i*0.1);
 			}
 			{
 				Hdf5File hfile;
@@ -300,6 +409,11 @@ CONSOLE_APP_MAIN
 				hfile.GetDouble("matrix_double", m);
 				VERIFY(m(1, 1) == 22);
 				VERIFY(m(1, 2) == 33);
+				hfile.GetDouble("matrix_double_col", m);
+				VERIFY(m(1, 2) == 33);
+				Eigen::MatrixXd mp;
+				hfile.GetDouble("matrix_double", {1, 1}, {1, 2}, mp);
+				VERIFY(mp(0, 1) == 33);
 				MultiDimMatrixIndex icol(2,3, 7, 1);
 				int ic = icol(0, 2, 5, 0);
 				MultiDimMatrixIndexRowMajor irow(2, 3, 7, 1);
@@ -307,8 +421,75 @@ CONSOLE_APP_MAIN
 				MultiDimMatrixRowMajor<double> b;
 				hfile.GetDouble("multi_matrix", b);
 				VERIFY(b(0, 2, 5, 0) == 123.45);
+				Eigen::VectorXd t;
+				hfile.GetDouble("time_series", t);
+				VERIFY(t.size() == 10);
+				double dn;
+				Eigen::MatrixXd mb;
+				Hdf5File::Batch batch;
+				batch.Get("number_double", dn).Get("matrix_double", mb);
+				hfile.GetMany(batch);
+				VERIFY(dn == 24.5 && mb(1, 2) == 33);
+				Eigen::MatrixXd mz, mzp;
+				hfile.GetDouble("matrix_deflate", mz);
+				hfile.ParallelDecode().GetDouble("matrix_deflate", mzp);
+				VERIFY(mz == mzp && mzp(199, 149) == 199*149);
+				hfile.GetDouble("matrix_deflate_par", mzp);
+				VERIFY(mz == mzp);
+#ifdef H5_HAVE_FILTER_LZ4
+				VERIFY(hfile.OptimizeLayout("matrix_lz4") && !hfile.OptimizeLayout("matrix_lz4"));
+				hfile.GetDouble("matrix_lz4", mzp);
+				VERIFY(mz == mzp);
+#endif
+				hfile.ParallelDecode(false);
+#ifdef H5_HAVE_FILTER_ZSTD
+				hfile.GetDouble("matrix_zstd", mzp);
+				VERIFY(mz == mzp);
+#endif
+#ifdef H5_HAVE_FILTER_LZ4
+				hfile.GetDouble("matrix_bitshuffle", mzp);
+				VERIFY(mz == mzp);
+#endif
+				hfile.GetDouble("matrix_deflate", {10, 20}, {100, 30}, mzp);
+				VERIFY(mzp(0, 0) == 10*20 && mzp(99, 29) == 109*49);
+				hfile.SetChunkCache(4*1024*1024);
+				hfile.GetDouble("matrix_deflate", {10, 20}, {100, 30}, mzp);
+				hfile.GetDouble("matrix_deflate", {10, 20}, {100, 30}, mzp);
+				VERIFY(hfile.GetChunkCacheStats("matrix_deflate").nhits > 0);
+			}
+			{
+				Hdf5File hfile;
+				
+				hfile.Open(file, H5F_ACC_RDONLY);
+				hfile.SnapshotChunkIndex().ChangeGroup("simulation_parameters");
+				Eigen::MatrixXd mp;
+				hfile.GetDouble("matrix_deflate", {10, 20}, {100, 30}, mp);
+				VERIFY(mp(0, 0) == 10*20 && mp(99, 29) == 109*49);
+				hfile.SetChunkCache(4*1024*1024).SetChunkPrefetch(8);
+				for (int r = 0; r < 200; r += 10) {
+					hfile.GetDouble("matrix_deflate", {r, 0}, {10, 150}, mp);
+					VERIFY(mp(9, 149) == (r+9)*149);
+				}
+				VERIFY(hfile.GetChunkCacheStats("matrix_deflate").nprefetches > 0);
+			}
+			{
+				Hdf5File hfile;
+				
+				hfile.OpenMapped(file);
+				
+				hfile.ChangeGroup("simulation_parameters");
+				if (hfile.CanMap("matrix_double")) {
+					Hdf5File::MapXd m = hfile.Map("matrix_double"), mc = hfile.Map("matrix_double_col");
+					VERIFY(m(1, 2) == 33 && mc(1, 2) == 33);
+				}
 			}
 			IterateDataset(file, true);
+			UppLog() << "\nHDF5 many datasets test\n";
+			ManyDatasets(AppendFileName(GetExeFolder(), "many.h5"));
+#ifdef H5_HAVE_THREADSAFE
+			UppLog() << "\nHDF5 concurrent read test\n";
+			ConcurrentRead(GetExeFolder());
+#endif
 			UppLog() << "\nAll tests OK\n";
 		} else {
 			String file = command[0];
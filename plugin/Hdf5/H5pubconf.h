@@ -21,9 +21,10 @@
 #define H5_HAVE_WIN32_API 1
 #else
 #define H5_SIZEOF_SSIZE_T H5_SIZEOF_LONG_LONG
-#define __GNU_SOURCE
 #include <dlfcn.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <time.h>
 #include <unistd.h>
 #include <sys/time.h>
 #endif
@@ -122,10 +123,14 @@
 /* #undef H5_HAVE_ATTRIBUTE */
 
 /* Define to 1 if you have the `clock_gettime' function. */
-/* #undef H5_HAVE_CLOCK_GETTIME */
+#if defined(_POSIX_TIMERS) && _POSIX_TIMERS > 0
+#define H5_HAVE_CLOCK_GETTIME 1
+#endif
 
 /* Define to 1 if CLOCK_MONOTONIC_COARSE is available */
-/* #undef H5_HAVE_CLOCK_MONOTONIC_COARSE */
+#if defined(H5_HAVE_CLOCK_GETTIME) && defined(CLOCK_MONOTONIC_COARSE)
+#define H5_HAVE_CLOCK_MONOTONIC_COARSE 1
+#endif
 
 /* Define if the function stack tracing code is to be compiled in */
 /* #undef H5_HAVE_CODESTACK */
@@ -136,8 +141,11 @@
 /* Define if Darwin or Mac OS X */
 /* #undef H5_HAVE_DARWIN */
 
-/* Define if the direct I/O virtual file driver (VFD) should be compiled */
-/* #undef H5_HAVE_DIRECT */
+/* Define if the direct I/O virtual file driver (VFD) should be compiled.
+   glibc shows O_DIRECT only with _GNU_SOURCE, which H5FDdirect.c defines */
+#if defined(O_DIRECT) || defined(__O_DIRECT)
+#define H5_HAVE_DIRECT 1
+#endif
 
 /* Define to 1 if you have the <dirent.h> header file. */
 /* #undef H5_HAVE_DIRENT_H */
@@ -149,7 +157,9 @@
 #define H5_HAVE_EMBEDDED_LIBINFO 1
 
 /* Define to 1 if you have the `fcntl' function. */
-/* #undef H5_HAVE_FCNTL */
+#if defined(_POSIX_VERSION)
+#define H5_HAVE_FCNTL 1
+#endif
 
 /* Define to 1 if you have the <features.h> header file. */
 /* #undef H5_HAVE_FEATURES_H */
@@ -157,6 +167,31 @@
 /* Define if support for deflate (zlib) filter is enabled */
 #define H5_HAVE_FILTER_DEFLATE 1
 
+/* Headers of the LZ4 and Zstandard libraries */
+#ifdef _WIN32
+#define H5_LZ4_HEADER  <plugin/lz4/lib/lz4.h>
+#define H5_ZSTD_HEADER <plugin/zstd/lib/zstd.h>
+#else
+#define H5_LZ4_HEADER  <lz4.h>
+#define H5_ZSTD_HEADER <zstd.h>
+#endif
+
+/* Define if support for LZ4 filter is enabled. Windows builds the bundled library unless the NOLZ4 flag is
+ * set. Elsewhere the system library is linked only with the LZ4 flag, so that its headers are not required */
+#if (defined(_WIN32) ? !defined(flagNOLZ4) : defined(flagLZ4)) && defined(__has_include)
+#if __has_include(H5_LZ4_HEADER)
+#define H5_HAVE_FILTER_LZ4 1
+#endif
+#endif
+
+/* Define if support for Zstandard filter is enabled. As with LZ4, the NOZSTD flag leaves it out on Windows and
+ * the ZSTD flag adds it elsewhere */
+#if (defined(_WIN32) ? !defined(flagNOZSTD) : defined(flagZSTD)) && defined(__has_include)
+#if __has_include(H5_ZSTD_HEADER)
+#define H5_HAVE_FILTER_ZSTD 1
+#endif
+#endif
+
 /* Define if support for szip filter is enabled */
 /* #undef H5_HAVE_FILTER_SZIP */
 
@@ -164,7 +199,11 @@
 /* #undef H5_HAVE_FLOAT128 */
 
 /* Define to 1 if you have the `flock' function. */
-/* #undef H5_HAVE_FLOCK */
+#if defined(_POSIX_VERSION) && defined(__has_include)
+#if __has_include(<sys/file.h>)
+#define H5_HAVE_FLOCK 1
+#endif
+#endif
 
 /* Define to 1 if you have the `fork' function. */
 /* #undef H5_HAVE_FORK */
@@ -222,7 +261,9 @@
 #define H5_HAVE_LIBM 1
 
 /* Define to 1 if you have the `pthread' library (-lpthread). */
-/* #undef H5_HAVE_LIBPTHREAD */
+#if !defined(_WIN32)
+#define H5_HAVE_LIBPTHREAD 1
+#endif
 
 /* Define to 1 if you have the `sz' library (-lsz). */
 /* #undef H5_HAVE_LIBSZ */
@@ -242,6 +283,18 @@
 /* Define whether the Mirror virtual file driver (VFD) will be compiled */
 /* #undef H5_HAVE_MIRROR_VFD */
 
+/* Define if the read-only memory-mapped virtual file driver (VFD) should be compiled */
+#if !defined(_WIN32)
+#define H5_HAVE_MMAP 1
+#endif
+
+/* Define if the io_uring virtual file driver (VFD) should be compiled */
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define H5_HAVE_IOURING 1
+#endif
+#endif
+
 /* Define if MPI_Comm_c2f and MPI_Comm_f2c exist */
 /* #undef H5_HAVE_MPI_MULTI_LANG_Comm */
 
@@ -270,10 +323,14 @@
 /* #undef H5_HAVE_PARALLEL_FILTERED_WRITES */
 
 /* Define if both pread and pwrite exist. */
-/* #undef H5_HAVE_PREADWRITE */
+#if defined(_XOPEN_VERSION) || (defined(_POSIX_VERSION) && _POSIX_VERSION >= 200809L)
+#define H5_HAVE_PREADWRITE 1
+#endif
 
 /* Define to 1 if you have the <pthread.h> header file. */
-/* #undef H5_HAVE_PTHREAD_H */
+#if !defined(_WIN32)
+#define H5_HAVE_PTHREAD_H 1
+#endif
 
 /* Define to 1 if 'pthread_condattr_setclock()' is available */
 /* #undef H5_HAVE_PTHREAD_CONDATTR_SETCLOCK */
@@ -325,7 +382,11 @@
 /* #undef H5_HAVE_SYMLINK */
 
 /* Define to 1 if you have the <sys/file.h> header file. */
-/* #undef H5_HAVE_SYS_FILE_H */
+#if defined(__has_include)
+#if __has_include(<sys/file.h>)
+#define H5_HAVE_SYS_FILE_H 1
+#endif
+#endif
 
 /* Define to 1 if you have the <sys/ioctl.h> header file. */
 /* #undef H5_HAVE_SYS_IOCTL_H */
@@ -340,7 +401,11 @@
 #define H5_HAVE_SYS_STAT_H 1
 
 /* Define to 1 if you have the <sys/time.h> header file. */
-/* #undef H5_HAVE_SYS_TIME_H */
+#if defined(__has_include)
+#if __has_include(<sys/time.h>)
+#define H5_HAVE_SYS_TIME_H 1
+#endif
+#endif
 
 /* Define to 1 if you have the <sys/types.h> header file. */
 #define H5_HAVE_SYS_TYPES_H 1
@@ -354,8 +419,8 @@
 /* Not supported on WIN32 platforms with static linking */
 /* #undef H5_HAVE_THREADSAFE */
 #else
-/* Define if we have thread safe support */
-/* #undef H5_HAVE_THREADSAFE */
+/* Define if we have thread safe support. With pthreads, every API call takes a global lock */
+#define H5_HAVE_THREADSAFE 1
 #endif
 
 /* Define if timezone is a global variable */
@@ -374,7 +439,11 @@
 /* #undef H5_HAVE_TM_GMTOFF */
 
 /* Define to 1 if you have the <unistd.h> header file. */
-/* #undef H5_HAVE_UNISTD_H */
+#if defined(__has_include)
+#if __has_include(<unistd.h>)
+#define H5_HAVE_UNISTD_H 1
+#endif
+#endif
 
 /* Define to 1 if you have the `vasprintf' function. */
 /* #undef H5_HAVE_VASPRINTF */
@@ -396,6 +465,7 @@
 #else
 #define H5_ZLIB_HEADER <zlib.h>				
 #endif
+
 	
 
 /* Define to 1 if you have the `_getvideoconfig' function. */
@@ -522,7 +592,11 @@
 /* #undef H5_SIZEOF_SSIZE_T */
 
 /* The size of `long', as computed by sizeof. */
+#if defined(__LP64__) && __LP64__
+#define H5_SIZEOF_LONG 8
+#else
 #define H5_SIZEOF_LONG 4
+#endif
 
 /* The size of `long double', as computed by sizeof. */
 #define H5_SIZEOF_LONG_DOUBLE 8
@@ -565,7 +639,11 @@
 /* #undef H5_SIZEOF_OFF64_T */
 
 /* The size of `off_t', as computed by sizeof. */
+#if !defined(_WIN32) && ((defined(__LP64__) && __LP64__) || (defined(_FILE_OFFSET_BITS) && _FILE_OFFSET_BITS == 64))
+#define H5_SIZEOF_OFF_T 8
+#else
 #define H5_SIZEOF_OFF_T 4
+#endif
 
 /* The size of `ptrdiff_t', as computed by sizeof. */
 /* #undef H5_SIZEOF_PTRDIFF_T */
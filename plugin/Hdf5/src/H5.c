@@ -250,6 +250,7 @@ H5_init_library(void)
             const char *descr;
         } initializer[] = {
             {H5E_init, "error"}
+        ,   {H5_cpu_init, "CPU features"}
         ,   {H5VL_init_phase1, "VOL"}
         ,   {H5SL_init, "skip lists"}
         ,   {H5FD_init, "VFD"}
@@ -912,6 +912,45 @@ done:
     FUNC_LEAVE_API(ret_value)
 } /* end H5Dget_offset() */
 
+/*-------------------------------------------------------------------------
+ * Function:    H5Dget_chunk_cache_stats
+ *
+ * Purpose:     Retrieves the hit, miss, collision and eviction counters of
+ *              the raw data chunk cache of a dataset.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Dget_chunk_cache_stats(hid_t dset_id, H5D_chunk_cache_stats_t *stats /*out*/)
+{
+    H5VL_object_t                      *vol_obj;             /* Dataset for this operation */
+    H5VL_optional_args_t                vol_cb_args;         /* Arguments to VOL callback */
+    H5VL_native_dataset_optional_args_t dset_opt_args;       /* Arguments for optional operation */
+    herr_t                              ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+
+    /* Check args */
+    if (NULL == (vol_obj = H5VL_vol_object_verify(dset_id, H5I_DATASET)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "invalid dataset identifier");
+    if (NULL == stats)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "stats parameter cannot be NULL");
+
+    /* Set up VOL callback arguments */
+    dset_opt_args.get_chunk_cache_stats.stats = stats;
+    vol_cb_args.op_type                       = H5VL_NATIVE_DATASET_GET_CHUNK_CACHE_STATS;
+    vol_cb_args.args                          = &dset_opt_args;
+
+    /* Get the counters */
+    if (H5VL_dataset_optional(vol_obj, &vol_cb_args, H5P_DATASET_XFER_DEFAULT, H5_REQUEST_NULL) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "unable to get chunk cache statistics");
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Dget_chunk_cache_stats() */
+
 /*-------------------------------------------------------------------------
  * Function:    H5D__read_api_common
  *
@@ -2143,6 +2182,48 @@ done:
     FUNC_LEAVE_API(ret_value)
 } /* H5Dformat_convert */
 
+/*-------------------------------------------------------------------------
+ * Function:    H5Dformat_upgrade
+ *
+ * Purpose:     For chunked:
+ *                  Convert the chunk indexing type from version 1 B-tree
+ *                  to the latest indexing type
+ *              For compact/contiguous/virtual:
+ *                  No conversion
+ *
+ * Return:      Non-negative on success, negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Dformat_upgrade(hid_t dset_id)
+{
+    H5VL_object_t       *vol_obj;             /* Dataset for this operation   */
+    H5VL_optional_args_t vol_cb_args;         /* Arguments to VOL callback */
+    herr_t               ret_value = SUCCEED; /* Return value                 */
+
+    FUNC_ENTER_API(FAIL)
+
+    /* Check args */
+    if (NULL == (vol_obj = H5VL_vol_object_verify(dset_id, H5I_DATASET)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "dset_id parameter is not a valid dataset identifier");
+
+    /* Set up collective metadata if appropriate */
+    if (H5CX_set_loc(dset_id) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTSET, FAIL, "can't set collective metadata read info");
+
+    /* Set up VOL callback arguments */
+    vol_cb_args.op_type = H5VL_NATIVE_DATASET_FORMAT_UPGRADE;
+    vol_cb_args.args    = NULL;
+
+    /* Convert the dataset */
+    if (H5VL_dataset_optional(vol_obj, &vol_cb_args, H5P_DATASET_XFER_DEFAULT, H5_REQUEST_NULL) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTUPDATE, FAIL, "can't upgrade dataset format");
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* H5Dformat_upgrade */
+
 /*-------------------------------------------------------------------------
  * Function:    H5Dget_chunk_index_type (Internal)
  *
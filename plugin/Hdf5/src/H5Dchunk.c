@@ -120,6 +120,24 @@
     0x02U /* Filters have been disabled since                                                                \
            * the last flush */
 
+/* Open hash table of the chunk cache: sentinel of the slots whose chunk was
+ * evicted, and maximum number of chunks it holds */
+#define H5D_RDCC_DELETED           (&H5D_rdcc_deleted_g)
+#define H5D_RDCC_OPEN_MAX(rdcc)    ((rdcc)->nslots - (rdcc)->nslots / 4)
+#define H5D_RDCC_OPEN_REHASH(rdcc)                                                                           \
+    ((size_t)(rdcc)->nused + (rdcc)->ndeleted >= (rdcc)->nslots - (rdcc)->nslots / 8)
+
+/* Whether the chunk cache must preempt before caching a chunk of SIZE bytes */
+#define H5D_RDCC_FULL(rdcc, size)                                                                            \
+    ((rdcc)->nbytes_used + (size) > (rdcc)->nbytes_max ||                                                    \
+     (H5D_CHUNK_CACHE_HASH_OPEN == (rdcc)->hash && (size_t)(rdcc)->nused >= H5D_RDCC_OPEN_MAX(rdcc)))
+
+/* Snapshot of the chunk index: slots it starts with, and most written chunks
+ * it holds (24 bytes each, in a table at most half full) before the dataset
+ * goes on using the chunk index */
+#define H5D_CHUNK_SNAP_MIN_SLOTS  64
+#define H5D_CHUNK_SNAP_MAX_CHUNKS ((size_t)1 << 20)
+
 /******************/
 /* Local Typedefs */
 /******************/
@@ -129,6 +147,8 @@ typedef struct H5D_rdcc_ent_t {
     bool                   locked;                   /*entry is locked in cache        */
     bool                   dirty;                    /*needs to be written to disk?        */
     bool                   deleted;                  /*chunk about to be deleted        */
+    bool                   hot;                      /*chunk used again since cached (2Q) */
+    bool                   prefetched;               /*chunk read ahead and not used yet */
     unsigned               edge_chunk_state;         /*states related to edge chunks (see above) */
     hsize_t                scaled[H5O_LAYOUT_NDIMS]; /*scaled chunk 'name' (coordinates) */
     uint32_t               rd_count;                 /*bytes remaining to be read        */
@@ -256,6 +276,31 @@ typedef struct H5D_chunk_iter_ud_t {
     haddr_t             base_addr; /* Base address of the file, taking user block into account */
 } H5D_chunk_iter_ud_t;
 
+/* Snapshot of the chunk index: one record for each chunk of the dataset
+ * extent, in the order of the chunks' linear index */
+/* Snapshot of the chunk index: an open hash table of the written chunks,
+ * keyed by their linear index in the dataset extent */
+typedef struct H5D_chunk_snap_ent_t {
+    hsize_t  idx;         /* Linear index of the chunk, or HSIZE_UNDEF for an empty slot */
+    haddr_t  addr;        /* Address of the chunk in the file */
+    uint32_t nbytes;      /* Size of the stored chunk */
+    unsigned filter_mask; /* Excluded filters */
+} H5D_chunk_snap_ent_t;
+
+typedef struct H5D_chunk_snap_t {
+    size_t                nslots; /* Number of slots, a power of two */
+    size_t                nused;  /* Number of chunks stored */
+    H5D_chunk_snap_ent_t *ent;    /* Slots */
+} H5D_chunk_snap_t;
+
+/* Callback info for iteration to load a snapshot of the chunk index */
+typedef struct H5D_chunk_snap_ud_t {
+    const H5O_layout_chunk_t *layout;    /* Chunk layout */
+    unsigned                  ndims;     /* Rank of the dataset */
+    H5D_chunk_snap_t         *snap;      /* Snapshot being loaded */
+    bool                      too_large; /* Whether the snapshot had to be given up */
+} H5D_chunk_snap_ud_t;
+
 /********************/
 /* Local Prototypes */
 /********************/
@@ -277,6 +322,9 @@ static int H5D__get_num_chunks_cb(const H5D_chunk_rec_t *chunk_rec, void *_udata
 static int H5D__get_chunk_info_cb(const H5D_chunk_rec_t *chunk_rec, void *_udata);
 static int H5D__get_chunk_info_by_coord_cb(const H5D_chunk_rec_t *chunk_rec, void *_udata);
 static int H5D__chunk_iter_cb(const H5D_chunk_rec_t *chunk_rec, void *udata);
+static size_t H5D__chunk_snap_slot(const H5D_chunk_snap_t *snap, hsize_t idx);
+static bool   H5D__chunk_snap_grow(H5D_chunk_snap_t *snap);
+static int    H5D__chunk_snap_cb(const H5D_chunk_rec_t *chunk_rec, void *_udata);
 
 /* "Nonexistent" layout operation callback */
 static ssize_t H5D__nonexistent_readvv(const H5D_io_info_t *io_info, const H5D_dset_io_info_t *dset_info,
@@ -293,6 +341,8 @@ static herr_t   H5D__chunk_set_info_real(H5O_layout_chunk_t *layout, unsigned nd
 static herr_t   H5D__chunk_cinfo_cache_reset(H5D_chunk_cached_t *last);
 static herr_t   H5D__chunk_cinfo_cache_update(H5D_chunk_cached_t *last, const H5D_chunk_ud_t *udata);
 static bool     H5D__chunk_cinfo_cache_found(const H5D_chunk_cached_t *last, H5D_chunk_ud_t *udata);
+static herr_t   H5D__chunk_snap_load(const H5D_t *dset);
+static htri_t   H5D__chunk_snap_found(const H5D_t *dset, H5D_chunk_ud_t *udata);
 static herr_t   H5D__create_piece_map_single(H5D_dset_io_info_t *di, H5D_io_info_t *io_info);
 static herr_t   H5D__create_piece_file_map_all(H5D_dset_io_info_t *di, H5D_io_info_t *io_info);
 static herr_t   H5D__create_piece_file_map_hyper(H5D_dset_io_info_t *di, H5D_io_info_t *io_info);
@@ -304,13 +354,24 @@ static herr_t   H5D__piece_mem_cb(void *elem, const H5T_t *type, unsigned ndims,
                                   void *_opdata);
 static herr_t   H5D__chunk_may_use_select_io(H5D_io_info_t *io_info, const H5D_dset_io_info_t *dset_info);
 static unsigned H5D__chunk_hash_val(const H5D_shared_t *shared, const hsize_t *scaled);
+static unsigned H5D__chunk_hash_mix(const H5D_shared_t *shared, const hsize_t *scaled);
+static unsigned H5D__chunk_cache_find(const H5D_shared_t *shared, const hsize_t *scaled);
+static void     H5D__chunk_cache_clear_slot(H5D_rdcc_t *rdcc, unsigned idx);
+static void     H5D__chunk_cache_rehash(const H5D_t *dset);
+static void     H5D__chunk_cache_link(H5D_rdcc_t *rdcc, H5D_rdcc_ent_t *ent);
+static void     H5D__chunk_cache_unlink(H5D_rdcc_t *rdcc, H5D_rdcc_ent_t *ent);
 static herr_t   H5D__chunk_flush_entry(const H5D_t *dset, H5D_rdcc_ent_t *ent, bool reset);
 static herr_t   H5D__chunk_cache_evict(const H5D_t *dset, H5D_rdcc_ent_t *ent, bool flush);
+static herr_t   H5D__chunk_cache_preempt(const H5D_t *dset, H5D_rdcc_ent_t *ent);
+static herr_t   H5D__chunk_cache_insert(const H5D_t *dset, H5D_chunk_ud_t *udata, size_t chunk_size,
+                                        bool disable_filters, void *chunk, H5D_rdcc_ent_t **entp);
+static herr_t   H5D__chunk_prefetch(const H5D_t *dset, const hsize_t *scaled);
 static void    *H5D__chunk_lock(const H5D_io_info_t *io_info, const H5D_dset_io_info_t *dset_info,
                                 H5D_chunk_ud_t *udata, bool relax, bool prev_unfilt_chunk);
 static herr_t   H5D__chunk_unlock(const H5D_io_info_t *io_info, const H5D_dset_io_info_t *dset_info,
                                   const H5D_chunk_ud_t *udata, bool dirty, void *chunk, uint32_t naccessed);
 static herr_t   H5D__chunk_cache_prune(const H5D_t *dset, size_t size);
+static herr_t   H5D__chunk_cache_prune_2q(const H5D_t *dset, size_t size);
 static herr_t   H5D__chunk_prune_fill(H5D_chunk_it_ud1_t *udata, bool new_unfilt_chunk);
 #ifdef H5_HAVE_PARALLEL
 static herr_t H5D__chunk_collective_fill(const H5D_t *dset, H5D_chunk_coll_fill_info_t *chunk_fill_info,
@@ -356,6 +417,9 @@ H5FL_SEQ_DEFINE_STATIC(H5D_rdcc_ent_ptr_t);
 /* Declare a free list to manage H5D_rdcc_ent_t objects */
 H5FL_DEFINE_STATIC(H5D_rdcc_ent_t);
 
+/* Marks the slots of an open hash chunk cache whose chunk was evicted */
+static H5D_rdcc_ent_t H5D_rdcc_deleted_g;
+
 /* Declare a free list to manage the H5D_chunk_info_t struct */
 H5FL_DEFINE_STATIC(H5D_chunk_map_t);
 
@@ -910,6 +974,32 @@ H5D__chunk_init(H5F_t *f, const H5D_t *const dset, hid_t dapl_id)
     if (rdcc->w0 < 0)
         rdcc->w0 = H5F_RDCC_W0(f);
 
+    if (H5P_get(dapl, H5D_ACS_DATA_CACHE_HASH_NAME, &rdcc->hash) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't get data cache lookup");
+    if (H5P_get(dapl, H5D_ACS_DATA_CACHE_POLICY_NAME, &rdcc->policy) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't get data cache policy");
+
+    /* A snapshot of the chunk index is only taken if nobody can change the index */
+    if (H5P_get(dapl, H5D_ACS_CHUNK_IDX_SNAPSHOT_NAME, &rdcc->use_snap) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't get chunk index snapshot");
+    if (H5F_INTENT(f) & (H5F_ACC_RDWR | H5F_ACC_SWMR_READ))
+        rdcc->use_snap = false;
+
+    /* Chunks are only read ahead for datasets with filters, and never by MPI processes */
+    if (H5P_get(dapl, H5D_ACS_DATA_CACHE_PREFETCH_NAME, &rdcc->prefetch) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't get data cache read-ahead");
+    if (0 == dset->shared->dcpl_cache.pline.nused)
+        rdcc->prefetch = 0;
+    rdcc->pf_window = rdcc->prefetch;
+    rdcc->pf_last   = HSIZE_UNDEF;
+    rdcc->pf_stride = 1;
+#ifdef H5_HAVE_PARALLEL
+    if (H5F_HAS_FEATURE(f, H5FD_FEAT_HAS_MPI)) {
+        rdcc->use_snap = false;
+        rdcc->prefetch = 0;
+    } /* end if */
+#endif /* H5_HAVE_PARALLEL */
+
     /* If nbytes_max or nslots is 0, set them both to 0 and avoid allocating space */
     if (!rdcc->nbytes_max || !rdcc->nslots)
         rdcc->nbytes_max = rdcc->nslots = 0;
@@ -2900,6 +2990,9 @@ H5D__chunk_read(H5D_io_info_t *io_info, H5D_dset_io_info_t *dset_info)
                     0)
                     HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't tell if chunk is cacheable");
                 if (cacheable) {
+                    /* Whether the chunk is read from the file */
+                    bool missed = (UINT_MAX == udata.idx_hint && H5_addr_defined(udata.chunk_block.offset));
+
                     /* Load the chunk into cache and lock it. */
 
                     /* Compute # of bytes accessed in chunk */
@@ -2912,6 +3005,11 @@ H5D__chunk_read(H5D_io_info_t *io_info, H5D_dset_io_info_t *dset_info)
                     if (NULL == (chunk = H5D__chunk_lock(io_info, dset_info, &udata, false, false)))
                         HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "unable to read raw data chunk");
 
+                    /* Read the next chunks ahead if the chunks are missed in order */
+                    if (missed && dset_info->dset->shared->cache.chunk.prefetch > 0)
+                        if (H5D__chunk_prefetch(dset_info->dset, chunk_info->scaled) < 0)
+                            HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "unable to read chunks ahead");
+
                     /* Set up the storage buffer information for this chunk */
                     cpt_store.compact.buf = chunk;
 
@@ -3513,6 +3611,10 @@ H5D__chunk_dest(H5D_t *dset)
     /* Release cache structures */
     if (rdcc->slot)
         rdcc->slot = H5FL_SEQ_FREE(H5D_rdcc_ent_ptr_t, rdcc->slot);
+    if (rdcc->snap) {
+        H5MM_xfree(rdcc->snap->ent);
+        rdcc->snap = H5MM_xfree(rdcc->snap);
+    } /* end if */
     memset(rdcc, 0, sizeof(H5D_rdcc_t));
 
     /* Compose chunked index info struct */
@@ -3659,6 +3761,254 @@ done:
     FUNC_LEAVE_NOAPI(ret_value)
 } /* H5D__chunk_cinfo_cache_found() */
 
+/*-------------------------------------------------------------------------
+ * Function:    H5D__chunk_snap_slot
+ *
+ * Purpose:     Finds the slot of a chunk in the snapshot of the chunk
+ *              index, or the empty slot where it would go.
+ *
+ * Return:      Index of the slot
+ *
+ *-------------------------------------------------------------------------
+ */
+static size_t
+H5D__chunk_snap_slot(const H5D_chunk_snap_t *snap, hsize_t idx)
+{
+    uint64_t val = ((uint64_t)idx + 1) * UINT64_C(0x9E3779B97F4A7C15); /* Hash of the chunk index */
+    size_t   slot;                                                      /* Slot being checked */
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    /* The table is never more than half full, so an empty slot is found */
+    val ^= val >> 32;
+    slot = (size_t)val & (snap->nslots - 1);
+    while (snap->ent[slot].idx != idx && snap->ent[slot].idx != HSIZE_UNDEF)
+        slot = (slot + 1) & (snap->nslots - 1);
+
+    FUNC_LEAVE_NOAPI(slot)
+} /* H5D__chunk_snap_slot() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5D__chunk_snap_grow
+ *
+ * Purpose:     Doubles the number of slots of the snapshot of the chunk
+ *              index, putting the chunks back in the table.
+ *
+ * Return:      true on success, false if there is not enough memory
+ *
+ *-------------------------------------------------------------------------
+ */
+static bool
+H5D__chunk_snap_grow(H5D_chunk_snap_t *snap)
+{
+    H5D_chunk_snap_ent_t *old  = snap->ent;      /* Previous slots */
+    size_t                nold = snap->nslots;   /* Previous number of slots */
+    H5D_chunk_snap_ent_t *ent;                   /* New slots */
+    size_t                u;                     /* Local index variable */
+    bool                  ret_value = true;      /* Return value */
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    if (NULL == (ent = (H5D_chunk_snap_ent_t *)H5MM_malloc(2 * nold * sizeof(H5D_chunk_snap_ent_t))))
+        HGOTO_DONE(false);
+    for (u = 0; u < 2 * nold; u++)
+        ent[u].idx = HSIZE_UNDEF;
+
+    snap->ent    = ent;
+    snap->nslots = 2 * nold;
+    for (u = 0; u < nold; u++)
+        if (old[u].idx != HSIZE_UNDEF)
+            snap->ent[H5D__chunk_snap_slot(snap, old[u].idx)] = old[u];
+    H5MM_xfree(old);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* H5D__chunk_snap_grow() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5D__chunk_snap_cb
+ *
+ * Purpose:     Stores the address, size and filter mask of a chunk in the
+ *              snapshot of the chunk index.  The iteration is stopped if
+ *              the snapshot would hold more than H5D_CHUNK_SNAP_MAX_CHUNKS
+ *              chunks or can't grow.
+ *
+ * Return:      H5_ITER_CONT/H5_ITER_STOP
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+H5D__chunk_snap_cb(const H5D_chunk_rec_t *chunk_rec, void *_udata)
+{
+    H5D_chunk_snap_ud_t  *udata = (H5D_chunk_snap_ud_t *)_udata; /* User data for callback */
+    H5D_chunk_snap_t     *snap  = udata->snap;                   /* Snapshot being loaded */
+    H5D_chunk_snap_ent_t *ent;                                   /* Slot of the chunk */
+    hsize_t               idx;                                   /* Linear index of the chunk */
+    unsigned              u;                                     /* Local index variable */
+    int                   ret_value = H5_ITER_CONT;              /* Return value */
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    /* Chunks left beyond the current extent are not in the snapshot */
+    for (u = 0; u < udata->ndims; u++)
+        if (chunk_rec->scaled[u] >= udata->layout->chunks[u])
+            HGOTO_DONE(H5_ITER_CONT);
+
+    /* Keep the table at most half full */
+    if (snap->nused >= H5D_CHUNK_SNAP_MAX_CHUNKS ||
+        (2 * (snap->nused + 1) > snap->nslots && !H5D__chunk_snap_grow(snap))) {
+        udata->too_large = true;
+        HGOTO_DONE(H5_ITER_STOP);
+    } /* end if */
+
+    idx = H5VM_array_offset_pre(udata->ndims, udata->layout->down_chunks, chunk_rec->scaled);
+    ent = &snap->ent[H5D__chunk_snap_slot(snap, idx)];
+    if (ent->idx == HSIZE_UNDEF) {
+        ent->idx = idx;
+        snap->nused++;
+    } /* end if */
+    ent->addr        = chunk_rec->chunk_addr;
+    ent->nbytes      = chunk_rec->nbytes;
+    ent->filter_mask = chunk_rec->filter_mask;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* H5D__chunk_snap_cb() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5D__chunk_snap_load
+ *
+ * Purpose:     Loads the whole chunk index of a dataset into a snapshot,
+ *              a hash table with the address, size and filter mask of
+ *              every written chunk of the dataset extent.  Its size goes
+ *              with the number of written chunks.  If it would hold more
+ *              than H5D_CHUNK_SNAP_MAX_CHUNKS chunks or not fit in memory
+ *              the dataset goes on using the chunk index.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__chunk_snap_load(const H5D_t *dset)
+{
+    H5D_rdcc_t         *rdcc   = &(dset->shared->cache.chunk); /* Raw data chunk cache */
+    H5O_layout_t       *layout = &(dset->shared->layout);      /* Dataset layout */
+    H5D_chunk_snap_t   *snap   = NULL;                         /* Snapshot being loaded */
+    H5D_chk_idx_info_t  idx_info;                              /* Chunked index info */
+    H5D_chunk_snap_ud_t udata;                                 /* User data for iteration callback */
+    size_t              u;                                     /* Local index variable */
+    herr_t              ret_value = SUCCEED;                   /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    /* Sanity checks */
+    assert(rdcc->use_snap);
+    assert(!rdcc->snap);
+
+    if (NULL == (snap = (H5D_chunk_snap_t *)H5MM_calloc(sizeof(H5D_chunk_snap_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for chunk index snapshot");
+    snap->nslots = H5D_CHUNK_SNAP_MIN_SLOTS;
+    if (NULL ==
+        (snap->ent = (H5D_chunk_snap_ent_t *)H5MM_malloc(snap->nslots * sizeof(H5D_chunk_snap_ent_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for chunk index snapshot");
+    for (u = 0; u < snap->nslots; u++)
+        snap->ent[u].idx = HSIZE_UNDEF;
+
+    /* Compose chunked index info struct */
+    idx_info.f       = dset->oloc.file;
+    idx_info.pline   = &dset->shared->dcpl_cache.pline;
+    idx_info.layout  = &layout->u.chunk;
+    idx_info.storage = &layout->storage.u.chunk;
+
+    /* Store every written chunk */
+    if (H5_addr_defined(idx_info.storage->idx_addr)) {
+        udata.layout    = &layout->u.chunk;
+        udata.ndims     = dset->shared->ndims;
+        udata.snap      = snap;
+        udata.too_large = false;
+        if ((layout->storage.u.chunk.ops->iterate)(&idx_info, H5D__chunk_snap_cb, &udata) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "unable to iterate over chunk index");
+
+        /* Too many chunks: keep using the chunk index */
+        if (udata.too_large) {
+            rdcc->use_snap = false;
+            HGOTO_DONE(SUCCEED);
+        } /* end if */
+    }     /* end if */
+
+    rdcc->snap = snap;
+    snap       = NULL;
+
+done:
+    if (snap) {
+        H5MM_xfree(snap->ent);
+        H5MM_xfree(snap);
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* H5D__chunk_snap_load() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5D__chunk_snap_found
+ *
+ * Purpose:     Looks up a chunk in the snapshot of the chunk index, loading
+ *              the snapshot the first time.
+ *
+ * Return:      true if the chunk information was retrieved from the
+ *              snapshot, false if the chunk index has to be used/Negative
+ *              on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static htri_t
+H5D__chunk_snap_found(const H5D_t *dset, H5D_chunk_ud_t *udata)
+{
+    H5D_rdcc_t                 *rdcc = &(dset->shared->cache.chunk); /* Raw data chunk cache */
+    const H5D_chunk_snap_ent_t *ent;                                 /* Record of the chunk */
+    hsize_t                     idx;                                 /* Linear index of the chunk */
+    unsigned                    u;                                   /* Local index variable */
+    htri_t                      ret_value = false;                   /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    if (!rdcc->use_snap)
+        HGOTO_DONE(false);
+    if (!rdcc->snap) {
+        if (H5D__chunk_snap_load(dset) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTLOAD, FAIL, "unable to load chunk index snapshot");
+        if (!rdcc->snap)
+            HGOTO_DONE(false);
+    } /* end if */
+
+    for (u = 0; u < dset->shared->ndims; u++)
+        if (udata->common.scaled[u] >= dset->shared->layout.u.chunk.chunks[u])
+            HGOTO_DONE(false);
+    idx = H5VM_array_offset_pre(dset->shared->ndims, dset->shared->layout.u.chunk.down_chunks,
+                                udata->common.scaled);
+
+    /* A chunk missing from the snapshot has not been written */
+    ent = &rdcc->snap->ent[H5D__chunk_snap_slot(rdcc->snap, idx)];
+    if (ent->idx == HSIZE_UNDEF) {
+        udata->chunk_block.offset = HADDR_UNDEF;
+        udata->chunk_block.length = 0;
+        udata->filter_mask        = 0;
+    } /* end if */
+    else {
+        udata->chunk_block.offset = ent->addr;
+        udata->chunk_block.length = ent->nbytes;
+        udata->filter_mask        = ent->filter_mask;
+    } /* end else */
+    ret_value = true;
+
+    /* The index-specific chunk index is only needed to insert chunks, which
+     * cannot happen on a file opened read-only */
+    udata->chunk_idx = HSIZE_UNDEF;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* H5D__chunk_snap_found() */
+
 /*-------------------------------------------------------------------------
  * Function:    H5D__chunk_create
  *
@@ -3748,6 +4098,250 @@ H5D__chunk_hash_val(const H5D_shared_t *shared, const hsize_t *scaled)
     FUNC_LEAVE_NOAPI(ret)
 } /* H5D__chunk_hash_val() */
 
+/*-------------------------------------------------------------------------
+ * Function:    H5D__chunk_hash_mix
+ *
+ * Purpose:     To calculate the first slot of a chunk in an open hash
+ *              chunk cache.  Unlike H5D__chunk_hash_val, every bit of the
+ *              scaled coordinates affects the result, so chunks taken with
+ *              a stride that divides the number of slots do not pile up
+ *              in the same slots.
+ *
+ * Return:      Hash value index
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+H5D__chunk_hash_mix(const H5D_shared_t *shared, const hsize_t *scaled)
+{
+    uint64_t val = 0; /* Intermediate value */
+    unsigned u;       /* Local index variable */
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    /* Sanity check */
+    assert(shared);
+    assert(scaled);
+
+    for (u = 0; u < shared->ndims; u++) {
+        val = (val ^ (uint64_t)scaled[u]) * UINT64_C(0x9E3779B97F4A7C15);
+        val ^= val >> 29;
+    } /* end for */
+    val ^= val >> 32;
+
+    FUNC_LEAVE_NOAPI((unsigned)(val % shared->cache.chunk.nslots))
+} /* H5D__chunk_hash_mix() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5D__chunk_cache_find
+ *
+ * Purpose:     Looks up a chunk in the slots of the chunk cache.
+ *
+ * Return:      Index of the chunk's slot, or UINT_MAX if the chunk is not
+ *              in the cache
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+H5D__chunk_cache_find(const H5D_shared_t *shared, const hsize_t *scaled)
+{
+    const H5D_rdcc_t *rdcc = &(shared->cache.chunk); /* Raw data chunk cache */
+    H5D_rdcc_ent_t   *ent;                           /* Cache entry */
+    unsigned          idx;                           /* Slot being checked */
+    size_t            nprobes;                       /* Number of slots left to check */
+    unsigned          u;                             /* Local index variable */
+    unsigned          ret_value = UINT_MAX;          /* Return value */
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    /* Sanity check */
+    assert(rdcc->nslots > 0);
+
+    /* Direct hashing checks the one slot the chunk may be in, open hashing
+     * checks the following slots until an empty one */
+    if (H5D_CHUNK_CACHE_HASH_OPEN == rdcc->hash) {
+        idx     = H5D__chunk_hash_mix(shared, scaled);
+        nprobes = rdcc->nslots;
+    } /* end if */
+    else {
+        idx     = H5D__chunk_hash_val(shared, scaled);
+        nprobes = 1;
+    } /* end else */
+
+    for (; nprobes > 0; nprobes--) {
+        if (NULL == (ent = rdcc->slot[idx]))
+            break;
+        if (ent != H5D_RDCC_DELETED) {
+            for (u = 0; u < shared->ndims; u++)
+                if (scaled[u] != ent->scaled[u])
+                    break;
+            if (u == shared->ndims) {
+                ret_value = idx;
+                break;
+            } /* end if */
+        }     /* end if */
+        if (++idx == rdcc->nslots)
+            idx = 0;
+    } /* end for */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* H5D__chunk_cache_find() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5D__chunk_cache_clear_slot
+ *
+ * Purpose:     Empties a slot of the chunk cache after its chunk has been
+ *              evicted.  In an open hash table the slot can only be emptied
+ *              if no probe continues past it; otherwise it is marked as
+ *              deleted.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5D__chunk_cache_clear_slot(H5D_rdcc_t *rdcc, unsigned idx)
+{
+    FUNC_ENTER_PACKAGE_NOERR
+
+    assert(idx < rdcc->nslots);
+
+    if (H5D_CHUNK_CACHE_HASH_OPEN == rdcc->hash && rdcc->slot[(idx + 1) % rdcc->nslots] != NULL) {
+        rdcc->slot[idx] = H5D_RDCC_DELETED;
+        rdcc->ndeleted++;
+    } /* end if */
+    else {
+        rdcc->slot[idx] = NULL;
+
+        /* The deleted slots just before this one are not needed anymore */
+        if (H5D_CHUNK_CACHE_HASH_OPEN == rdcc->hash) {
+            idx = (unsigned)((idx + rdcc->nslots - 1) % rdcc->nslots);
+            while (rdcc->slot[idx] == H5D_RDCC_DELETED) {
+                rdcc->slot[idx] = NULL;
+                rdcc->ndeleted--;
+                idx = (unsigned)((idx + rdcc->nslots - 1) % rdcc->nslots);
+            } /* end while */
+        }     /* end if */
+    }         /* end else */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* H5D__chunk_cache_clear_slot() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5D__chunk_cache_rehash
+ *
+ * Purpose:     Puts every chunk of an open hash chunk cache back in the
+ *              table, dropping the deleted slots.  No chunk may be locked,
+ *              since locked chunks are known by their slot.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5D__chunk_cache_rehash(const H5D_t *dset)
+{
+    H5D_rdcc_t     *rdcc = &(dset->shared->cache.chunk); /* Raw data chunk cache */
+    H5D_rdcc_ent_t *ent;                                 /* Cache entry */
+    unsigned        idx;                                 /* Slot of the entry */
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    assert(H5D_CHUNK_CACHE_HASH_OPEN == rdcc->hash);
+
+    memset(rdcc->slot, 0, rdcc->nslots * sizeof(H5D_rdcc_ent_ptr_t));
+    rdcc->ndeleted = 0;
+
+    for (ent = rdcc->head; ent; ent = ent->next) {
+        assert(!ent->locked);
+        idx = H5D__chunk_hash_mix(dset->shared, ent->scaled);
+        while (rdcc->slot[idx])
+            if (++idx == rdcc->nslots)
+                idx = 0;
+        rdcc->slot[idx] = ent;
+        ent->idx        = idx;
+    } /* end for */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* H5D__chunk_cache_rehash() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5D__chunk_cache_link
+ *
+ * Purpose:     Adds an entry to the chunk cache list.  The list holds the
+ *              chunks in preemption order from its head.  With the 2Q
+ *              policy the chunks used only once come first, in the order
+ *              they were cached, followed from HOT_HEAD by the chunks used
+ *              again, least recently used first.  A new entry goes at the
+ *              end of its part of the list.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5D__chunk_cache_link(H5D_rdcc_t *rdcc, H5D_rdcc_ent_t *ent)
+{
+    H5D_rdcc_ent_t *next; /* Entry following the new one */
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    if (ent->hot) {
+        next = NULL;
+        rdcc->nhot++;
+    } /* end if */
+    else
+        next = rdcc->hot_head;
+
+    ent->next = next;
+    ent->prev = next ? next->prev : rdcc->tail;
+    if (ent->prev)
+        ent->prev->next = ent;
+    else
+        rdcc->head = ent;
+    if (next)
+        next->prev = ent;
+    else
+        rdcc->tail = ent;
+
+    if (ent->hot && !rdcc->hot_head)
+        rdcc->hot_head = ent;
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* H5D__chunk_cache_link() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5D__chunk_cache_unlink
+ *
+ * Purpose:     Removes an entry from the chunk cache list.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5D__chunk_cache_unlink(H5D_rdcc_t *rdcc, H5D_rdcc_ent_t *ent)
+{
+    FUNC_ENTER_PACKAGE_NOERR
+
+    if (ent == rdcc->hot_head)
+        rdcc->hot_head = ent->next;
+    if (ent->hot)
+        rdcc->nhot--;
+
+    if (ent->prev)
+        ent->prev->next = ent->next;
+    else
+        rdcc->head = ent->next;
+    if (ent->next)
+        ent->next->prev = ent->prev;
+    else
+        rdcc->tail = ent->prev;
+    ent->prev = ent->next = NULL;
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* H5D__chunk_cache_unlink() */
+
 /*-------------------------------------------------------------------------
  * Function:    H5D__chunk_lookup
  *
@@ -3765,6 +4359,7 @@ H5D__chunk_lookup(const H5D_t *dset, const hsize_t *scaled, H5D_chunk_ud_t *udat
     H5O_storage_chunk_t *sc    = &(dset->shared->layout.storage.u.chunk);
     unsigned             idx   = 0;     /* Index of chunk in cache, if present */
     bool                 found = false; /* In cache? */
+    htri_t               snap_found;    /* In chunk index snapshot? */
 #ifdef H5_HAVE_PARALLEL
     H5P_coll_md_read_flag_t md_reads_file_flag;
     bool                    md_reads_context_flag;
@@ -3793,26 +4388,11 @@ H5D__chunk_lookup(const H5D_t *dset, const hsize_t *scaled, H5D_chunk_ud_t *udat
     udata->new_unfilt_chunk   = false;
 
     /* Check for chunk in cache */
-    if (dset->shared->cache.chunk.nslots > 0) {
-        /* Determine the chunk's location in the hash table */
-        idx = H5D__chunk_hash_val(dset->shared, scaled);
-
-        /* Get the chunk cache entry for that location */
-        ent = dset->shared->cache.chunk.slot[idx];
-        if (ent) {
-            unsigned u; /* Counter */
-
-            /* Speculatively set the 'found' flag */
+    if (dset->shared->cache.chunk.nslots > 0)
+        if (UINT_MAX != (idx = H5D__chunk_cache_find(dset->shared, scaled))) {
+            ent   = dset->shared->cache.chunk.slot[idx];
             found = true;
-
-            /* Verify that the cache entry is the correct chunk */
-            for (u = 0; u < dset->shared->ndims; u++)
-                if (scaled[u] != ent->scaled[u]) {
-                    found = false;
-                    break;
-                } /* end if */
-        }         /* end if */
-    }             /* end if */
+        } /* end if */
 
     /* Retrieve chunk addr */
     if (found) {
@@ -3825,8 +4405,10 @@ H5D__chunk_lookup(const H5D_t *dset, const hsize_t *scaled, H5D_chunk_ud_t *udat
         /* Invalidate idx_hint, to signal that the chunk is not in cache */
         udata->idx_hint = UINT_MAX;
 
-        /* Check for cached information */
-        if (!H5D__chunk_cinfo_cache_found(&dset->shared->cache.chunk.last, udata)) {
+        /* Check for the chunk in the snapshot of the chunk index, then for cached information */
+        if ((snap_found = H5D__chunk_snap_found(dset, udata)) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't query chunk index snapshot");
+        if (!snap_found && !H5D__chunk_cinfo_cache_found(&dset->shared->cache.chunk.last, udata)) {
             H5D_chk_idx_info_t idx_info; /* Chunked index info */
 
             /* Compose chunked index info struct */
@@ -4141,15 +4723,7 @@ H5D__chunk_cache_evict(const H5D_t *dset, H5D_rdcc_ent_t *ent, bool flush)
     } /* end else */
 
     /* Unlink from list */
-    if (ent->prev)
-        ent->prev->next = ent->next;
-    else
-        rdcc->head = ent->next;
-    if (ent->next)
-        ent->next->prev = ent->prev;
-    else
-        rdcc->tail = ent->prev;
-    ent->prev = ent->next = NULL;
+    H5D__chunk_cache_unlink(rdcc, ent);
 
     /* Unlink from temporary list */
     if (ent->tmp_prev) {
@@ -4164,7 +4738,7 @@ H5D__chunk_cache_evict(const H5D_t *dset, H5D_rdcc_ent_t *ent, bool flush)
     else
         /* Only clear hash table slot if the chunk was not on the temporary list
          */
-        rdcc->slot[ent->idx] = NULL;
+        H5D__chunk_cache_clear_slot(rdcc, ent->idx);
 
     /* Remove from cache */
     assert(rdcc->slot[ent->idx] != ent);
@@ -4178,6 +4752,42 @@ H5D__chunk_cache_evict(const H5D_t *dset, H5D_rdcc_ent_t *ent, bool flush)
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5D__chunk_cache_evict() */
 
+/*-------------------------------------------------------------------------
+ * Function:    H5D__chunk_cache_preempt
+ *
+ * Purpose:     Flushes and evicts a chunk to make room in the cache.  A
+ *              chunk read ahead that is preempted before it was used shows
+ *              that the cache cannot hold the read-ahead window, which is
+ *              then halved; every chunk read ahead and used grows it back
+ *              by one.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__chunk_cache_preempt(const H5D_t *dset, H5D_rdcc_ent_t *ent)
+{
+    H5D_rdcc_t *rdcc      = &(dset->shared->cache.chunk); /* Raw data chunk cache */
+    herr_t      ret_value = SUCCEED;                      /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    /* Sanity checks */
+    assert(ent);
+    assert(!ent->locked);
+
+    if (ent->prefetched)
+        rdcc->pf_window = MAX(rdcc->pf_window / 2, 1);
+    rdcc->stats.nevictions++;
+
+    if (H5D__chunk_cache_evict(dset, ent, true) < 0)
+        HGOTO_ERROR(H5E_IO, H5E_CANTFLUSH, FAIL, "unable to preempt chunk from cache");
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__chunk_cache_preempt() */
+
 /*-------------------------------------------------------------------------
  * Function:    H5D__chunk_cache_prune
  *
@@ -4192,17 +4802,22 @@ H5D__chunk_cache_evict(const H5D_t *dset, H5D_rdcc_ent_t *ent, bool flush)
 static herr_t
 H5D__chunk_cache_prune(const H5D_t *dset, size_t size)
 {
-    const H5D_rdcc_t *rdcc  = &(dset->shared->cache.chunk);
-    size_t            total = rdcc->nbytes_max;
-    const int         nmeth = 2;           /* Number of methods */
-    int               w[1];                /* Weighting as an interval */
-    H5D_rdcc_ent_t   *p[2], *cur;          /* List pointers */
-    H5D_rdcc_ent_t   *n[2];                /* List next pointers */
-    int               nerrors   = 0;       /* Accumulated error count during preemptions */
-    herr_t            ret_value = SUCCEED; /* Return value */
+    H5D_rdcc_t     *rdcc  = &(dset->shared->cache.chunk);
+    const int       nmeth = 2;           /* Number of methods */
+    int             w[1];                /* Weighting as an interval */
+    H5D_rdcc_ent_t *p[2], *cur;          /* List pointers */
+    H5D_rdcc_ent_t *n[2];                /* List next pointers */
+    int             nerrors   = 0;       /* Accumulated error count during preemptions */
+    herr_t          ret_value = SUCCEED; /* Return value */
 
     FUNC_ENTER_PACKAGE
 
+    if (H5D_CHUNK_CACHE_POLICY_2Q == rdcc->policy) {
+        if (H5D__chunk_cache_prune_2q(dset, size) < 0)
+            HGOTO_ERROR(H5E_IO, H5E_CANTFLUSH, FAIL, "unable to preempt one or more raw data cache entry");
+        HGOTO_DONE(SUCCEED);
+    } /* end if */
+
     /*
      * Preemption is accomplished by having multiple pointers (currently two)
      * slide down the list beginning at the head. Pointer p(N+1) will start
@@ -4217,7 +4832,7 @@ H5D__chunk_cache_prune(const H5D_t *dset, size_t size)
     p[0] = rdcc->head;
     p[1] = NULL;
 
-    while ((p[0] || p[1]) && (rdcc->nbytes_used + size) > total) {
+    while ((p[0] || p[1]) && H5D_RDCC_FULL(rdcc, size)) {
         int i; /* Local index variable */
 
         /* Introduce new pointers */
@@ -4230,7 +4845,7 @@ H5D__chunk_cache_prune(const H5D_t *dset, size_t size)
             n[i] = p[i] ? p[i]->next : NULL;
 
         /* Give each method a chance */
-        for (i = 0; i < nmeth && (rdcc->nbytes_used + size) > total; i++) {
+        for (i = 0; i < nmeth && H5D_RDCC_FULL(rdcc, size); i++) {
             if (0 == i && p[0] && !p[0]->locked &&
                 ((0 == p[0]->rd_count && 0 == p[0]->wr_count) ||
                  (0 == p[0]->rd_count && dset->shared->layout.u.chunk.size == p[0]->wr_count) ||
@@ -4264,7 +4879,7 @@ H5D__chunk_cache_prune(const H5D_t *dset, size_t size)
                     if (n[j] == cur)
                         n[j] = cur->next;
                 } /* end for */
-                if (H5D__chunk_cache_evict(dset, cur, true) < 0)
+                if (H5D__chunk_cache_preempt(dset, cur) < 0)
                     nerrors++;
             } /* end if */
         }     /* end for */
@@ -4283,6 +4898,365 @@ done:
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5D__chunk_cache_prune() */
 
+/*-------------------------------------------------------------------------
+ * Function:    H5D__chunk_cache_prune_2q
+ *
+ * Purpose:     Prune the cache with the 2Q policy until the cache has room
+ *              for something which is SIZE bytes.  Chunks used only once
+ *              are preempted first in the order they were cached, as long
+ *              as they are more than a quarter of the cache; then the
+ *              least recently used of the chunks used again.  A chunk read
+ *              once by a scan therefore never pushes out the chunks that
+ *              are in repeated use.  Only unlocked entries are considered
+ *              for preemption.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__chunk_cache_prune_2q(const H5D_t *dset, size_t size)
+{
+    H5D_rdcc_t     *rdcc = &(dset->shared->cache.chunk); /* Raw data chunk cache */
+    H5D_rdcc_ent_t *cold, *hot;                          /* First unlocked entry of each part */
+    H5D_rdcc_ent_t *cur;                                 /* Entry to preempt */
+    int             nerrors   = 0;                       /* Accumulated error count during preemptions */
+    herr_t          ret_value = SUCCEED;                 /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    while (H5D_RDCC_FULL(rdcc, size)) {
+        for (cold = rdcc->head; cold && cold != rdcc->hot_head && cold->locked; cold = cold->next)
+            ;
+        if (cold == rdcc->hot_head)
+            cold = NULL;
+        for (hot = rdcc->hot_head; hot && hot->locked; hot = hot->next)
+            ;
+
+        if (cold && (!hot || 4 * ((size_t)rdcc->nused - rdcc->nhot) > (size_t)rdcc->nused))
+            cur = cold;
+        else if (hot)
+            cur = hot;
+        else
+            /* Everything is locked */
+            break;
+
+        if (H5D__chunk_cache_preempt(dset, cur) < 0)
+            nerrors++;
+    } /* end while */
+
+    if (nerrors)
+        HGOTO_ERROR(H5E_IO, H5E_CANTFLUSH, FAIL, "unable to preempt one or more raw data cache entry");
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__chunk_cache_prune_2q() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5D__chunk_cache_insert
+ *
+ * Purpose:     Adds a chunk that is not in the cache yet, preempting other
+ *              chunks to make room for it.  UDATA describes the chunk,
+ *              and its IDX_HINT is set to the slot given to the chunk.
+ *              On success the cache owns CHUNK.
+ *
+ * Return:      Non-negative on success/Negative on failure.  *ENTP is
+ *              the new cache entry, or NULL if the chunk cannot be cached,
+ *              in which case CHUNK still belongs to the caller.
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__chunk_cache_insert(const H5D_t *dset, H5D_chunk_ud_t *udata, size_t chunk_size, bool disable_filters,
+                        void *chunk, H5D_rdcc_ent_t **entp)
+{
+    H5D_rdcc_t     *rdcc      = &(dset->shared->cache.chunk); /* Raw data chunk cache */
+    H5D_rdcc_ent_t *ent       = NULL;                         /* Cache entry */
+    herr_t          ret_value = SUCCEED;                      /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    /* Sanity checks */
+    assert(udata);
+    assert(chunk);
+    assert(entp);
+
+    /* Nothing is cached without a cache, or if the chunk is larger than it */
+    if (rdcc->nslots > 0 && chunk_size <= rdcc->nbytes_max) {
+        bool have_slot; /* Whether a slot is free for the chunk */
+
+        if (H5D_CHUNK_CACHE_HASH_OPEN == rdcc->hash) {
+            unsigned home; /* First slot probed for the chunk */
+            size_t   u;    /* Local index variable */
+
+            /* Preempt enough things from the cache to make room, and get
+             * rid of the deleted slots when they slow down the probes */
+            if (H5D__chunk_cache_prune(dset, chunk_size) < 0)
+                HGOTO_ERROR(H5E_IO, H5E_CANTINIT, FAIL, "unable to preempt chunk(s) from cache");
+            if (H5D_RDCC_OPEN_REHASH(rdcc)) {
+                for (ent = rdcc->head; ent && !ent->locked; ent = ent->next)
+                    ;
+                if (!ent)
+                    H5D__chunk_cache_rehash(dset);
+            } /* end if */
+
+            /* Take the first free slot from the chunk's home slot */
+            home = udata->idx_hint = H5D__chunk_hash_mix(dset->shared, udata->common.scaled);
+            for (u = 0; u < rdcc->nslots; u++) {
+                if (!rdcc->slot[udata->idx_hint] || rdcc->slot[udata->idx_hint] == H5D_RDCC_DELETED)
+                    break;
+                if (++udata->idx_hint == rdcc->nslots)
+                    udata->idx_hint = 0;
+            } /* end for */
+            if (udata->idx_hint != home)
+                rdcc->stats.ncollisions++;
+
+            /* The table can only be full if no chunk could be preempted */
+            if (rdcc->slot[udata->idx_hint] == H5D_RDCC_DELETED) {
+                rdcc->slot[udata->idx_hint] = NULL;
+                rdcc->ndeleted--;
+            } /* end if */
+            have_slot = (NULL == rdcc->slot[udata->idx_hint]);
+        } /* end if */
+        else {
+            /* Calculate the index */
+            udata->idx_hint = H5D__chunk_hash_val(dset->shared, udata->common.scaled);
+
+            /* Add the chunk to the cache only if the slot is not already locked */
+            ent = rdcc->slot[udata->idx_hint];
+            if (ent)
+                rdcc->stats.ncollisions++;
+            have_slot = (!ent || !ent->locked);
+            if (have_slot) {
+                /* Preempt enough things from the cache to make room */
+                if (ent) {
+                    if (H5D__chunk_cache_preempt(dset, ent) < 0)
+                        HGOTO_ERROR(H5E_IO, H5E_CANTINIT, FAIL, "unable to preempt chunk from cache");
+                } /* end if */
+                if (H5D__chunk_cache_prune(dset, chunk_size) < 0)
+                    HGOTO_ERROR(H5E_IO, H5E_CANTINIT, FAIL, "unable to preempt chunk(s) from cache");
+            } /* end if */
+        }     /* end else */
+
+        /* Add the chunk to the cache only if a slot was found for it */
+        if (have_slot) {
+
+            /* Create a new entry */
+            if (NULL == (ent = H5FL_CALLOC(H5D_rdcc_ent_t)))
+                HGOTO_ERROR(H5E_DATASET, H5E_CANTALLOC, FAIL, "can't allocate raw data chunk entry");
+
+            ent->edge_chunk_state = disable_filters ? H5D_RDCC_DISABLE_FILTERS : 0;
+            if (udata->new_unfilt_chunk)
+                ent->edge_chunk_state |= H5D_RDCC_NEWLY_DISABLED_FILTERS;
+
+            /* Initialize the new entry */
+            ent->chunk_block.offset = udata->chunk_block.offset;
+            ent->chunk_block.length = udata->chunk_block.length;
+            ent->chunk_idx          = udata->chunk_idx;
+            H5MM_memcpy(ent->scaled, udata->common.scaled,
+                        sizeof(hsize_t) * dset->shared->layout.u.chunk.ndims);
+            H5_CHECKED_ASSIGN(ent->rd_count, uint32_t, chunk_size, size_t);
+            H5_CHECKED_ASSIGN(ent->wr_count, uint32_t, chunk_size, size_t);
+            ent->chunk = (uint8_t *)chunk;
+
+            /* Add it to the cache */
+            assert(NULL == rdcc->slot[udata->idx_hint]);
+            rdcc->slot[udata->idx_hint] = ent;
+            ent->idx                    = udata->idx_hint;
+            rdcc->nbytes_used += chunk_size;
+            rdcc->nused++;
+
+            /* Add it to the linked list */
+            H5D__chunk_cache_link(rdcc, ent);
+            ent->tmp_next = NULL;
+            ent->tmp_prev = NULL;
+
+        } /* end if */
+        else
+            /* We did not add the chunk to cache */
+            ent = NULL;
+    } /* end if */
+
+done:
+    *entp = (ret_value < 0 ? NULL : ent);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__chunk_cache_insert() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5D__chunk_prefetch
+ *
+ * Purpose:     Reads chunks ahead into the cache after the chunk at
+ *              SCALED was missed.  If the linear index of this chunk is
+ *              as far from the previous miss as that one was from the
+ *              miss before it, the next chunks along the same step that
+ *              are neither cached nor missing in the file are read with a
+ *              single vector read, run through the filter pipeline and
+ *              added unlocked to the cache.
+ *
+ *              A chunk the filters fail on is dropped: it is read again
+ *              and its error reported if it is accessed.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__chunk_prefetch(const H5D_t *dset, const hsize_t *scaled)
+{
+    H5D_rdcc_t         *rdcc      = &(dset->shared->cache.chunk);      /* Raw data chunk cache */
+    const H5O_layout_t *layout    = &(dset->shared->layout);           /* Dataset layout */
+    H5O_pline_t        *pline     = &(dset->shared->dcpl_cache.pline); /* I/O pipeline info */
+    unsigned            ndims     = dset->shared->ndims;               /* Rank of the dataset */
+    H5D_chunk_ud_t     *udata     = NULL;    /* Chunks to read */
+    hsize_t            *coords    = NULL;    /* Scaled coordinates of the chunks */
+    H5FD_mem_t         *types     = NULL;    /* Memory types of the vector read */
+    haddr_t            *addrs     = NULL;    /* Addresses of the chunks in the file */
+    size_t             *sizes     = NULL;    /* Sizes of the chunks in the file */
+    void              **bufs      = NULL;    /* Buffers of the chunks */
+    size_t              count     = 0;       /* Number of chunks to read */
+    size_t              chunk_size;          /* Size of a chunk in memory */
+    size_t              max_count;           /* Maximum number of chunks to read */
+    hsize_t             idx;                 /* Linear index of the chunk missed */
+    hsize_t             next;                /* Linear index of the next chunk */
+    bool                page_buf_enabled;    /* Whether the page buffer is enabled */
+    size_t              u;                   /* Local index variable */
+    herr_t              ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    /* Sanity checks */
+    assert(rdcc->prefetch > 0);
+    assert(pline->nused > 0);
+    assert(scaled);
+
+    /* Read ahead only once two misses in a row were the same step apart */
+    idx = H5VM_array_offset_pre(ndims, layout->u.chunk.down_chunks, scaled);
+    if (HSIZE_UNDEF == rdcc->pf_last || idx <= rdcc->pf_last || idx - rdcc->pf_last != rdcc->pf_stride) {
+        rdcc->pf_stride = (HSIZE_UNDEF != rdcc->pf_last && idx > rdcc->pf_last) ? idx - rdcc->pf_last : 1;
+        rdcc->pf_last   = idx;
+        HGOTO_DONE(SUCCEED);
+    } /* end if */
+    rdcc->pf_last = idx;
+
+    /* Leave room in the cache for the chunk being read */
+    chunk_size = layout->u.chunk.size;
+    if (0 == rdcc->nslots || 0 == chunk_size || rdcc->nbytes_max / chunk_size < 2)
+        HGOTO_DONE(SUCCEED);
+    max_count = MIN3(rdcc->pf_window, rdcc->nbytes_max / chunk_size - 1, rdcc->nslots - 1);
+    if (0 == max_count)
+        HGOTO_DONE(SUCCEED);
+
+    /* Allocate the read arrays */
+    if (NULL == (udata = (H5D_chunk_ud_t *)H5MM_malloc(max_count * sizeof(H5D_chunk_ud_t))) ||
+        NULL == (coords = (hsize_t *)H5MM_malloc(max_count * H5O_LAYOUT_NDIMS * sizeof(hsize_t))) ||
+        NULL == (types = (H5FD_mem_t *)H5MM_malloc(max_count * sizeof(H5FD_mem_t))) ||
+        NULL == (addrs = (haddr_t *)H5MM_malloc(max_count * sizeof(haddr_t))) ||
+        NULL == (sizes = (size_t *)H5MM_malloc(max_count * sizeof(size_t))) ||
+        NULL == (bufs = (void **)H5MM_calloc(max_count * sizeof(void *))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTALLOC, FAIL, "memory allocation failed for chunk read-ahead");
+
+    /* Look up the next chunks along the step */
+    for (u = 0, next = idx + rdcc->pf_stride; u < max_count && next < layout->u.chunk.nchunks;
+         u++, next += rdcc->pf_stride) {
+        hsize_t *chunk_coords = coords + count * H5O_LAYOUT_NDIMS;
+
+        rdcc->pf_last = next;
+
+        if (H5VM_array_calc_pre(next, ndims, layout->u.chunk.down_chunks, chunk_coords) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't compute chunk coordinates");
+        chunk_coords[ndims] = 0;
+        if (H5D__chunk_lookup(dset, chunk_coords, &udata[count]) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "error looking up chunk address");
+
+        /* Skip the chunks already cached or not in the file, and the edge
+         * chunks that are stored without filters */
+        if (UINT_MAX != udata[count].idx_hint || !H5_addr_defined(udata[count].chunk_block.offset))
+            continue;
+        if ((layout->u.chunk.flags & H5O_LAYOUT_CHUNK_DONT_FILTER_PARTIAL_BOUND_CHUNKS) &&
+            H5D__chunk_is_partial_edge_chunk(ndims, layout->u.chunk.dim, chunk_coords,
+                                             dset->shared->curr_dims))
+            continue;
+
+        types[count] = H5FD_MEM_DRAW;
+        addrs[count] = udata[count].chunk_block.offset;
+        H5_CHECKED_ASSIGN(sizes[count], size_t, udata[count].chunk_block.length, hsize_t);
+        if (NULL == (bufs[count] = H5D__chunk_mem_alloc(sizes[count], pline)))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for raw data chunk");
+        count++;
+    } /* end for */
+    if (0 == count)
+        HGOTO_DONE(SUCCEED);
+
+    /* Read the chunks, through the page buffer if it holds raw data */
+    if (H5PB_enabled(H5F_SHARED(dset->oloc.file), H5FD_MEM_DRAW, &page_buf_enabled) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't check if page buffer is enabled");
+    if (page_buf_enabled) {
+        for (u = 0; u < count; u++)
+            if (H5F_shared_block_read(H5F_SHARED(dset->oloc.file), H5FD_MEM_DRAW, addrs[u], sizes[u],
+                                      bufs[u]) < 0)
+                HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "unable to read raw data chunk");
+    } /* end if */
+    else {
+        H5_CHECK_OVERFLOW(count, size_t, uint32_t);
+        if (H5F_shared_vector_read(H5F_SHARED(dset->oloc.file), (uint32_t)count, types, addrs, sizes,
+                                   bufs) < 0)
+            HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "unable to read raw data chunks");
+    } /* end else */
+
+    /* Decode the chunks and add them to the cache */
+    {
+        H5Z_EDC_t err_detect; /* Error detection info */
+        H5Z_cb_t  filter_cb;  /* I/O filter callback function */
+
+        /* Retrieve filter settings from API context */
+        if (H5CX_get_err_detect(&err_detect) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get error detection info");
+        if (H5CX_get_filter_cb(&filter_cb) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get I/O filter callback function");
+
+        for (u = 0; u < count; u++) {
+            H5D_rdcc_ent_t *ent;                  /* Cache entry of the chunk */
+            size_t          nbytes    = sizes[u]; /* Size of the chunk data */
+            size_t          buf_alloc = sizes[u]; /* Size of the chunk buffer */
+            herr_t          status;               /* Status of the decoding */
+
+            /* A chunk that can't be decoded is skipped, and reported when it is read */
+            H5E_PAUSE_ERRORS
+            {
+                status = H5Z_pipeline(pline, H5Z_FLAG_REVERSE, &(udata[u].filter_mask), err_detect, filter_cb,
+                                      &nbytes, &buf_alloc, &bufs[u]);
+            }
+            H5E_RESUME_ERRORS
+            if (status < 0)
+                continue;
+
+            if (H5D__chunk_cache_insert(dset, &udata[u], chunk_size, false, bufs[u], &ent) < 0)
+                HGOTO_ERROR(H5E_IO, H5E_CANTINIT, FAIL, "unable to add chunk to cache");
+            if (ent) {
+                ent->prefetched = true;
+                bufs[u]         = NULL;
+                rdcc->stats.nprefetches++;
+            } /* end if */
+        } /* end for */
+    }
+
+done:
+    /* Release the chunks not given to the cache */
+    if (bufs)
+        for (u = 0; u < count; u++)
+            if (bufs[u])
+                bufs[u] = H5D__chunk_mem_xfree(bufs[u], pline);
+    H5MM_xfree(bufs);
+    H5MM_xfree(sizes);
+    H5MM_xfree(addrs);
+    H5MM_xfree(types);
+    H5MM_xfree(coords);
+    H5MM_xfree(udata);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__chunk_prefetch() */
+
 /*-------------------------------------------------------------------------
  * Function:    H5D__chunk_lock
  *
@@ -4432,12 +5406,30 @@ H5D__chunk_lock(const H5D_io_info_t H5_ATTR_NDEBUG_UNUSED *io_info, const H5D_ds
             } /* end else */
         }     /* end if */
 
+        /*
+         * A chunk read ahead is only used for the first time now, so it stays
+         * where it is.
+         */
+        if (ent->prefetched) {
+            ent->prefetched = false;
+            if (rdcc->pf_window < rdcc->prefetch)
+                rdcc->pf_window++;
+        } /* end if */
+        /*
+         * With the 2Q policy the chunk is now in repeated use, so it moves to
+         * the end of the list of such chunks.
+         */
+        else if (H5D_CHUNK_CACHE_POLICY_2Q == rdcc->policy) {
+            H5D__chunk_cache_unlink(rdcc, ent);
+            ent->hot = true;
+            H5D__chunk_cache_link(rdcc, ent);
+        } /* end if */
         /*
          * If the chunk is not at the beginning of the cache; move it backward
          * by one slot.  This is how we implement the LRU preemption
          * algorithm.
          */
-        if (ent->next) {
+        else if (ent->next) {
             if (ent->next->next)
                 ent->next->next->prev = ent;
             else
@@ -4604,63 +5596,8 @@ H5D__chunk_lock(const H5D_io_info_t H5_ATTR_NDEBUG_UNUSED *io_info, const H5D_ds
         }     /* end else */
 
         /* See if the chunk can be cached */
-        if (rdcc->nslots > 0 && chunk_size <= rdcc->nbytes_max) {
-            /* Calculate the index */
-            udata->idx_hint = H5D__chunk_hash_val(dset->shared, udata->common.scaled);
-
-            /* Add the chunk to the cache only if the slot is not already locked */
-            ent = rdcc->slot[udata->idx_hint];
-            if (!ent || !ent->locked) {
-                /* Preempt enough things from the cache to make room */
-                if (ent) {
-                    if (H5D__chunk_cache_evict(dset, ent, true) < 0)
-                        HGOTO_ERROR(H5E_IO, H5E_CANTINIT, NULL, "unable to preempt chunk from cache");
-                } /* end if */
-                if (H5D__chunk_cache_prune(dset, chunk_size) < 0)
-                    HGOTO_ERROR(H5E_IO, H5E_CANTINIT, NULL, "unable to preempt chunk(s) from cache");
-
-                /* Create a new entry */
-                if (NULL == (ent = H5FL_CALLOC(H5D_rdcc_ent_t)))
-                    HGOTO_ERROR(H5E_DATASET, H5E_CANTALLOC, NULL, "can't allocate raw data chunk entry");
-
-                ent->edge_chunk_state = disable_filters ? H5D_RDCC_DISABLE_FILTERS : 0;
-                if (udata->new_unfilt_chunk)
-                    ent->edge_chunk_state |= H5D_RDCC_NEWLY_DISABLED_FILTERS;
-
-                /* Initialize the new entry */
-                ent->chunk_block.offset = chunk_addr;
-                ent->chunk_block.length = chunk_alloc;
-                ent->chunk_idx          = udata->chunk_idx;
-                H5MM_memcpy(ent->scaled, udata->common.scaled, sizeof(hsize_t) * layout->u.chunk.ndims);
-                H5_CHECKED_ASSIGN(ent->rd_count, uint32_t, chunk_size, size_t);
-                H5_CHECKED_ASSIGN(ent->wr_count, uint32_t, chunk_size, size_t);
-                ent->chunk = (uint8_t *)chunk;
-
-                /* Add it to the cache */
-                assert(NULL == rdcc->slot[udata->idx_hint]);
-                rdcc->slot[udata->idx_hint] = ent;
-                ent->idx                    = udata->idx_hint;
-                rdcc->nbytes_used += chunk_size;
-                rdcc->nused++;
-
-                /* Add it to the linked list */
-                if (rdcc->tail) {
-                    rdcc->tail->next = ent;
-                    ent->prev        = rdcc->tail;
-                    rdcc->tail       = ent;
-                } /* end if */
-                else
-                    rdcc->head = rdcc->tail = ent;
-                ent->tmp_next = NULL;
-                ent->tmp_prev = NULL;
-
-            } /* end if */
-            else
-                /* We did not add the chunk to cache */
-                ent = NULL;
-        }    /* end else */
-        else /* No cache set up, or chunk is too large: chunk is uncacheable */
-            ent = NULL;
+        if (H5D__chunk_cache_insert(dset, udata, chunk_size, disable_filters, chunk, &ent) < 0)
+            HGOTO_ERROR(H5E_IO, H5E_CANTINIT, NULL, "unable to add chunk to cache");
     } /* end else */
 
     /* Lock the chunk into the cache */
@@ -6469,6 +7406,10 @@ H5D__chunk_update_cache(H5D_t *dset)
     /* Check the rank */
     assert((dset->shared->layout.u.chunk.ndims - 1) > 1);
 
+    /* The slots of an open hash table do not depend on the dataspace size */
+    if (H5D_CHUNK_CACHE_HASH_OPEN == rdcc->hash)
+        HGOTO_DONE(SUCCEED);
+
     /* Add temporary entry list to rdcc */
     (void)memset(&tmp_head, 0, sizeof(tmp_head));
     rdcc->tmp_head = &tmp_head;
@@ -6643,28 +7584,14 @@ H5D__chunk_copy_cb(const H5D_chunk_rec_t *chunk_rec, void *_udata)
     else {
         H5D_rdcc_ent_t *ent = NULL; /* Cache entry */
         unsigned        idx;        /* Index of chunk in cache, if present */
-        unsigned        u;          /* Counter */
         H5D_shared_t   *shared_fo = (H5D_shared_t *)udata->cpy_info->shared_fo;
 
         /* See if the written chunk is in the chunk cache */
-        if (shared_fo && shared_fo->cache.chunk.nslots > 0) {
-            /* Determine the chunk's location in the hash table */
-            idx = H5D__chunk_hash_val(shared_fo, chunk_rec->scaled);
-
-            /* Get the chunk cache entry for that location */
-            ent = shared_fo->cache.chunk.slot[idx];
-            if (ent) {
-                /* Speculatively set the 'found' flag */
+        if (shared_fo && shared_fo->cache.chunk.nslots > 0)
+            if (UINT_MAX != (idx = H5D__chunk_cache_find(shared_fo, chunk_rec->scaled))) {
+                ent                   = shared_fo->cache.chunk.slot[idx];
                 udata->chunk_in_cache = true;
-
-                /* Verify that the cache entry is the correct chunk */
-                for (u = 0; u < shared_fo->ndims; u++)
-                    if (chunk_rec->scaled[u] != ent->scaled[u]) {
-                        udata->chunk_in_cache = false;
-                        break;
-                    } /* end if */
-            }         /* end if */
-        }             /* end if */
+            } /* end if */
 
         if (udata->chunk_in_cache) {
 
@@ -7621,14 +8548,21 @@ H5D__chunk_format_convert_cb(const H5D_chunk_rec_t *chunk_rec, void *_udata)
     } /* end if */
 
     /* Set up chunk information for insertion to chunk index */
+    insert_udata.common.scaled  = chunk_rec->scaled;
+    insert_udata.common.layout  = new_idx_info->layout;
+    insert_udata.common.storage = new_idx_info->storage;
+
+    /* Look the chunk up in the new index, which sets the index-specific
+     * location of its record (e.g. the element of a fixed or extensible array) */
+    if (new_idx_info->storage->idx_type != H5D_CHUNK_IDX_BTREE &&
+        (new_idx_info->storage->ops->get_addr)(new_idx_info, &insert_udata) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, H5_ITER_ERROR, "can't query chunk address");
+
     insert_udata.chunk_block.offset = chunk_addr;
     insert_udata.chunk_block.length = nbytes;
     insert_udata.filter_mask        = chunk_rec->filter_mask;
-    insert_udata.common.scaled      = chunk_rec->scaled;
-    insert_udata.common.layout      = new_idx_info->layout;
-    insert_udata.common.storage     = new_idx_info->storage;
 
-    /* Insert chunk into the v1 B-tree chunk index */
+    /* Insert chunk into the new chunk index */
     if ((new_idx_info->storage->ops->insert)(new_idx_info, &insert_udata, NULL) < 0)
         HGOTO_ERROR(H5E_DATASET, H5E_CANTINSERT, H5_ITER_ERROR, "unable to insert chunk addr into index");
 
@@ -7643,7 +8577,7 @@ done:
  * Function:    H5D__chunk_format_convert
  *
  * Purpose:     Iterate over the chunks for the current chunk index and insert the
- *        the chunk addresses into v1 B-tree chunk index via callback.
+ *        the chunk addresses into the new chunk index via callback.
  *
  * Return:      Non-negative on success/Negative on failure
  *
@@ -7652,14 +8586,25 @@ done:
 herr_t
 H5D__chunk_format_convert(H5D_t *dset, H5D_chk_idx_info_t *idx_info, H5D_chk_idx_info_t *new_idx_info)
 {
-    H5D_chunk_it_ud5_t udata;               /* User data */
-    herr_t             ret_value = SUCCEED; /* Return value */
+    H5D_rdcc_t        *rdcc = &(dset->shared->cache.chunk); /* Dataset's chunk cache */
+    H5D_rdcc_ent_t    *ent, *next;                          /* Pointer to current & next cache entries */
+    H5D_chunk_it_ud5_t udata;                               /* User data */
+    herr_t             ret_value = SUCCEED;                 /* Return value */
 
     FUNC_ENTER_PACKAGE
 
     /* Check args */
     assert(dset);
 
+    /* Write the cached chunks to the current index and drop them, since the
+     * index information they keep does not apply to the new index */
+    for (ent = rdcc->head; ent; ent = next) {
+        next = ent->next;
+        if (H5D__chunk_cache_evict(dset, ent, true) < 0)
+            HGOTO_ERROR(H5E_IO, H5E_CANTFLUSH, FAIL, "unable to flush one or more raw data chunks");
+    } /* end for */
+    H5D__chunk_cinfo_cache_reset(&(rdcc->last));
+
     /* Set up user data */
     udata.new_idx_info = new_idx_info;
     udata.dset_ndims   = dset->shared->ndims;
@@ -8207,6 +9152,45 @@ done:
     FUNC_LEAVE_NOAPI_TAG(ret_value)
 } /* end H5D__chunk_iter() */
 
+/*-------------------------------------------------------------------------
+ * Function:    H5D__get_chunk_cache_stats
+ *
+ * Purpose:     Retrieves the counters of the dataset's raw data chunk cache
+ *
+ * Return:      SUCCEED/FAIL
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5D__get_chunk_cache_stats(const H5D_t *dset, H5D_chunk_cache_stats_t *stats)
+{
+    const H5D_rdcc_t *rdcc;                /* Raw data chunk cache */
+    herr_t            ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    /* Check args */
+    assert(dset);
+    assert(dset->shared);
+    assert(stats);
+
+    if (H5D_CHUNKED != dset->shared->layout.type)
+        HGOTO_ERROR(H5E_DATASET, H5E_BADTYPE, FAIL, "not a chunked dataset");
+
+    rdcc               = &(dset->shared->cache.chunk);
+    stats->nhits       = rdcc->stats.nhits;
+    stats->nmisses     = rdcc->stats.nmisses;
+    stats->ninits      = rdcc->stats.ninits;
+    stats->nflushes    = rdcc->stats.nflushes;
+    stats->ncollisions = rdcc->stats.ncollisions;
+    stats->nevictions  = rdcc->stats.nevictions;
+    stats->nprefetches = rdcc->stats.nprefetches;
+    stats->nused       = (size_t)rdcc->nused;
+    stats->nbytes_used = rdcc->nbytes_used;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__get_chunk_cache_stats() */
+
 /*-------------------------------------------------------------------------
  * Function:    H5D__chunk_get_offset_copy
  *
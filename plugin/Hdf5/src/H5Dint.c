@@ -3435,6 +3435,149 @@ done:
     FUNC_LEAVE_NOAPI_TAG(ret_value)
 } /* end H5D__format_convert() */
 
+/*-------------------------------------------------------------------------
+ * Function: H5D__format_upgrade
+ *
+ * Purpose:  For chunked: upgrade the chunk indexing type from version 1
+ *           B-tree to the latest indexing type, as H5D__format_convert
+ *           does in the other direction
+ *
+ * Return:   Success:    Non-negative
+ *           Failure:    Negative
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5D__format_upgrade(H5D_t *dataset)
+{
+    H5D_chk_idx_info_t new_idx_info;                /* Index info for the new layout */
+    H5D_chk_idx_info_t idx_info;                    /* Index info for the current layout */
+    H5O_layout_t      *newlayout         = NULL;    /* The new layout */
+    bool               init_new_index    = false;   /* Indicate that the new chunk index is initialized */
+    bool               delete_old_layout = false;   /* Indicate that the old layout message is deleted */
+    bool               add_new_layout    = false;   /* Indicate that the new layout message is added */
+    herr_t             ret_value         = SUCCEED; /* Return value */
+
+    FUNC_ENTER_PACKAGE_TAG(dataset->oloc.addr)
+
+    /* Check args */
+    assert(dataset);
+    assert(dataset->shared->layout.type == H5D_CHUNKED);
+    assert(dataset->shared->layout.u.chunk.idx_type == H5D_CHUNK_IDX_BTREE);
+
+    /* Check if we are allowed to modify this file */
+    if (0 == (H5F_INTENT(dataset->oloc.file) & H5F_ACC_RDWR))
+        HGOTO_ERROR(H5E_DATASET, H5E_WRITEERROR, FAIL, "no write intent on file");
+
+    if (NULL == (newlayout = (H5O_layout_t *)H5MM_calloc(sizeof(H5O_layout_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to allocate buffer");
+
+    /* Set up the current index info */
+    idx_info.f       = dataset->oloc.file;
+    idx_info.pline   = &dataset->shared->dcpl_cache.pline;
+    idx_info.layout  = &dataset->shared->layout.u.chunk;
+    idx_info.storage = &dataset->shared->layout.storage.u.chunk;
+
+    /* Copy the current layout info to the new layout */
+    H5MM_memcpy(newlayout, &dataset->shared->layout, sizeof(H5O_layout_t));
+
+    /* Set up the latest indexing type in the new layout, if the file's format bounds allow it */
+    newlayout->version = H5O_LAYOUT_VERSION_4;
+    if (H5D__layout_set_version(dataset->oloc.file, newlayout) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTSET, FAIL, "can't set latest version of layout");
+    if (H5D__layout_set_latest_indexing(newlayout, dataset->shared->space, &dataset->shared->dcpl_cache) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTSET, FAIL, "can't set latest indexing");
+
+    /* The implicit index expects the chunks in consecutive order, which
+     * existing chunks are not, so use a fixed array instead */
+    if (newlayout->u.chunk.idx_type == H5D_CHUNK_IDX_NONE) {
+        newlayout->u.chunk.idx_type         = H5D_CHUNK_IDX_FARRAY;
+        newlayout->storage.u.chunk.idx_type = H5D_CHUNK_IDX_FARRAY;
+        newlayout->storage.u.chunk.ops      = H5D_COPS_FARRAY;
+
+        newlayout->u.chunk.u.farray.cparam.max_dblk_page_nelmts_bits = H5D_FARRAY_MAX_DBLK_PAGE_NELMTS_BITS;
+    } /* end if */
+    assert(newlayout->u.chunk.idx_type != H5D_CHUNK_IDX_BTREE);
+    newlayout->storage.u.chunk.idx_addr = HADDR_UNDEF;
+    memset(&newlayout->storage.u.chunk.u, 0, sizeof(newlayout->storage.u.chunk.u));
+
+    /* Set up the index info to the new index */
+    new_idx_info.f       = dataset->oloc.file;
+    new_idx_info.pline   = &dataset->shared->dcpl_cache.pline;
+    new_idx_info.layout  = &(newlayout->u).chunk;
+    new_idx_info.storage = &(newlayout->storage).u.chunk;
+
+    /* Initialize the new index */
+    if (new_idx_info.storage->ops->init &&
+        (new_idx_info.storage->ops->init)(&new_idx_info, dataset->shared->space, dataset->oloc.addr) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTINIT, FAIL, "can't initialize indexing information");
+    init_new_index = true;
+
+    /* Set up the index's own chunk information (e.g., the swizzled dimensions of an
+     * extensible array), as H5D__chunk_set_info() does when the dataset is opened.
+     * The base chunk information is the same as the current layout's */
+    if (new_idx_info.storage->ops->resize && (new_idx_info.storage->ops->resize)(new_idx_info.layout) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTSET, FAIL, "unable to resize chunk index information");
+
+    /* If the current chunk index exists */
+    if (H5_addr_defined(idx_info.storage->idx_addr)) {
+
+        /* Create the new chunk index */
+        if ((new_idx_info.storage->ops->create)(&new_idx_info) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTINIT, FAIL, "can't create chunk index");
+
+        /* Iterate over the chunks in the current index and insert the chunk addresses
+         * into the new chunk index
+         */
+        if (H5D__chunk_format_convert(dataset, &idx_info, &new_idx_info) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_BADITER, FAIL, "unable to iterate/convert chunk index");
+    } /* end if */
+
+    /* Delete the old "current" layout message */
+    if (H5O_msg_remove(&dataset->oloc, H5O_LAYOUT_ID, H5O_ALL, false) < 0)
+        HGOTO_ERROR(H5E_SYM, H5E_CANTDELETE, FAIL, "unable to delete layout message");
+
+    delete_old_layout = true;
+
+    /* Append the new layout message to the object header */
+    if (H5O_msg_create(&dataset->oloc, H5O_LAYOUT_ID, 0, H5O_UPDATE_TIME, newlayout) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTINIT, FAIL, "unable to update layout header message");
+
+    add_new_layout = true;
+
+    /* Release the old (current) chunk index */
+    /* (The v1 B-tree nodes are left in the file: deleting the B-tree would
+     *  also free the chunks, which the new index now refers to) */
+    if (idx_info.storage->ops->dest && (idx_info.storage->ops->dest)(&idx_info) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTFREE, FAIL, "unable to release chunk index info");
+
+    /* Copy the new layout to the dataset's layout */
+    H5MM_memcpy(&dataset->shared->layout, newlayout, sizeof(H5O_layout_t));
+
+done:
+    if (ret_value < 0) {
+        /* Remove new layout message */
+        if (add_new_layout)
+            if (H5O_msg_remove(&dataset->oloc, H5O_LAYOUT_ID, H5O_ALL, false) < 0)
+                HDONE_ERROR(H5E_SYM, H5E_CANTDELETE, FAIL, "unable to delete layout message");
+
+        /* Add back old layout message */
+        if (delete_old_layout)
+            if (H5O_msg_create(&dataset->oloc, H5O_LAYOUT_ID, 0, H5O_UPDATE_TIME, &dataset->shared->layout) <
+                0)
+                HDONE_ERROR(H5E_DATASET, H5E_CANTINIT, FAIL, "unable to add layout header message");
+
+        /* Close the new chunk index, whose space is not reclaimed */
+        if (init_new_index)
+            if (new_idx_info.storage->ops->dest && (new_idx_info.storage->ops->dest)(&new_idx_info) < 0)
+                HDONE_ERROR(H5E_DATASET, H5E_CANTFREE, FAIL, "unable to release chunk index info");
+    } /* end if */
+
+    if (newlayout != NULL)
+        newlayout = (H5O_layout_t *)H5MM_xfree(newlayout);
+
+    FUNC_LEAVE_NOAPI_TAG(ret_value)
+} /* end H5D__format_upgrade() */
+
 /*-------------------------------------------------------------------------
  * Function: H5D__mark
  *
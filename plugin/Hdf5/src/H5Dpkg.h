@@ -488,16 +488,30 @@ typedef struct H5D_virtual_held_file_t {
 struct H5D_rdcc_ent_t; /* Forward declaration of struct used below */
 typedef struct H5D_rdcc_t {
     struct {
-        unsigned ninits;   /* Number of chunk creations        */
-        unsigned nhits;    /* Number of cache hits            */
-        unsigned nmisses;  /* Number of cache misses        */
-        unsigned nflushes; /* Number of cache flushes        */
+        unsigned ninits;      /* Number of chunk creations        */
+        unsigned nhits;       /* Number of cache hits            */
+        unsigned nmisses;     /* Number of cache misses        */
+        unsigned nflushes;    /* Number of cache flushes        */
+        unsigned ncollisions; /* Number of chunks not placed in their first slot */
+        unsigned nevictions;  /* Number of chunks preempted */
+        unsigned nprefetches; /* Number of chunks read ahead */
     } stats;
-    size_t                 nbytes_max; /* Maximum cached raw data in bytes    */
-    size_t                 nslots;     /* Number of chunk slots allocated    */
-    double                 w0;         /* Chunk preemption policy          */
-    struct H5D_rdcc_ent_t *head;       /* Head of doubly linked list        */
-    struct H5D_rdcc_ent_t *tail;       /* Tail of doubly linked list        */
+    size_t                   nbytes_max; /* Maximum cached raw data in bytes    */
+    size_t                   nslots;     /* Number of chunk slots allocated    */
+    double                   w0;         /* Chunk preemption policy          */
+    H5D_chunk_cache_hash_t   hash;       /* Slot lookup of the cache */
+    H5D_chunk_cache_policy_t policy;     /* Preemption policy of the cache */
+    size_t                   ndeleted;   /* Number of deleted slots (open hash only) */
+    size_t                   nhot;       /* Number of chunks used more than once (2Q only) */
+    struct H5D_rdcc_ent_t   *hot_head;   /* First chunk used more than once (2Q only) */
+    bool                     use_snap;   /* Whether lookups may use a snapshot of the chunk index */
+    struct H5D_chunk_snap_t *snap;       /* Snapshot of the chunk index, once loaded */
+    unsigned                 prefetch;   /* Number of chunks read ahead (0 disables) */
+    unsigned                 pf_window;  /* Number of chunks read ahead, shrunk on thrashing */
+    hsize_t                  pf_last;    /* Linear index of the last chunk missed or read ahead */
+    hsize_t                  pf_stride;  /* Step between the last two chunks missed */
+    struct H5D_rdcc_ent_t   *head;       /* Head of doubly linked list        */
+    struct H5D_rdcc_ent_t   *tail;       /* Tail of doubly linked list        */
     struct H5D_rdcc_ent_t
         *tmp_head; /* Head of temporary doubly linked list.  Chunks on this list are not in the hash table
                       (slot).  The head entry is a sentinel (does not refer to an actual chunk). */
@@ -657,6 +671,7 @@ H5_DLL herr_t  H5D__get_chunk_info(const H5D_t *dset, const H5S_t *space, hsize_
 H5_DLL herr_t  H5D__get_chunk_info_by_coord(const H5D_t *dset, const hsize_t *coord, unsigned *filter_mask,
                                             haddr_t *addr, hsize_t *size);
 H5_DLL herr_t  H5D__chunk_iter(H5D_t *dset, H5D_chunk_iter_op_t cb, void *op_data);
+H5_DLL herr_t  H5D__get_chunk_cache_stats(const H5D_t *dset, H5D_chunk_cache_stats_t *stats);
 H5_DLL haddr_t H5D__get_offset(const H5D_t *dset);
 H5_DLL herr_t  H5D__vlen_get_buf_size(H5D_t *dset, hid_t type_id, hid_t space_id, hsize_t *size);
 H5_DLL herr_t  H5D__vlen_get_buf_size_gen(H5VL_object_t *vol_obj, hid_t type_id, hid_t space_id,
@@ -670,6 +685,7 @@ H5_DLL herr_t  H5D__refresh(H5D_t *dataset, hid_t dset_id);
 
 /* To convert a dataset's chunk indexing type to v1 B-tree */
 H5_DLL herr_t H5D__format_convert(H5D_t *dataset);
+H5_DLL herr_t H5D__format_upgrade(H5D_t *dataset);
 
 /* Internal I/O routines */
 H5_DLL herr_t H5D__read(size_t count, H5D_dset_io_info_t *dset_info);
@@ -49,6 +49,10 @@
 #define H5D_ACS_DATA_CACHE_NUM_SLOTS_NAME "rdcc_nslots"          /* Size of raw data chunk cache(slots) */
 #define H5D_ACS_DATA_CACHE_BYTE_SIZE_NAME "rdcc_nbytes"          /* Size of raw data chunk cache(bytes) */
 #define H5D_ACS_PREEMPT_READ_CHUNKS_NAME  "rdcc_w0"              /* Preemption read chunks first */
+#define H5D_ACS_DATA_CACHE_HASH_NAME      "rdcc_hash"            /* Slot lookup of chunk cache */
+#define H5D_ACS_DATA_CACHE_POLICY_NAME    "rdcc_policy"          /* Preemption policy of chunk cache */
+#define H5D_ACS_CHUNK_IDX_SNAPSHOT_NAME   "chunk_idx_snapshot"   /* Snapshot of the chunk index */
+#define H5D_ACS_DATA_CACHE_PREFETCH_NAME  "rdcc_prefetch"        /* Read-ahead of chunk cache(chunks) */
 #define H5D_ACS_VDS_VIEW_NAME             "vds_view"             /* VDS view option */
 #define H5D_ACS_VDS_PRINTF_GAP_NAME       "vds_printf_gap"       /* VDS printf gap size */
 #define H5D_ACS_VDS_PREFIX_NAME           "vds_prefix"           /* VDS file prefix */
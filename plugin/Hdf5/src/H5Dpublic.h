@@ -126,6 +126,43 @@ typedef enum H5D_vds_view_t {
 } H5D_vds_view_t;
 //! <!-- [H5D_vds_view_t_snip] -->
 
+//! <!-- [H5D_chunk_cache_hash_t_snip] -->
+/**
+ * Values for the slot lookup of the raw data chunk cache
+ */
+typedef enum H5D_chunk_cache_hash_t {
+    H5D_CHUNK_CACHE_HASH_DIRECT = 0, /**< One slot per chunk, picked from the chunk coordinates (default) */
+    H5D_CHUNK_CACHE_HASH_OPEN   = 1  /**< Mixed hash of the chunk coordinates with linear probing */
+} H5D_chunk_cache_hash_t;
+//! <!-- [H5D_chunk_cache_hash_t_snip] -->
+
+//! <!-- [H5D_chunk_cache_policy_t_snip] -->
+/**
+ * Values for the replacement policy of the raw data chunk cache
+ */
+typedef enum H5D_chunk_cache_policy_t {
+    H5D_CHUNK_CACHE_POLICY_W0 = 0, /**< LRU, fully read or written chunks first by \p rdcc_w0 (default) */
+    H5D_CHUNK_CACHE_POLICY_2Q = 1  /**< Scan resistant: chunks used once are preempted first */
+} H5D_chunk_cache_policy_t;
+//! <!-- [H5D_chunk_cache_policy_t_snip] -->
+
+//! <!-- [H5D_chunk_cache_stats_t_snip] -->
+/**
+ * Counters of the raw data chunk cache of a dataset
+ */
+typedef struct H5D_chunk_cache_stats_t {
+    unsigned nhits;       /**< Chunks found in the cache */
+    unsigned nmisses;     /**< Chunks read from the file */
+    unsigned ninits;      /**< Chunks created in the cache without reading */
+    unsigned nflushes;    /**< Chunks written to the file */
+    unsigned ncollisions; /**< Chunks that could not get their first slot */
+    unsigned nevictions;  /**< Chunks preempted from the cache */
+    unsigned nprefetches; /**< Chunks read ahead into the cache */
+    size_t   nused;       /**< Chunks currently in the cache */
+    size_t   nbytes_used; /**< Bytes currently held by the cache */
+} H5D_chunk_cache_stats_t;
+//! <!-- [H5D_chunk_cache_stats_t_snip] -->
+
 //! <!-- [H5D_append_cb_t_snip] -->
 /**
  * \brief Callback for H5Pset_append_flush()
@@ -811,6 +848,63 @@ H5_DLL herr_t H5Dget_chunk_info(hid_t dset_id, hid_t fspace_id, hsize_t chk_idx,
  */
 H5_DLL haddr_t H5Dget_offset(hid_t dset_id);
 
+/**
+ * --------------------------------------------------------------------------
+ * \ingroup H5D
+ *
+ * \brief Retrieves the counters of the raw data chunk cache of a dataset
+ *
+ * \dset_id
+ * \param[out] stats Counters of the chunk cache
+ *
+ * \return \herr_t
+ *
+ * \details H5Dget_chunk_cache_stats() fills \p stats with the number of
+ *          chunk cache hits, misses, collisions and evictions since the
+ *          dataset \p dset_id was opened, together with the current
+ *          occupancy of the cache. The counters help to choose the cache
+ *          size and policy with H5Pset_chunk_cache() and
+ *          H5Pset_chunk_cache_policy().
+ *
+ *          The dataset must use chunked storage.
+ *
+ */
+H5_DLL herr_t H5Dget_chunk_cache_stats(hid_t dset_id, H5D_chunk_cache_stats_t *stats /*out*/);
+
+/**
+ * --------------------------------------------------------------------------
+ * \ingroup H5D
+ *
+ * \brief Rebuilds the version 1 B-tree chunk index of a dataset with the
+ *        latest indexing type
+ *
+ * \dset_id
+ *
+ * \return \herr_t
+ *
+ * \details H5Dformat_upgrade() goes in the opposite direction to
+ *          H5Dformat_convert(). If the chunked dataset \p dset_id is
+ *          indexed with a version 1 B-tree, the index is rebuilt in place
+ *          with the type a new dataset of the same shape would get: a
+ *          fixed array when no dimension is unlimited, an extensible array
+ *          when one dimension is unlimited and a version 2 B-tree
+ *          otherwise. Chunks are not moved or rewritten, and a dataset
+ *          whose chunk dimensions equal its dimensions gets the single
+ *          chunk index.
+ *
+ *          Lookups with these indices do not descend a tree, so chunked
+ *          reads are faster, but the dataset can no longer be read by
+ *          library releases older than 1.10. The file must be opened for
+ *          writing, and its format bounds, set with
+ *          H5Pset_libver_bounds(), must allow #H5F_LIBVER_V110 or later.
+ *          The space of the old index is not reclaimed; h5repack does it.
+ *
+ *          Datasets with any other layout or chunk index are left as they
+ *          are.
+ *
+ */
+H5_DLL herr_t H5Dformat_upgrade(hid_t dset_id);
+
 /**
  * --------------------------------------------------------------------------
  * \ingroup H5D
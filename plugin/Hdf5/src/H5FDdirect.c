@@ -16,6 +16,13 @@
  *    buffer.  The main system support this feature is Linux.
  */
 
+/* O_DIRECT is a GNU extension for glibc, and has to be asked for before
+ * the first system header
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #include "H5FDdrvr_module.h" /* This source code file is part of the H5FD driver module */
 
 #include "H5private.h"   /* Generic Functions        */
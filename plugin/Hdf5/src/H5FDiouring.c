@@ -0,0 +1,1471 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://www.hdfgroup.org/licenses.               *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose: A Linux file driver that works as sec2 for single reads and
+ *          writes, and submits vector I/O (which the library also uses for
+ *          selection I/O) in batches to an io_uring instance. Many small
+ *          scattered reads, like the chunks of a dataset, are then in
+ *          flight together, so fast devices are kept busy instead of
+ *          waiting for each request in turn.
+ *
+ *          The rings are set up with the raw system calls, so liburing is
+ *          not needed. When io_uring is not available (old kernels,
+ *          seccomp filters) the batches are served by a small pool of
+ *          threads doing pread()/pwrite().
+ */
+
+#include "H5FDdrvr_module.h" /* This source code file is part of the H5FD driver module */
+
+#include "H5private.h"   /* Generic Functions        */
+#include "H5Eprivate.h"  /* Error handling           */
+#include "H5Fprivate.h"  /* File access              */
+#include "H5FDprivate.h" /* File drivers             */
+#include "H5FDiouring.h" /* io_uring file driver     */
+#include "H5FLprivate.h" /* Free Lists               */
+#include "H5Iprivate.h"  /* IDs                      */
+#include "H5MMprivate.h" /* Memory management        */
+#include "H5Pprivate.h"  /* Property lists           */
+
+#ifdef H5_HAVE_IOURING
+
+#include <linux/io_uring.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+/* The driver identification number, initialized at runtime */
+static hid_t H5FD_IOURING_g = 0;
+
+/* Whether to ignore file locks when disabled (env var value) */
+static htri_t ignore_disabled_file_locks_s = FAIL;
+
+/* Driver-specific file access properties */
+typedef struct H5FD_iouring_fapl_t {
+    unsigned queue_depth; /* Maximum number of requests in flight          */
+    unsigned nthreads;    /* Threads used when io_uring is not available   */
+} H5FD_iouring_fapl_t;
+
+/* One piece of a vector read or write */
+typedef struct H5FD_iouring_req_t {
+    haddr_t addr; /* File address                     */
+    size_t  size; /* Number of bytes                  */
+    void   *buf;  /* Memory buffer                    */
+} H5FD_iouring_req_t;
+
+/* The submission and completion queues shared with the kernel */
+typedef struct H5FD_iouring_ring_t {
+    int                  fd;      /* io_uring instance, -1 if not available */
+    unsigned             entries; /* Submission queue entries               */
+    void                *sq_ptr;  /* Submission queue mapping               */
+    size_t               sq_size;
+    void                *cq_ptr; /* Completion queue mapping, can be sq_ptr */
+    size_t               cq_size;
+    struct io_uring_sqe *sqes; /* Submission queue entries mapping */
+    size_t               sqes_size;
+    unsigned            *sq_head, *sq_tail, *sq_mask, *sq_array;
+    unsigned            *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_cqe *cqes;
+} H5FD_iouring_ring_t;
+
+/* The threads that replace the ring when it is not available. They only
+ * do system calls, never HDF5 calls, so the library lock is not an issue.
+ */
+typedef struct H5FD_iouring_pool_t {
+    unsigned            nthreads; /* Threads running                  */
+    pthread_t          *threads;
+    pthread_mutex_t     mutex;
+    pthread_cond_t      job;  /* Signaled when a batch is ready   */
+    pthread_cond_t      done; /* Signaled when a batch is over    */
+    uint64_t            generation;
+    bool                stop;
+    int                 fd; /* Current batch */
+    bool                do_write;
+    H5FD_iouring_req_t *reqs;
+    uint32_t            count, next, pending;
+    int                 error;
+} H5FD_iouring_pool_t;
+
+/* The description of a file belonging to this driver. As in sec2, the
+ * 'eoa' and 'eof' determine the amount of hdf5 address space in use and the
+ * high-water mark of the file. pread() and pwrite() are always available on
+ * Linux, so the file position is not tracked.
+ */
+typedef struct H5FD_iouring_t {
+    H5FD_t              pub; /* public stuff, must be first      */
+    int                 fd;  /* the filesystem file descriptor   */
+    haddr_t             eoa; /* end of allocated region          */
+    haddr_t             eof; /* end of file; current file size   */
+    H5FD_iouring_fapl_t fa;  /* file access properties           */
+    H5FD_iouring_ring_t ring;
+    H5FD_iouring_pool_t pool;
+    bool                pool_init; /* The pool mutex and conditions are initialized */
+    bool                ignore_disabled_file_locks;
+    char                filename[H5FD_MAX_FILENAME_LEN]; /* Copy of file name from open operation */
+    dev_t               device;                          /* file device number   */
+    ino_t               inode;                           /* file i-node number   */
+} H5FD_iouring_t;
+
+/*
+ * These macros check for overflow of various quantities, as in the sec2
+ * driver.
+ */
+#define MAXADDR          (((haddr_t)1 << (8 * sizeof(HDoff_t) - 1)) - 1)
+#define ADDR_OVERFLOW(A) (HADDR_UNDEF == (A) || ((A) & ~(haddr_t)MAXADDR))
+#define SIZE_OVERFLOW(Z) ((Z) & ~(hsize_t)MAXADDR)
+#define REGION_OVERFLOW(A, Z)                                                                                \
+    (ADDR_OVERFLOW(A) || SIZE_OVERFLOW(Z) || HADDR_UNDEF == (A) + (Z) || (HDoff_t)((A) + (Z)) < (HDoff_t)(A))
+
+/* Largest request given to the ring. Longer ones are completed by pread()/pwrite() */
+#define H5FD_IOURING_MAX_REQ ((size_t)1 << 30)
+
+/* Prototypes */
+static herr_t  H5FD__iouring_term(void);
+static herr_t  H5FD__iouring_populate_config(unsigned queue_depth, unsigned nthreads,
+                                             H5FD_iouring_fapl_t *fa_out);
+static void   *H5FD__iouring_fapl_get(H5FD_t *file);
+static void   *H5FD__iouring_fapl_copy(const void *_old_fa);
+static H5FD_t *H5FD__iouring_open(const char *name, unsigned flags, hid_t fapl_id, haddr_t maxaddr);
+static herr_t  H5FD__iouring_close(H5FD_t *_file);
+static int     H5FD__iouring_cmp(const H5FD_t *_f1, const H5FD_t *_f2);
+static herr_t  H5FD__iouring_query(const H5FD_t *_f1, unsigned long *flags);
+static haddr_t H5FD__iouring_get_eoa(const H5FD_t *_file, H5FD_mem_t type);
+static herr_t  H5FD__iouring_set_eoa(H5FD_t *_file, H5FD_mem_t type, haddr_t addr);
+static haddr_t H5FD__iouring_get_eof(const H5FD_t *_file, H5FD_mem_t type);
+static herr_t  H5FD__iouring_get_handle(H5FD_t *_file, hid_t fapl, void **file_handle);
+static herr_t  H5FD__iouring_read(H5FD_t *_file, H5FD_mem_t type, hid_t fapl_id, haddr_t addr, size_t size,
+                                  void *buf);
+static herr_t  H5FD__iouring_write(H5FD_t *_file, H5FD_mem_t type, hid_t fapl_id, haddr_t addr, size_t size,
+                                   const void *buf);
+static herr_t  H5FD__iouring_read_vector(H5FD_t *_file, hid_t dxpl_id, uint32_t count, H5FD_mem_t types[],
+                                         haddr_t addrs[], size_t sizes[], void *bufs[]);
+static herr_t  H5FD__iouring_write_vector(H5FD_t *_file, hid_t dxpl_id, uint32_t count, H5FD_mem_t types[],
+                                          haddr_t addrs[], size_t sizes[], const void *bufs[]);
+static herr_t  H5FD__iouring_truncate(H5FD_t *_file, hid_t dxpl_id, bool closing);
+static herr_t  H5FD__iouring_lock(H5FD_t *_file, bool rw);
+static herr_t  H5FD__iouring_unlock(H5FD_t *_file);
+static herr_t  H5FD__iouring_delete(const char *filename, hid_t fapl_id);
+static herr_t  H5FD__iouring_ctl(H5FD_t *_file, uint64_t op_code, uint64_t flags, const void *input,
+                                 void **output);
+
+static int  H5FD__iouring_pio(int fd, bool do_write, haddr_t addr, size_t size, void *buf);
+static bool H5FD__iouring_ring_init(H5FD_iouring_ring_t *ring, unsigned entries);
+static void H5FD__iouring_ring_term(H5FD_iouring_ring_t *ring);
+static int  H5FD__iouring_ring_run(H5FD_iouring_t *file, bool do_write, H5FD_iouring_req_t *reqs,
+                                   uint32_t count);
+static int  H5FD__iouring_pool_run(H5FD_iouring_t *file, bool do_write, H5FD_iouring_req_t *reqs,
+                                   uint32_t count);
+static void H5FD__iouring_pool_term(H5FD_iouring_t *file);
+static herr_t H5FD__iouring_vector(H5FD_iouring_t *file, bool do_write, uint32_t count, H5FD_mem_t types[],
+                                   haddr_t addrs[], size_t sizes[], void *bufs[]);
+
+static const H5FD_class_t H5FD_iouring_g = {
+    H5FD_CLASS_VERSION,          /* struct version       */
+    H5FD_IOURING_VALUE,          /* value                */
+    "iouring",                   /* name                 */
+    MAXADDR,                     /* maxaddr              */
+    H5F_CLOSE_WEAK,              /* fc_degree            */
+    H5FD__iouring_term,          /* terminate            */
+    NULL,                        /* sb_size              */
+    NULL,                        /* sb_encode            */
+    NULL,                        /* sb_decode            */
+    sizeof(H5FD_iouring_fapl_t), /* fapl_size            */
+    H5FD__iouring_fapl_get,      /* fapl_get             */
+    H5FD__iouring_fapl_copy,     /* fapl_copy            */
+    NULL,                        /* fapl_free            */
+    0,                           /* dxpl_size            */
+    NULL,                        /* dxpl_copy            */
+    NULL,                        /* dxpl_free            */
+    H5FD__iouring_open,          /* open                 */
+    H5FD__iouring_close,         /* close                */
+    H5FD__iouring_cmp,           /* cmp                  */
+    H5FD__iouring_query,         /* query                */
+    NULL,                        /* get_type_map         */
+    NULL,                        /* alloc                */
+    NULL,                        /* free                 */
+    H5FD__iouring_get_eoa,       /* get_eoa              */
+    H5FD__iouring_set_eoa,       /* set_eoa              */
+    H5FD__iouring_get_eof,       /* get_eof              */
+    H5FD__iouring_get_handle,    /* get_handle           */
+    H5FD__iouring_read,          /* read                 */
+    H5FD__iouring_write,         /* write                */
+    H5FD__iouring_read_vector,   /* read_vector          */
+    H5FD__iouring_write_vector,  /* write_vector         */
+    NULL,                        /* read_selection       */
+    NULL,                        /* write_selection      */
+    NULL,                        /* flush                */
+    H5FD__iouring_truncate,      /* truncate             */
+    H5FD__iouring_lock,          /* lock                 */
+    H5FD__iouring_unlock,        /* unlock               */
+    H5FD__iouring_delete,        /* del                  */
+    H5FD__iouring_ctl,           /* ctl                  */
+    H5FD_FLMAP_DICHOTOMY         /* fl_map               */
+};
+
+/* Declare a free list to manage the H5FD_iouring_t struct */
+H5FL_DEFINE_STATIC(H5FD_iouring_t);
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_iouring_init
+ *
+ * Purpose:     Initialize this driver by registering the driver with the
+ *              library.
+ *
+ * Return:      Success:    The driver ID for the io_uring driver
+ *              Failure:    H5I_INVALID_HID
+ *
+ *-------------------------------------------------------------------------
+ */
+hid_t
+H5FD_iouring_init(void)
+{
+    char *lock_env_var = NULL;            /* Environment variable pointer */
+    hid_t ret_value    = H5I_INVALID_HID; /* Return value */
+
+    FUNC_ENTER_NOAPI_NOERR
+
+    /* Check the use disabled file locks environment variable */
+    lock_env_var = getenv(HDF5_USE_FILE_LOCKING);
+    if (lock_env_var && !strcmp(lock_env_var, "BEST_EFFORT"))
+        ignore_disabled_file_locks_s = true; /* Override: Ignore disabled locks */
+    else if (lock_env_var && (!strcmp(lock_env_var, "TRUE") || !strcmp(lock_env_var, "1")))
+        ignore_disabled_file_locks_s = false; /* Override: Don't ignore disabled locks */
+    else
+        ignore_disabled_file_locks_s = FAIL; /* Environment variable not set, or not set correctly */
+
+    if (H5I_VFL != H5I_get_type(H5FD_IOURING_g))
+        H5FD_IOURING_g = H5FD_register(&H5FD_iouring_g, sizeof(H5FD_class_t), false);
+
+    /* Set return value */
+    ret_value = H5FD_IOURING_g;
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_iouring_init() */
+
+/*---------------------------------------------------------------------------
+ * Function:    H5FD__iouring_term
+ *
+ * Purpose:     Shut down the VFD
+ *
+ * Returns:     SUCCEED (Can't fail)
+ *
+ *---------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__iouring_term(void)
+{
+    FUNC_ENTER_PACKAGE_NOERR
+
+    /* Reset VFL ID */
+    H5FD_IOURING_g = 0;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD__iouring_term() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pset_fapl_iouring
+ *
+ * Purpose:     Modify the file access property list to use the
+ *              H5FD_IOURING driver defined in this source file.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pset_fapl_iouring(hid_t fapl_id, unsigned queue_depth, unsigned nthreads)
+{
+    H5P_genplist_t     *plist; /* Property list pointer */
+    H5FD_iouring_fapl_t fa;
+    herr_t              ret_value;
+
+    FUNC_ENTER_API(FAIL)
+
+    if (NULL == (plist = H5P_object_verify(fapl_id, H5P_FILE_ACCESS)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a file access property list");
+
+    if (H5FD__iouring_populate_config(queue_depth, nthreads, &fa) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTSET, FAIL, "can't initialize driver configuration info");
+
+    ret_value = H5P_set_driver(plist, H5FD_IOURING, &fa, NULL);
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pset_fapl_iouring() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pget_fapl_iouring
+ *
+ * Purpose:     Returns information about the io_uring file access property
+ *              list though the function arguments.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pget_fapl_iouring(hid_t fapl_id, unsigned *queue_depth /*out*/, unsigned *nthreads /*out*/)
+{
+    H5P_genplist_t            *plist; /* Property list pointer */
+    const H5FD_iouring_fapl_t *fa;
+    herr_t                     ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+
+    if (NULL == (plist = H5P_object_verify(fapl_id, H5P_FILE_ACCESS)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a file access list");
+    if (H5FD_IOURING != H5P_peek_driver(plist))
+        HGOTO_ERROR(H5E_PLIST, H5E_BADVALUE, FAIL, "incorrect VFL driver");
+    if (NULL == (fa = (const H5FD_iouring_fapl_t *)H5P_peek_driver_info(plist)))
+        HGOTO_ERROR(H5E_PLIST, H5E_BADVALUE, FAIL, "bad VFL driver info");
+    if (queue_depth)
+        *queue_depth = fa->queue_depth;
+    if (nthreads)
+        *nthreads = fa->nthreads;
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pget_fapl_iouring() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_populate_config
+ *
+ * Purpose:     Populates a H5FD_iouring_fapl_t structure with the provided
+ *              values, supplying defaults where values are not provided.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__iouring_populate_config(unsigned queue_depth, unsigned nthreads, H5FD_iouring_fapl_t *fa_out)
+{
+    herr_t ret_value = SUCCEED;
+
+    FUNC_ENTER_PACKAGE
+
+    assert(fa_out);
+
+    memset(fa_out, 0, sizeof(H5FD_iouring_fapl_t));
+
+    fa_out->queue_depth = queue_depth != 0 ? queue_depth : H5FD_IOURING_QUEUE_DEPTH_DEF;
+    fa_out->nthreads    = nthreads != 0 ? nthreads : H5FD_IOURING_NTHREADS_DEF;
+
+    /* The kernel limit */
+    if (fa_out->queue_depth > 32768)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "queue depth is too large");
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__iouring_populate_config() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_fapl_get
+ *
+ * Purpose:     Returns a file access property list which indicates how the
+ *              specified file is being accessed.
+ *
+ * Return:      Success:    Ptr to new file access property list
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+H5FD__iouring_fapl_get(H5FD_t *_file)
+{
+    H5FD_iouring_t *file      = (H5FD_iouring_t *)_file;
+    void           *ret_value = NULL; /* Return value */
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    /* Set return value */
+    ret_value = H5FD__iouring_fapl_copy(&(file->fa));
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__iouring_fapl_get() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_fapl_copy
+ *
+ * Purpose:     Copies the io_uring-specific file access properties.
+ *
+ * Return:      Success:    Ptr to a new property list
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+H5FD__iouring_fapl_copy(const void *_old_fa)
+{
+    const H5FD_iouring_fapl_t *old_fa = (const H5FD_iouring_fapl_t *)_old_fa;
+    H5FD_iouring_fapl_t       *new_fa = H5MM_calloc(sizeof(H5FD_iouring_fapl_t));
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    if (new_fa)
+        H5MM_memcpy(new_fa, old_fa, sizeof(H5FD_iouring_fapl_t));
+
+    FUNC_LEAVE_NOAPI(new_fa)
+} /* end H5FD__iouring_fapl_copy() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_open
+ *
+ * Purpose:     Create and/or opens a file as an HDF5 file.
+ *
+ * Return:      Success:    A pointer to a new file data structure. The
+ *                          public fields will be initialized by the
+ *                          caller, which is always H5FD_open().
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5FD_t *
+H5FD__iouring_open(const char *name, unsigned flags, hid_t fapl_id, haddr_t maxaddr)
+{
+    H5FD_iouring_t            *file = NULL; /* io_uring VFD info        */
+    int                        fd   = -1;   /* File descriptor          */
+    int                        o_flags;     /* Flags for open() call    */
+    h5_stat_t                  sb;
+    H5P_genplist_t            *plist; /* Property list pointer */
+    const H5FD_iouring_fapl_t *fa;
+    H5FD_iouring_fapl_t        default_fa;
+    H5FD_t                    *ret_value = NULL; /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    /* Check arguments */
+    if (!name || !*name)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, NULL, "invalid file name");
+    if (0 == maxaddr || HADDR_UNDEF == maxaddr)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADRANGE, NULL, "bogus maxaddr");
+    if (ADDR_OVERFLOW(maxaddr))
+        HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, NULL, "bogus maxaddr");
+
+    /* Build the open flags */
+    o_flags = (H5F_ACC_RDWR & flags) ? O_RDWR : O_RDONLY;
+    if (H5F_ACC_TRUNC & flags)
+        o_flags |= O_TRUNC;
+    if (H5F_ACC_CREAT & flags)
+        o_flags |= O_CREAT;
+    if (H5F_ACC_EXCL & flags)
+        o_flags |= O_EXCL;
+
+    /* Open the file */
+    if ((fd = HDopen(name, o_flags, H5_POSIX_CREATE_MODE_RW)) < 0) {
+        int myerrno = errno;
+        HGOTO_ERROR(
+            H5E_FILE, H5E_CANTOPENFILE, NULL,
+            "unable to open file: name = '%s', errno = %d, error message = '%s', flags = %x, o_flags = %x",
+            name, myerrno, strerror(myerrno), flags, (unsigned)o_flags);
+    } /* end if */
+
+    memset(&sb, 0, sizeof(h5_stat_t));
+    if (HDfstat(fd, &sb) < 0)
+        HSYS_GOTO_ERROR(H5E_FILE, H5E_BADFILE, NULL, "unable to fstat file");
+
+    /* Create the new file struct */
+    if (NULL == (file = H5FL_CALLOC(H5FD_iouring_t)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "unable to allocate file struct");
+    file->ring.fd = -1;
+
+    /* Get the driver specific information */
+    if (NULL == (plist = (H5P_genplist_t *)H5I_object(fapl_id)))
+        HGOTO_ERROR(H5E_VFL, H5E_BADTYPE, NULL, "not a file access property list");
+    if (NULL == (fa = (const H5FD_iouring_fapl_t *)H5P_peek_driver_info(plist))) {
+        if (H5FD__iouring_populate_config(0, 0, &default_fa) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTSET, NULL, "can't initialize driver configuration info");
+        fa = &default_fa;
+    }
+    file->fa = *fa;
+
+    file->fd = fd;
+    H5_CHECKED_ASSIGN(file->eof, haddr_t, sb.st_size, h5_stat_size_t);
+    file->device = sb.st_dev;
+    file->inode  = sb.st_ino;
+
+    /* The ring is optional: the thread pool is used without it */
+    H5FD__iouring_ring_init(&file->ring, file->fa.queue_depth);
+
+    /* Check the file locking flags in the fapl */
+    if (ignore_disabled_file_locks_s != FAIL)
+        /* The environment variable was set, so use that preferentially */
+        file->ignore_disabled_file_locks = ignore_disabled_file_locks_s;
+    else {
+        /* Use the value in the property list */
+        if (H5P_get(plist, H5F_ACS_IGNORE_DISABLED_FILE_LOCKS_NAME, &file->ignore_disabled_file_locks) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTGET, NULL, "can't get ignore disabled file locks property");
+    }
+
+    /* Retain a copy of the name used to open the file, for possible error reporting */
+    strncpy(file->filename, name, sizeof(file->filename) - 1);
+    file->filename[sizeof(file->filename) - 1] = '\0';
+
+    /* Set return value */
+    ret_value = (H5FD_t *)file;
+
+done:
+    if (NULL == ret_value) {
+        if (fd >= 0)
+            HDclose(fd);
+        if (file) {
+            H5FD__iouring_ring_term(&file->ring);
+            file = H5FL_FREE(H5FD_iouring_t, file);
+        }
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__iouring_open() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_close
+ *
+ * Purpose:     Closes an HDF5 file, with its ring and threads.
+ *
+ * Return:      Success:    SUCCEED
+ *              Failure:    FAIL, file not closed.
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__iouring_close(H5FD_t *_file)
+{
+    H5FD_iouring_t *file      = (H5FD_iouring_t *)_file;
+    herr_t          ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    /* Sanity check */
+    assert(file);
+
+    H5FD__iouring_pool_term(file);
+    H5FD__iouring_ring_term(&file->ring);
+
+    /* Close the underlying file */
+    if (HDclose(file->fd) < 0)
+        HSYS_GOTO_ERROR(H5E_IO, H5E_CANTCLOSEFILE, FAIL, "unable to close file");
+
+    /* Release the file info */
+    file = H5FL_FREE(H5FD_iouring_t, file);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__iouring_close() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_cmp
+ *
+ * Purpose:     Compares two files belonging to this driver using an
+ *              arbitrary (but consistent) ordering.
+ *
+ * Return:      Success:    A value like strcmp()
+ *              Failure:    never fails (arguments were checked by the
+ *                          caller).
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+H5FD__iouring_cmp(const H5FD_t *_f1, const H5FD_t *_f2)
+{
+    const H5FD_iouring_t *f1        = (const H5FD_iouring_t *)_f1;
+    const H5FD_iouring_t *f2        = (const H5FD_iouring_t *)_f2;
+    int                   ret_value = 0;
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+#ifdef H5_DEV_T_IS_SCALAR
+    if (f1->device < f2->device)
+        HGOTO_DONE(-1);
+    if (f1->device > f2->device)
+        HGOTO_DONE(1);
+#else  /* H5_DEV_T_IS_SCALAR */
+    if (memcmp(&(f1->device), &(f2->device), sizeof(dev_t)) < 0)
+        HGOTO_DONE(-1);
+    if (memcmp(&(f1->device), &(f2->device), sizeof(dev_t)) > 0)
+        HGOTO_DONE(1);
+#endif /* H5_DEV_T_IS_SCALAR */
+    if (f1->inode < f2->inode)
+        HGOTO_DONE(-1);
+    if (f1->inode > f2->inode)
+        HGOTO_DONE(1);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__iouring_cmp() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_query
+ *
+ * Purpose:     Set the flags that this VFL driver is capable of supporting.
+ *              (listed in H5FDpublic.h). They are the same as sec2.
+ *
+ * Return:      SUCCEED (Can't fail)
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__iouring_query(const H5FD_t H5_ATTR_UNUSED *_file, unsigned long *flags /* out */)
+{
+    FUNC_ENTER_PACKAGE_NOERR
+
+    /* Set the VFL feature flags that this driver supports */
+    if (flags) {
+        *flags = 0;
+        *flags |= H5FD_FEAT_AGGREGATE_METADATA;  /* OK to aggregate metadata allocations  */
+        *flags |= H5FD_FEAT_ACCUMULATE_METADATA; /* OK to accumulate metadata for faster writes */
+        *flags |= H5FD_FEAT_DATA_SIEVE; /* OK to perform data sieving for faster raw data reads & writes    */
+        *flags |= H5FD_FEAT_AGGREGATE_SMALLDATA; /* OK to aggregate "small" raw data allocations */
+        *flags |= H5FD_FEAT_POSIX_COMPAT_HANDLE; /* get_handle callback returns a POSIX file descriptor */
+        *flags |=
+            H5FD_FEAT_SUPPORTS_SWMR_IO; /* VFD supports the single-writer/multiple-readers (SWMR) pattern   */
+        *flags |= H5FD_FEAT_DEFAULT_VFD_COMPATIBLE; /* VFD creates a file which can be opened with the default
+                                                       VFD      */
+    }                                               /* end if */
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD__iouring_query() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_get_eoa
+ *
+ * Purpose:     Gets the end-of-address marker for the file. The EOA marker
+ *              is the first address past the last byte allocated in the
+ *              format address space.
+ *
+ * Return:      The end-of-address marker.
+ *
+ *-------------------------------------------------------------------------
+ */
+static haddr_t
+H5FD__iouring_get_eoa(const H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type)
+{
+    const H5FD_iouring_t *file = (const H5FD_iouring_t *)_file;
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    FUNC_LEAVE_NOAPI(file->eoa)
+} /* end H5FD__iouring_get_eoa() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_set_eoa
+ *
+ * Purpose:     Set the end-of-address marker for the file. This function is
+ *              called shortly after an existing HDF5 file is opened in order
+ *              to tell the driver where the end of the HDF5 data is located.
+ *
+ * Return:      SUCCEED (Can't fail)
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__iouring_set_eoa(H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type, haddr_t addr)
+{
+    H5FD_iouring_t *file = (H5FD_iouring_t *)_file;
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    file->eoa = addr;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD__iouring_set_eoa() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_get_eof
+ *
+ * Purpose:     Returns the end-of-file marker, which is the greater of
+ *              either the filesystem end-of-file or the HDF5 end-of-address
+ *              markers.
+ *
+ * Return:      End of file address.
+ *
+ *-------------------------------------------------------------------------
+ */
+static haddr_t
+H5FD__iouring_get_eof(const H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type)
+{
+    const H5FD_iouring_t *file = (const H5FD_iouring_t *)_file;
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    FUNC_LEAVE_NOAPI(file->eof)
+} /* end H5FD__iouring_get_eof() */
+
+/*-------------------------------------------------------------------------
+ * Function:       H5FD__iouring_get_handle
+ *
+ * Purpose:        Returns the file descriptor.
+ *
+ * Returns:        SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__iouring_get_handle(H5FD_t *_file, hid_t H5_ATTR_UNUSED fapl, void **file_handle)
+{
+    H5FD_iouring_t *file      = (H5FD_iouring_t *)_file;
+    herr_t          ret_value = SUCCEED;
+
+    FUNC_ENTER_PACKAGE
+
+    if (!file_handle)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "file handle not valid");
+
+    *file_handle = &(file->fd);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__iouring_get_handle() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_pio
+ *
+ * Purpose:     Reads or writes SIZE bytes at ADDR with pread()/pwrite(),
+ *              being careful of interrupted system calls and partial
+ *              results. Reads past the end of the file return zeros.
+ *
+ *              It does not use the HDF5 error stack, as it is also called
+ *              from the pool threads.
+ *
+ * Return:      0 or the errno value
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+H5FD__iouring_pio(int fd, bool do_write, haddr_t addr, size_t size, void *buf)
+{
+    while (size > 0) {
+        h5_posix_io_t     bytes_in = (h5_posix_io_t)MIN(size, H5_POSIX_MAX_IO_BYTES);
+        h5_posix_io_ret_t bytes_done;
+
+        do {
+            if (do_write)
+                bytes_done = HDpwrite(fd, buf, bytes_in, (HDoff_t)addr);
+            else
+                bytes_done = HDpread(fd, buf, bytes_in, (HDoff_t)addr);
+        } while (-1 == bytes_done && EINTR == errno);
+
+        if (-1 == bytes_done)
+            return errno;
+
+        if (0 == bytes_done) {
+            if (do_write)
+                return EIO;
+            /* end of file but not end of format address space */
+            memset(buf, 0, size);
+            break;
+        }
+
+        size -= (size_t)bytes_done;
+        addr += (haddr_t)bytes_done;
+        buf = (char *)buf + bytes_done;
+    }
+
+    return 0;
+} /* end H5FD__iouring_pio() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_read
+ *
+ * Purpose:     Reads SIZE bytes of data from FILE beginning at address ADDR
+ *              into buffer BUF.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__iouring_read(H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type, hid_t H5_ATTR_UNUSED dxpl_id, haddr_t addr,
+                   size_t size, void *buf /*out*/)
+{
+    H5FD_iouring_t *file = (H5FD_iouring_t *)_file;
+    int             myerrno;
+    herr_t          ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    assert(file && file->pub.cls);
+    assert(buf);
+
+    /* Check for overflow conditions */
+    if (!H5_addr_defined(addr))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "addr undefined, addr = %llu", (unsigned long long)addr);
+    if (REGION_OVERFLOW(addr, size))
+        HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, FAIL, "addr overflow, addr = %llu", (unsigned long long)addr);
+
+    if (0 != (myerrno = H5FD__iouring_pio(file->fd, false, addr, size, buf)))
+        HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL,
+                    "file read failed: filename = '%s', errno = %d, error message = '%s', size = %zu, "
+                    "offset = %llu",
+                    file->filename, myerrno, strerror(myerrno), size, (unsigned long long)addr);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__iouring_read() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_write
+ *
+ * Purpose:     Writes SIZE bytes of data to FILE beginning at address ADDR
+ *              from buffer BUF.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__iouring_write(H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type, hid_t H5_ATTR_UNUSED dxpl_id, haddr_t addr,
+                    size_t size, const void *buf)
+{
+    H5FD_iouring_t *file = (H5FD_iouring_t *)_file;
+    int             myerrno;
+    herr_t          ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    assert(file && file->pub.cls);
+    assert(buf);
+
+    /* Check for overflow conditions */
+    if (!H5_addr_defined(addr))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "addr undefined, addr = %llu", (unsigned long long)addr);
+    if (REGION_OVERFLOW(addr, size))
+        HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, FAIL, "addr overflow, addr = %llu, size = %llu",
+                    (unsigned long long)addr, (unsigned long long)size);
+
+    if (0 != (myerrno = H5FD__iouring_pio(file->fd, true, addr, size, (void *)buf)))
+        HGOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL,
+                    "file write failed: filename = '%s', errno = %d, error message = '%s', size = %zu, "
+                    "offset = %llu",
+                    file->filename, myerrno, strerror(myerrno), size, (unsigned long long)addr);
+
+    /* Update eof */
+    if (addr + size > file->eof)
+        file->eof = addr + size;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__iouring_write() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_ring_init
+ *
+ * Purpose:     Creates an io_uring instance with ENTRIES submission queue
+ *              entries and maps its queues.
+ *
+ * Return:      true if the ring can be used. Otherwise ring->fd is -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static bool
+H5FD__iouring_ring_init(H5FD_iouring_ring_t *ring, unsigned entries)
+{
+    struct io_uring_params p;
+    char                  *sq, *cq;
+
+    memset(ring, 0, sizeof(H5FD_iouring_ring_t));
+    ring->fd = -1;
+
+    memset(&p, 0, sizeof(p));
+    if ((ring->fd = (int)syscall(__NR_io_uring_setup, entries, &p)) < 0) {
+        ring->fd = -1;
+        return false;
+    }
+
+    ring->entries = p.sq_entries;
+    ring->sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    ring->cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+        ring->sq_size = ring->cq_size = MAX(ring->sq_size, ring->cq_size);
+
+    ring->sq_ptr = mmap(NULL, ring->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                        IORING_OFF_SQ_RING);
+    if (MAP_FAILED == ring->sq_ptr) {
+        ring->sq_ptr = NULL;
+        goto error;
+    }
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+        ring->cq_ptr = ring->sq_ptr;
+    else {
+        ring->cq_ptr = mmap(NULL, ring->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            ring->fd, IORING_OFF_CQ_RING);
+        if (MAP_FAILED == ring->cq_ptr) {
+            ring->cq_ptr = NULL;
+            goto error;
+        }
+    }
+    ring->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                      IORING_OFF_SQES);
+    if (MAP_FAILED == ring->sqes) {
+        ring->sqes = NULL;
+        goto error;
+    }
+
+    sq             = (char *)ring->sq_ptr;
+    cq             = (char *)ring->cq_ptr;
+    ring->sq_head  = (unsigned *)(sq + p.sq_off.head);
+    ring->sq_tail  = (unsigned *)(sq + p.sq_off.tail);
+    ring->sq_mask  = (unsigned *)(sq + p.sq_off.ring_mask);
+    ring->sq_array = (unsigned *)(sq + p.sq_off.array);
+    ring->cq_head  = (unsigned *)(cq + p.cq_off.head);
+    ring->cq_tail  = (unsigned *)(cq + p.cq_off.tail);
+    ring->cq_mask  = (unsigned *)(cq + p.cq_off.ring_mask);
+    ring->cqes     = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+
+    return true;
+
+error:
+    H5FD__iouring_ring_term(ring);
+    return false;
+} /* end H5FD__iouring_ring_init() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_ring_term
+ *
+ * Purpose:     Unmaps the queues and closes the io_uring instance
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FD__iouring_ring_term(H5FD_iouring_ring_t *ring)
+{
+    if (ring->sqes)
+        munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ptr && ring->cq_ptr != ring->sq_ptr)
+        munmap(ring->cq_ptr, ring->cq_size);
+    if (ring->sq_ptr)
+        munmap(ring->sq_ptr, ring->sq_size);
+    if (ring->fd >= 0)
+        HDclose(ring->fd);
+
+    memset(ring, 0, sizeof(H5FD_iouring_ring_t));
+    ring->fd = -1;
+} /* end H5FD__iouring_ring_term() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_ring_run
+ *
+ * Purpose:     Keeps the submission queue full with the COUNT requests and
+ *              waits for all of them. Short transfers and requests the
+ *              kernel does not accept are completed with pread()/pwrite().
+ *
+ * Return:      0 or the errno value. Nothing is left in flight on return.
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+H5FD__iouring_ring_run(H5FD_iouring_t *file, bool do_write, H5FD_iouring_req_t *reqs, uint32_t count)
+{
+    H5FD_iouring_ring_t *ring     = &file->ring;
+    uint32_t             next     = 0; /* Next request to queue          */
+    unsigned             queued   = 0; /* Queued but not submitted yet   */
+    unsigned             inflight = 0; /* Submitted but not completed    */
+    int                  error    = 0;
+
+    while (next < count || queued > 0 || inflight > 0) {
+        unsigned tail = *ring->sq_tail;
+        unsigned head, chead, ctail;
+        int      ret;
+
+        /* Fill the submission queue. The completion queue is at least as large, so it cannot overflow */
+        head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+        while (next < count && !error && queued + inflight < ring->entries && tail - head < ring->entries) {
+            unsigned             idx = tail & *ring->sq_mask;
+            struct io_uring_sqe *sqe = &ring->sqes[idx];
+
+            memset(sqe, 0, sizeof(struct io_uring_sqe));
+            sqe->opcode    = do_write ? IORING_OP_WRITE : IORING_OP_READ;
+            sqe->fd        = file->fd;
+            sqe->addr      = (uint64_t)(uintptr_t)reqs[next].buf;
+            sqe->len       = (uint32_t)MIN(reqs[next].size, H5FD_IOURING_MAX_REQ);
+            sqe->off       = (uint64_t)reqs[next].addr;
+            sqe->user_data = next;
+
+            ring->sq_array[idx] = idx;
+            tail++;
+            next++;
+            queued++;
+        }
+        __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+
+        /* Submit and wait for at least one completion */
+        do
+            ret = (int)syscall(__NR_io_uring_enter, ring->fd, queued, queued + inflight > 0 ? 1 : 0,
+                               IORING_ENTER_GETEVENTS, NULL, 0);
+        while (ret < 0 && EINTR == errno);
+        if (ret < 0)
+            return errno;
+        queued -= (unsigned)ret;
+        inflight += (unsigned)ret;
+
+        /* Reap the completions */
+        chead = *ring->cq_head;
+        ctail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+        while (chead != ctail) {
+            struct io_uring_cqe *cqe = &ring->cqes[chead & *ring->cq_mask];
+            H5FD_iouring_req_t  *req = &reqs[cqe->user_data];
+            int                  res = cqe->res;
+            int                  err = 0;
+
+            chead++;
+            inflight--;
+
+            if (res < 0) {
+                /* Kernels before 5.6 do not have IORING_OP_READ/WRITE */
+                if (-EINVAL == res || -EOPNOTSUPP == res || -EAGAIN == res)
+                    err = H5FD__iouring_pio(file->fd, do_write, req->addr, req->size, req->buf);
+                else
+                    err = -res;
+            }
+            else if ((size_t)res < req->size)
+                err = H5FD__iouring_pio(file->fd, do_write, req->addr + (haddr_t)res, req->size - (size_t)res,
+                                        (char *)req->buf + res);
+            if (err && !error)
+                error = err;
+        }
+        __atomic_store_n(ring->cq_head, chead, __ATOMIC_RELEASE);
+    }
+
+    return error;
+} /* end H5FD__iouring_ring_run() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_worker
+ *
+ * Purpose:     Pool thread. Takes requests of the current batch until
+ *              there are no more
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+H5FD__iouring_worker(void *_pool)
+{
+    H5FD_iouring_pool_t *pool       = (H5FD_iouring_pool_t *)_pool;
+    uint64_t             generation = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    for (;;) {
+        while (!pool->stop && pool->generation == generation)
+            pthread_cond_wait(&pool->job, &pool->mutex);
+        if (pool->stop)
+            break;
+        generation = pool->generation;
+
+        while (pool->next < pool->count) {
+            H5FD_iouring_req_t *req = &pool->reqs[pool->next++];
+            int                 err;
+
+            pthread_mutex_unlock(&pool->mutex);
+            err = H5FD__iouring_pio(pool->fd, pool->do_write, req->addr, req->size, req->buf);
+            pthread_mutex_lock(&pool->mutex);
+
+            if (err && !pool->error)
+                pool->error = err;
+            if (0 == --pool->pending)
+                pthread_cond_signal(&pool->done);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+} /* end H5FD__iouring_worker() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_pool_run
+ *
+ * Purpose:     Serves the COUNT requests with the thread pool, started on
+ *              first use. Without threads the requests are done here.
+ *
+ * Return:      0 or the errno value
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+H5FD__iouring_pool_run(H5FD_iouring_t *file, bool do_write, H5FD_iouring_req_t *reqs, uint32_t count)
+{
+    H5FD_iouring_pool_t *pool  = &file->pool;
+    int                  error = 0;
+    uint32_t             i;
+
+    if (!file->pool_init) {
+        memset(pool, 0, sizeof(H5FD_iouring_pool_t));
+        pthread_mutex_init(&pool->mutex, NULL);
+        pthread_cond_init(&pool->job, NULL);
+        pthread_cond_init(&pool->done, NULL);
+        file->pool_init = true;
+
+        if (NULL != (pool->threads = (pthread_t *)H5MM_malloc(file->fa.nthreads * sizeof(pthread_t))))
+            for (i = 0; i < file->fa.nthreads; i++) {
+                if (pthread_create(&pool->threads[pool->nthreads], NULL, H5FD__iouring_worker, pool) != 0)
+                    break;
+                pool->nthreads++;
+            }
+    }
+
+    if (0 == pool->nthreads) {
+        for (i = 0; i < count && !error; i++)
+            error = H5FD__iouring_pio(file->fd, do_write, reqs[i].addr, reqs[i].size, reqs[i].buf);
+        return error;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->fd       = file->fd;
+    pool->do_write = do_write;
+    pool->reqs     = reqs;
+    pool->count    = count;
+    pool->next     = 0;
+    pool->pending  = count;
+    pool->error    = 0;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->job);
+    while (pool->pending > 0)
+        pthread_cond_wait(&pool->done, &pool->mutex);
+    error      = pool->error;
+    pool->reqs = NULL;
+    pthread_mutex_unlock(&pool->mutex);
+
+    return error;
+} /* end H5FD__iouring_pool_run() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_pool_term
+ *
+ * Purpose:     Stops the pool threads, if they were started
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FD__iouring_pool_term(H5FD_iouring_t *file)
+{
+    H5FD_iouring_pool_t *pool = &file->pool;
+    unsigned             i;
+
+    if (!file->pool_init)
+        return;
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->job);
+    pthread_mutex_unlock(&pool->mutex);
+    for (i = 0; i < pool->nthreads; i++)
+        pthread_join(pool->threads[i], NULL);
+
+    H5MM_xfree(pool->threads);
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->job);
+    pthread_mutex_destroy(&pool->mutex);
+    file->pool_init = false;
+} /* end H5FD__iouring_pool_term() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_vector
+ *
+ * Purpose:     Common part of the vector callbacks. Expands SIZES and TYPES
+ *              (a 0 size or H5FD_MEM_NOLIST type repeats the previous one),
+ *              checks the addresses and runs the batch with the ring or the
+ *              thread pool.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__iouring_vector(H5FD_iouring_t *file, bool do_write, uint32_t count, H5FD_mem_t H5_ATTR_UNUSED types[],
+                     haddr_t addrs[], size_t sizes[], void *bufs[])
+{
+    H5FD_iouring_req_t *reqs = NULL;
+    size_t              size = 0;
+    bool                extend_sizes = false;
+    uint32_t            i;
+    int                 myerrno;
+    herr_t              ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    assert(file && file->pub.cls);
+    assert((addrs && sizes && bufs) || 0 == count);
+
+    if (0 == count)
+        HGOTO_DONE(SUCCEED);
+
+    if (NULL == (reqs = (H5FD_iouring_req_t *)H5MM_malloc(count * sizeof(H5FD_iouring_req_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTALLOC, FAIL, "unable to allocate request list");
+
+    for (i = 0; i < count; i++) {
+        if (!extend_sizes) {
+            if (sizes[i] == 0) {
+                assert(i > 0);
+                extend_sizes = true;
+            }
+            else
+                size = sizes[i];
+        }
+
+        if (!H5_addr_defined(addrs[i]))
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "addr undefined, addr = %llu",
+                        (unsigned long long)addrs[i]);
+        if (REGION_OVERFLOW(addrs[i], size))
+            HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, FAIL, "addr overflow, addr = %llu, size = %llu",
+                        (unsigned long long)addrs[i], (unsigned long long)size);
+
+        reqs[i].addr = addrs[i];
+        reqs[i].size = size;
+        reqs[i].buf  = bufs[i];
+    }
+
+    /* A single request is not worth a batch */
+    if (1 == count)
+        myerrno = H5FD__iouring_pio(file->fd, do_write, reqs[0].addr, reqs[0].size, reqs[0].buf);
+    else if (file->ring.fd >= 0)
+        myerrno = H5FD__iouring_ring_run(file, do_write, reqs, count);
+    else
+        myerrno = H5FD__iouring_pool_run(file, do_write, reqs, count);
+
+    if (0 != myerrno) {
+        if (do_write)
+            HGOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL,
+                        "file vector write failed: filename = '%s', errno = %d, error message = '%s', "
+                        "count = %u",
+                        file->filename, myerrno, strerror(myerrno), (unsigned)count);
+        else
+            HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL,
+                        "file vector read failed: filename = '%s', errno = %d, error message = '%s', "
+                        "count = %u",
+                        file->filename, myerrno, strerror(myerrno), (unsigned)count);
+    }
+
+    /* Update eof */
+    if (do_write)
+        for (i = 0; i < count; i++)
+            if (reqs[i].addr + reqs[i].size > file->eof)
+                file->eof = reqs[i].addr + reqs[i].size;
+
+done:
+    H5MM_xfree(reqs);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__iouring_vector() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_read_vector
+ *
+ * Purpose:     Reads COUNT pieces of data, submitted together.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__iouring_read_vector(H5FD_t *_file, hid_t H5_ATTR_UNUSED dxpl_id, uint32_t count, H5FD_mem_t types[],
+                          haddr_t addrs[], size_t sizes[], void *bufs[] /* out */)
+{
+    H5FD_iouring_t *file      = (H5FD_iouring_t *)_file;
+    herr_t          ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    if (H5FD__iouring_vector(file, false, count, types, addrs, sizes, bufs) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_READERROR, FAIL, "vector read failed");
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__iouring_read_vector() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_write_vector
+ *
+ * Purpose:     Writes COUNT pieces of data, submitted together.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__iouring_write_vector(H5FD_t *_file, hid_t H5_ATTR_UNUSED dxpl_id, uint32_t count, H5FD_mem_t types[],
+                           haddr_t addrs[], size_t sizes[], const void *bufs[])
+{
+    H5FD_iouring_t *file      = (H5FD_iouring_t *)_file;
+    herr_t          ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    H5_GCC_CLANG_DIAG_OFF("cast-qual")
+    if (H5FD__iouring_vector(file, true, count, types, addrs, sizes, (void **)bufs) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_WRITEERROR, FAIL, "vector write failed");
+    H5_GCC_CLANG_DIAG_ON("cast-qual")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__iouring_write_vector() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_truncate
+ *
+ * Purpose:     Makes sure that the true file size is the same (or larger)
+ *              than the end-of-address.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__iouring_truncate(H5FD_t *_file, hid_t H5_ATTR_UNUSED dxpl_id, bool H5_ATTR_UNUSED closing)
+{
+    H5FD_iouring_t *file      = (H5FD_iouring_t *)_file;
+    herr_t          ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    assert(file);
+
+    /* Extend the file to make sure it's large enough */
+    if (!H5_addr_eq(file->eoa, file->eof)) {
+        if (-1 == HDftruncate(file->fd, (HDoff_t)file->eoa))
+            HSYS_GOTO_ERROR(H5E_IO, H5E_SEEKERROR, FAIL, "unable to extend file properly");
+
+        /* Update the eof value */
+        file->eof = file->eoa;
+    } /* end if */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__iouring_truncate() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_lock
+ *
+ * Purpose:     To place an advisory lock on a file.
+ *		The lock type to apply depends on the parameter "rw":
+ *			true--opens for write: an exclusive lock
+ *			false--opens for read: a shared lock
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__iouring_lock(H5FD_t *_file, bool rw)
+{
+    H5FD_iouring_t *file = (H5FD_iouring_t *)_file; /* VFD file struct          */
+    int             lock_flags;                     /* file locking flags       */
+    herr_t          ret_value = SUCCEED;            /* Return value             */
+
+    FUNC_ENTER_PACKAGE
+
+    assert(file);
+
+    /* Set exclusive or shared lock based on rw status */
+    lock_flags = rw ? LOCK_EX : LOCK_SH;
+
+    /* Place a non-blocking lock on the file */
+    if (HDflock(file->fd, lock_flags | LOCK_NB) < 0) {
+        if (file->ignore_disabled_file_locks && ENOSYS == errno) {
+            /* When errno is set to ENOSYS, the file system does not support
+             * locking, so ignore it.
+             */
+            errno = 0;
+        }
+        else
+            HSYS_GOTO_ERROR(H5E_VFL, H5E_CANTLOCKFILE, FAIL, "unable to lock file");
+    }
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__iouring_lock() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_unlock
+ *
+ * Purpose:     To remove the existing lock on the file
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__iouring_unlock(H5FD_t *_file)
+{
+    H5FD_iouring_t *file      = (H5FD_iouring_t *)_file; /* VFD file struct          */
+    herr_t          ret_value = SUCCEED;                 /* Return value             */
+
+    FUNC_ENTER_PACKAGE
+
+    assert(file);
+
+    if (HDflock(file->fd, LOCK_UN) < 0) {
+        if (file->ignore_disabled_file_locks && ENOSYS == errno) {
+            /* When errno is set to ENOSYS, the file system does not support
+             * locking, so ignore it.
+             */
+            errno = 0;
+        }
+        else
+            HSYS_GOTO_ERROR(H5E_VFL, H5E_CANTUNLOCKFILE, FAIL, "unable to unlock file");
+    }
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__iouring_unlock() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_delete
+ *
+ * Purpose:     Delete a file
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__iouring_delete(const char *filename, hid_t H5_ATTR_UNUSED fapl_id)
+{
+    herr_t ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    assert(filename);
+
+    if (HDremove(filename) < 0)
+        HSYS_GOTO_ERROR(H5E_VFL, H5E_CANTDELETEFILE, FAIL, "unable to delete file");
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__iouring_delete() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__iouring_ctl
+ *
+ * Purpose:     io_uring VFD version of the ctl callback.
+ *
+ *              At present, no op codes are supported by this VFD.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__iouring_ctl(H5FD_t H5_ATTR_UNUSED *_file, uint64_t H5_ATTR_UNUSED op_code, uint64_t flags,
+                  const void H5_ATTR_UNUSED *input, void H5_ATTR_UNUSED **output)
+{
+    herr_t ret_value = SUCCEED;
+
+    FUNC_ENTER_PACKAGE
+
+    /* No op codes are understood. */
+    if (flags & H5FD_CTL_FAIL_IF_UNKNOWN_FLAG)
+        HGOTO_ERROR(H5E_VFL, H5E_FCNTL, FAIL, "unknown op_code and fail if unknown flag is set");
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__iouring_ctl() */
+
+#endif /* H5_HAVE_IOURING */
@@ -0,0 +1,99 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://www.hdfgroup.org/licenses.               *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose:	The public header file for the Linux io_uring virtual file driver
+ *          (VFD)
+ */
+#ifndef H5FDiouring_H
+#define H5FDiouring_H
+
+#ifdef H5_HAVE_IOURING
+
+/** Initializer for the io_uring VFD */
+#define H5FD_IOURING (H5FDperform_init(H5FD_iouring_init))
+
+/** Identifier for the io_uring VFD */
+#define H5FD_IOURING_VALUE H5_VFD_IOURING
+
+#else
+
+/** Initializer for the io_uring VFD (disabled) */
+#define H5FD_IOURING       (H5I_INVALID_HID)
+
+/** Identifier for the io_uring VFD (disabled) */
+#define H5FD_IOURING_VALUE H5_VFD_INVALID
+
+#endif /* H5_HAVE_IOURING */
+
+/** Default number of requests submitted together */
+#define H5FD_IOURING_QUEUE_DEPTH_DEF 128
+
+/** Default number of threads used when io_uring is not available */
+#define H5FD_IOURING_NTHREADS_DEF 4
+
+#ifdef H5_HAVE_IOURING
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @private
+ *
+ * \brief Private initializer for the io_uring VFD
+ */
+H5_DLL hid_t H5FD_iouring_init(void);
+
+/**
+ * \ingroup FAPL
+ *
+ * \brief Sets up use of the io_uring driver
+ *
+ * \fapl_id
+ * \param[in] queue_depth Maximum number of requests in flight
+ * \param[in] nthreads Number of threads used when io_uring is not available
+ * \returns \herr_t
+ *
+ * \details H5Pset_fapl_iouring() sets the file access property list, \p fapl_id,
+ *          to use the io_uring driver, #H5FD_IOURING. Single reads and writes are
+ *          done with pread() and pwrite(), as in the sec2 driver. Vector and
+ *          selection I/O, used by the library to read or write many pieces of
+ *          raw data at once, are submitted in batches of up to \p queue_depth
+ *          requests to an io_uring instance, so that the device sees them all
+ *          together instead of one at a time.
+ *
+ *          If the kernel does not support io_uring the batches are served by
+ *          \p nthreads threads, each one doing pread() or pwrite() calls.
+ *
+ *          A value of 0 in \p queue_depth or \p nthreads selects the default.
+ *
+ */
+H5_DLL herr_t H5Pset_fapl_iouring(hid_t fapl_id, unsigned queue_depth, unsigned nthreads);
+
+/**
+ * \ingroup FAPL
+ *
+ * \brief Retrieves io_uring driver settings
+ *
+ * \fapl_id
+ * \param[out] queue_depth Maximum number of requests in flight
+ * \param[out] nthreads Number of threads used when io_uring is not available
+ * \returns \herr_t
+ *
+ */
+H5_DLL herr_t H5Pget_fapl_iouring(hid_t fapl_id, unsigned *queue_depth /*out*/, unsigned *nthreads /*out*/);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* H5_HAVE_IOURING */
+
+#endif
@@ -0,0 +1,705 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://www.hdfgroup.org/licenses.               *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose: A read-only file driver that maps the whole file in memory with
+ *          mmap() when it is opened. Reads are a memcpy() from the mapping,
+ *          so once the pages are in the page cache there are no system
+ *          calls at all. Applications can also get the address of the
+ *          mapping with H5Fget_vfd_handle() and use contiguous raw data
+ *          in place (see H5Dget_offset()).
+ *
+ *          The file is not remapped if it grows after being opened.
+ */
+
+#include "H5FDdrvr_module.h" /* This source code file is part of the H5FD driver module */
+
+#include "H5private.h"   /* Generic Functions        */
+#include "H5Eprivate.h"  /* Error handling           */
+#include "H5Fprivate.h"  /* File access              */
+#include "H5FDprivate.h" /* File drivers             */
+#include "H5FDmmap.h"    /* mmap file driver         */
+#include "H5FLprivate.h" /* Free Lists               */
+#include "H5Iprivate.h"  /* IDs                      */
+#include "H5Pprivate.h"  /* Property lists           */
+
+#ifdef H5_HAVE_MMAP
+
+#include <sys/mman.h>
+
+/* The driver identification number, initialized at runtime */
+static hid_t H5FD_MMAP_g = 0;
+
+/* Whether to ignore file locks when disabled (env var value) */
+static htri_t ignore_disabled_file_locks_s = FAIL;
+
+/* The description of a file belonging to this driver. 'map' is the read-only
+ * mapping of the first 'eof' bytes of the file (NULL for an empty file).
+ * The 'eoa' can be set past 'eof' by the library; reads there return zeros.
+ */
+typedef struct H5FD_mmap_t {
+    H5FD_t  pub; /* public stuff, must be first      */
+    int     fd;  /* the filesystem file descriptor   */
+    void   *map; /* start of the mapping             */
+    haddr_t eoa; /* end of allocated region          */
+    haddr_t eof; /* end of file; current file size   */
+    bool    ignore_disabled_file_locks;
+    char    filename[H5FD_MAX_FILENAME_LEN]; /* Copy of file name from open operation */
+    dev_t   device;                          /* file device number   */
+    ino_t   inode;                           /* file i-node number   */
+} H5FD_mmap_t;
+
+/*
+ * These macros check for overflow of various quantities, as in the sec2
+ * driver. The mapping cannot be larger than the address space either.
+ */
+#define MAXADDR          (((haddr_t)1 << (8 * sizeof(HDoff_t) - 1)) - 1)
+#define ADDR_OVERFLOW(A) (HADDR_UNDEF == (A) || ((A) & ~(haddr_t)MAXADDR))
+#define SIZE_OVERFLOW(Z) ((Z) & ~(hsize_t)MAXADDR)
+#define REGION_OVERFLOW(A, Z)                                                                                \
+    (ADDR_OVERFLOW(A) || SIZE_OVERFLOW(Z) || HADDR_UNDEF == (A) + (Z) || (HDoff_t)((A) + (Z)) < (HDoff_t)(A))
+
+/* Prototypes */
+static herr_t  H5FD__mmap_term(void);
+static H5FD_t *H5FD__mmap_open(const char *name, unsigned flags, hid_t fapl_id, haddr_t maxaddr);
+static herr_t  H5FD__mmap_close(H5FD_t *_file);
+static int     H5FD__mmap_cmp(const H5FD_t *_f1, const H5FD_t *_f2);
+static herr_t  H5FD__mmap_query(const H5FD_t *_f1, unsigned long *flags);
+static haddr_t H5FD__mmap_get_eoa(const H5FD_t *_file, H5FD_mem_t type);
+static herr_t  H5FD__mmap_set_eoa(H5FD_t *_file, H5FD_mem_t type, haddr_t addr);
+static haddr_t H5FD__mmap_get_eof(const H5FD_t *_file, H5FD_mem_t type);
+static herr_t  H5FD__mmap_get_handle(H5FD_t *_file, hid_t fapl, void **file_handle);
+static herr_t  H5FD__mmap_read(H5FD_t *_file, H5FD_mem_t type, hid_t fapl_id, haddr_t addr, size_t size,
+                               void *buf);
+static herr_t  H5FD__mmap_write(H5FD_t *_file, H5FD_mem_t type, hid_t fapl_id, haddr_t addr, size_t size,
+                                const void *buf);
+static herr_t  H5FD__mmap_truncate(H5FD_t *_file, hid_t dxpl_id, bool closing);
+static herr_t  H5FD__mmap_lock(H5FD_t *_file, bool rw);
+static herr_t  H5FD__mmap_unlock(H5FD_t *_file);
+static herr_t  H5FD__mmap_ctl(H5FD_t *_file, uint64_t op_code, uint64_t flags, const void *input,
+                              void **output);
+
+static const H5FD_class_t H5FD_mmap_g = {
+    H5FD_CLASS_VERSION,    /* struct version       */
+    H5FD_MMAP_VALUE,       /* value                */
+    "mmap",                /* name                 */
+    MAXADDR,               /* maxaddr              */
+    H5F_CLOSE_WEAK,        /* fc_degree            */
+    H5FD__mmap_term,       /* terminate            */
+    NULL,                  /* sb_size              */
+    NULL,                  /* sb_encode            */
+    NULL,                  /* sb_decode            */
+    0,                     /* fapl_size            */
+    NULL,                  /* fapl_get             */
+    NULL,                  /* fapl_copy            */
+    NULL,                  /* fapl_free            */
+    0,                     /* dxpl_size            */
+    NULL,                  /* dxpl_copy            */
+    NULL,                  /* dxpl_free            */
+    H5FD__mmap_open,       /* open                 */
+    H5FD__mmap_close,      /* close                */
+    H5FD__mmap_cmp,        /* cmp                  */
+    H5FD__mmap_query,      /* query                */
+    NULL,                  /* get_type_map         */
+    NULL,                  /* alloc                */
+    NULL,                  /* free                 */
+    H5FD__mmap_get_eoa,    /* get_eoa              */
+    H5FD__mmap_set_eoa,    /* set_eoa              */
+    H5FD__mmap_get_eof,    /* get_eof              */
+    H5FD__mmap_get_handle, /* get_handle           */
+    H5FD__mmap_read,       /* read                 */
+    H5FD__mmap_write,      /* write                */
+    NULL,                  /* read_vector          */
+    NULL,                  /* write_vector         */
+    NULL,                  /* read_selection       */
+    NULL,                  /* write_selection      */
+    NULL,                  /* flush                */
+    H5FD__mmap_truncate,   /* truncate             */
+    H5FD__mmap_lock,       /* lock                 */
+    H5FD__mmap_unlock,     /* unlock               */
+    NULL,                  /* del                  */
+    H5FD__mmap_ctl,        /* ctl                  */
+    H5FD_FLMAP_DICHOTOMY   /* fl_map               */
+};
+
+/* Declare a free list to manage the H5FD_mmap_t struct */
+H5FL_DEFINE_STATIC(H5FD_mmap_t);
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_mmap_init
+ *
+ * Purpose:     Initialize this driver by registering the driver with the
+ *              library.
+ *
+ * Return:      Success:    The driver ID for the mmap driver
+ *              Failure:    H5I_INVALID_HID
+ *
+ *-------------------------------------------------------------------------
+ */
+hid_t
+H5FD_mmap_init(void)
+{
+    char *lock_env_var = NULL;            /* Environment variable pointer */
+    hid_t ret_value    = H5I_INVALID_HID; /* Return value */
+
+    FUNC_ENTER_NOAPI_NOERR
+
+    /* Check the use disabled file locks environment variable */
+    lock_env_var = getenv(HDF5_USE_FILE_LOCKING);
+    if (lock_env_var && !strcmp(lock_env_var, "BEST_EFFORT"))
+        ignore_disabled_file_locks_s = true; /* Override: Ignore disabled locks */
+    else if (lock_env_var && (!strcmp(lock_env_var, "TRUE") || !strcmp(lock_env_var, "1")))
+        ignore_disabled_file_locks_s = false; /* Override: Don't ignore disabled locks */
+    else
+        ignore_disabled_file_locks_s = FAIL; /* Environment variable not set, or not set correctly */
+
+    if (H5I_VFL != H5I_get_type(H5FD_MMAP_g))
+        H5FD_MMAP_g = H5FD_register(&H5FD_mmap_g, sizeof(H5FD_class_t), false);
+
+    /* Set return value */
+    ret_value = H5FD_MMAP_g;
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_mmap_init() */
+
+/*---------------------------------------------------------------------------
+ * Function:    H5FD__mmap_term
+ *
+ * Purpose:     Shut down the VFD
+ *
+ * Returns:     SUCCEED (Can't fail)
+ *
+ *---------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__mmap_term(void)
+{
+    FUNC_ENTER_PACKAGE_NOERR
+
+    /* Reset VFL ID */
+    H5FD_MMAP_g = 0;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD__mmap_term() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pset_fapl_mmap
+ *
+ * Purpose:     Modify the file access property list to use the H5FD_MMAP
+ *              driver defined in this source file.  There are no driver
+ *              specific properties.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pset_fapl_mmap(hid_t fapl_id)
+{
+    H5P_genplist_t *plist; /* Property list pointer */
+    herr_t          ret_value;
+
+    FUNC_ENTER_API(FAIL)
+
+    if (NULL == (plist = H5P_object_verify(fapl_id, H5P_FILE_ACCESS)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a file access property list");
+
+    ret_value = H5P_set_driver(plist, H5FD_MMAP, NULL, NULL);
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pset_fapl_mmap() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__mmap_open
+ *
+ * Purpose:     Opens an existing HDF5 file read-only and maps it.
+ *
+ * Return:      Success:    A pointer to a new file data structure. The
+ *                          public fields will be initialized by the
+ *                          caller, which is always H5FD_open().
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5FD_t *
+H5FD__mmap_open(const char *name, unsigned flags, hid_t fapl_id, haddr_t maxaddr)
+{
+    H5FD_mmap_t    *file = NULL; /* mmap VFD info            */
+    int             fd   = -1;   /* File descriptor          */
+    void           *map  = NULL; /* File mapping             */
+    size_t          size = 0;    /* Size of the mapping      */
+    h5_stat_t       sb;
+    H5P_genplist_t *plist;            /* Property list pointer */
+    H5FD_t         *ret_value = NULL; /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    /* Check arguments */
+    if (!name || !*name)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, NULL, "invalid file name");
+    if (0 == maxaddr || HADDR_UNDEF == maxaddr)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADRANGE, NULL, "bogus maxaddr");
+    if (ADDR_OVERFLOW(maxaddr))
+        HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, NULL, "bogus maxaddr");
+    if ((H5F_ACC_RDWR | H5F_ACC_TRUNC | H5F_ACC_CREAT | H5F_ACC_EXCL) & flags)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, NULL, "mmap driver is read-only");
+
+    /* Open the file */
+    if ((fd = HDopen(name, O_RDONLY, H5_POSIX_CREATE_MODE_RW)) < 0) {
+        int myerrno = errno;
+        HGOTO_ERROR(H5E_FILE, H5E_CANTOPENFILE, NULL,
+                    "unable to open file: name = '%s', errno = %d, error message = '%s', flags = %x", name,
+                    myerrno, strerror(myerrno), flags);
+    } /* end if */
+
+    memset(&sb, 0, sizeof(h5_stat_t));
+    if (HDfstat(fd, &sb) < 0)
+        HSYS_GOTO_ERROR(H5E_FILE, H5E_BADFILE, NULL, "unable to fstat file");
+
+    /* Map the whole file. An empty file is not mapped */
+    if ((uint64_t)sb.st_size > (uint64_t)SIZE_MAX)
+        HGOTO_ERROR(H5E_FILE, H5E_OVERFLOW, NULL, "file is too large to be mapped");
+    size = (size_t)sb.st_size;
+    if (size > 0)
+        if (MAP_FAILED == (map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0))) {
+            map = NULL;
+            HSYS_GOTO_ERROR(H5E_FILE, H5E_CANTOPENFILE, NULL, "unable to map file");
+        }
+
+    /* Create the new file struct */
+    if (NULL == (file = H5FL_CALLOC(H5FD_mmap_t)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "unable to allocate file struct");
+
+    file->fd  = fd;
+    file->map = map;
+    H5_CHECKED_ASSIGN(file->eof, haddr_t, sb.st_size, h5_stat_size_t);
+    file->device = sb.st_dev;
+    file->inode  = sb.st_ino;
+
+    /* Get the FAPL */
+    if (NULL == (plist = (H5P_genplist_t *)H5I_object(fapl_id)))
+        HGOTO_ERROR(H5E_VFL, H5E_BADTYPE, NULL, "not a file access property list");
+
+    /* Check the file locking flags in the fapl */
+    if (ignore_disabled_file_locks_s != FAIL)
+        /* The environment variable was set, so use that preferentially */
+        file->ignore_disabled_file_locks = ignore_disabled_file_locks_s;
+    else {
+        /* Use the value in the property list */
+        if (H5P_get(plist, H5F_ACS_IGNORE_DISABLED_FILE_LOCKS_NAME, &file->ignore_disabled_file_locks) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTGET, NULL, "can't get ignore disabled file locks property");
+    }
+
+    /* Retain a copy of the name used to open the file, for possible error reporting */
+    strncpy(file->filename, name, sizeof(file->filename) - 1);
+    file->filename[sizeof(file->filename) - 1] = '\0';
+
+    /* Set return value */
+    ret_value = (H5FD_t *)file;
+
+done:
+    if (NULL == ret_value) {
+        if (map)
+            munmap(map, size);
+        if (fd >= 0)
+            HDclose(fd);
+        if (file)
+            file = H5FL_FREE(H5FD_mmap_t, file);
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__mmap_open() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__mmap_close
+ *
+ * Purpose:     Unmaps and closes an HDF5 file.
+ *
+ * Return:      Success:    SUCCEED
+ *              Failure:    FAIL, file not closed.
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__mmap_close(H5FD_t *_file)
+{
+    H5FD_mmap_t *file      = (H5FD_mmap_t *)_file;
+    herr_t       ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    /* Sanity check */
+    assert(file);
+
+    /* Release the mapping and close the underlying file */
+    if (file->map && munmap(file->map, (size_t)file->eof) < 0)
+        HSYS_GOTO_ERROR(H5E_IO, H5E_CANTCLOSEFILE, FAIL, "unable to unmap file");
+    if (HDclose(file->fd) < 0)
+        HSYS_GOTO_ERROR(H5E_IO, H5E_CANTCLOSEFILE, FAIL, "unable to close file");
+
+    /* Release the file info */
+    file = H5FL_FREE(H5FD_mmap_t, file);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__mmap_close() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__mmap_cmp
+ *
+ * Purpose:     Compares two files belonging to this driver using an
+ *              arbitrary (but consistent) ordering.
+ *
+ * Return:      Success:    A value like strcmp()
+ *              Failure:    never fails (arguments were checked by the
+ *                          caller).
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+H5FD__mmap_cmp(const H5FD_t *_f1, const H5FD_t *_f2)
+{
+    const H5FD_mmap_t *f1        = (const H5FD_mmap_t *)_f1;
+    const H5FD_mmap_t *f2        = (const H5FD_mmap_t *)_f2;
+    int                ret_value = 0;
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+#ifdef H5_DEV_T_IS_SCALAR
+    if (f1->device < f2->device)
+        HGOTO_DONE(-1);
+    if (f1->device > f2->device)
+        HGOTO_DONE(1);
+#else  /* H5_DEV_T_IS_SCALAR */
+    if (memcmp(&(f1->device), &(f2->device), sizeof(dev_t)) < 0)
+        HGOTO_DONE(-1);
+    if (memcmp(&(f1->device), &(f2->device), sizeof(dev_t)) > 0)
+        HGOTO_DONE(1);
+#endif /* H5_DEV_T_IS_SCALAR */
+    if (f1->inode < f2->inode)
+        HGOTO_DONE(-1);
+    if (f1->inode > f2->inode)
+        HGOTO_DONE(1);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__mmap_cmp() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__mmap_query
+ *
+ * Purpose:     Set the flags that this VFL driver is capable of supporting.
+ *              (listed in H5FDpublic.h)
+ *
+ *              Data sieving and the metadata accumulator are not enabled:
+ *              they would only add a copy on top of the mapping.
+ *
+ * Return:      SUCCEED (Can't fail)
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__mmap_query(const H5FD_t H5_ATTR_UNUSED *_file, unsigned long *flags /* out */)
+{
+    FUNC_ENTER_PACKAGE_NOERR
+
+    /* Set the VFL feature flags that this driver supports */
+    if (flags) {
+        *flags = 0;
+        *flags |= H5FD_FEAT_DEFAULT_VFD_COMPATIBLE; /* The file can be opened with the default VFD */
+    }                                               /* end if */
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD__mmap_query() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__mmap_get_eoa
+ *
+ * Purpose:     Gets the end-of-address marker for the file. The EOA marker
+ *              is the first address past the last byte allocated in the
+ *              format address space.
+ *
+ * Return:      The end-of-address marker.
+ *
+ *-------------------------------------------------------------------------
+ */
+static haddr_t
+H5FD__mmap_get_eoa(const H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type)
+{
+    const H5FD_mmap_t *file = (const H5FD_mmap_t *)_file;
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    FUNC_LEAVE_NOAPI(file->eoa)
+} /* end H5FD__mmap_get_eoa() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__mmap_set_eoa
+ *
+ * Purpose:     Set the end-of-address marker for the file. This function is
+ *              called shortly after an existing HDF5 file is opened in order
+ *              to tell the driver where the end of the HDF5 data is located.
+ *
+ * Return:      SUCCEED (Can't fail)
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__mmap_set_eoa(H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type, haddr_t addr)
+{
+    H5FD_mmap_t *file = (H5FD_mmap_t *)_file;
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    file->eoa = addr;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD__mmap_set_eoa() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__mmap_get_eof
+ *
+ * Purpose:     Returns the end-of-file marker, the size of the file when
+ *              it was mapped.
+ *
+ * Return:      End of file address.
+ *
+ *-------------------------------------------------------------------------
+ */
+static haddr_t
+H5FD__mmap_get_eof(const H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type)
+{
+    const H5FD_mmap_t *file = (const H5FD_mmap_t *)_file;
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    FUNC_LEAVE_NOAPI(file->eof)
+} /* end H5FD__mmap_get_eof() */
+
+/*-------------------------------------------------------------------------
+ * Function:       H5FD__mmap_get_handle
+ *
+ * Purpose:        Returns the address of the mapping, as the core driver
+ *                 does with its memory image.
+ *
+ * Returns:        SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__mmap_get_handle(H5FD_t *_file, hid_t H5_ATTR_UNUSED fapl, void **file_handle)
+{
+    H5FD_mmap_t *file      = (H5FD_mmap_t *)_file;
+    herr_t       ret_value = SUCCEED;
+
+    FUNC_ENTER_PACKAGE
+
+    if (!file_handle)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "file handle not valid");
+
+    *file_handle = &(file->map);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__mmap_get_handle() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__mmap_read
+ *
+ * Purpose:     Reads SIZE bytes of data from FILE beginning at address ADDR
+ *              into buffer BUF. The bytes past the end of the file are
+ *              returned as zeros.
+ *
+ * Return:      Success:    SUCCEED. Result is stored in caller-supplied
+ *                          buffer BUF.
+ *              Failure:    FAIL, Contents of buffer BUF are undefined.
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__mmap_read(H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type, hid_t H5_ATTR_UNUSED dxpl_id, haddr_t addr,
+                size_t size, void *buf /*out*/)
+{
+    H5FD_mmap_t *file      = (H5FD_mmap_t *)_file;
+    herr_t       ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    assert(file && file->pub.cls);
+    assert(buf);
+
+    /* Check for overflow conditions */
+    if (!H5_addr_defined(addr))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "addr undefined, addr = %llu", (unsigned long long)addr);
+    if (REGION_OVERFLOW(addr, size))
+        HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, FAIL, "addr overflow, addr = %llu", (unsigned long long)addr);
+
+    /* Copy the part inside the file and clear the rest */
+    if (addr < file->eof) {
+        size_t nbytes = (size_t)MIN(size, file->eof - addr);
+
+        H5MM_memcpy(buf, (const uint8_t *)file->map + addr, nbytes);
+        size -= nbytes;
+        buf = (uint8_t *)buf + nbytes;
+    }
+    if (size > 0)
+        memset(buf, 0, size);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__mmap_read() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__mmap_write
+ *
+ * Purpose:     The mapping is read-only.
+ *
+ * Return:      FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__mmap_write(H5FD_t H5_ATTR_UNUSED *_file, H5FD_mem_t H5_ATTR_UNUSED type, hid_t H5_ATTR_UNUSED dxpl_id,
+                 haddr_t H5_ATTR_UNUSED addr, size_t H5_ATTR_UNUSED size, const void H5_ATTR_UNUSED *buf)
+{
+    herr_t ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    HGOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL, "cannot write to a file opened with the mmap driver");
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__mmap_write() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__mmap_truncate
+ *
+ * Purpose:     Nothing to do, as the file is never written.
+ *
+ * Return:      SUCCEED (Can't fail)
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__mmap_truncate(H5FD_t H5_ATTR_UNUSED *_file, hid_t H5_ATTR_UNUSED dxpl_id, bool H5_ATTR_UNUSED closing)
+{
+    FUNC_ENTER_PACKAGE_NOERR
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD__mmap_truncate() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__mmap_lock
+ *
+ * Purpose:     To place an advisory lock on a file.
+ *		The lock type to apply depends on the parameter "rw":
+ *			true--opens for write: an exclusive lock
+ *			false--opens for read: a shared lock
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__mmap_lock(H5FD_t *_file, bool rw)
+{
+    H5FD_mmap_t *file = (H5FD_mmap_t *)_file; /* VFD file struct          */
+    int          lock_flags;                  /* file locking flags       */
+    herr_t       ret_value = SUCCEED;         /* Return value             */
+
+    FUNC_ENTER_PACKAGE
+
+    assert(file);
+
+    /* Set exclusive or shared lock based on rw status */
+    lock_flags = rw ? LOCK_EX : LOCK_SH;
+
+    /* Place a non-blocking lock on the file */
+    if (HDflock(file->fd, lock_flags | LOCK_NB) < 0) {
+        if (file->ignore_disabled_file_locks && ENOSYS == errno) {
+            /* When errno is set to ENOSYS, the file system does not support
+             * locking, so ignore it.
+             */
+            errno = 0;
+        }
+        else
+            HSYS_GOTO_ERROR(H5E_VFL, H5E_CANTLOCKFILE, FAIL, "unable to lock file");
+    }
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__mmap_lock() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__mmap_unlock
+ *
+ * Purpose:     To remove the existing lock on the file
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__mmap_unlock(H5FD_t *_file)
+{
+    H5FD_mmap_t *file      = (H5FD_mmap_t *)_file; /* VFD file struct          */
+    herr_t       ret_value = SUCCEED;              /* Return value             */
+
+    FUNC_ENTER_PACKAGE
+
+    assert(file);
+
+    if (HDflock(file->fd, LOCK_UN) < 0) {
+        if (file->ignore_disabled_file_locks && ENOSYS == errno) {
+            /* When errno is set to ENOSYS, the file system does not support
+             * locking, so ignore it.
+             */
+            errno = 0;
+        }
+        else
+            HSYS_GOTO_ERROR(H5E_VFL, H5E_CANTUNLOCKFILE, FAIL, "unable to unlock file");
+    }
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__mmap_unlock() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__mmap_ctl
+ *
+ * Purpose:     mmap VFD version of the ctl callback.
+ *
+ *              At present, no op codes are supported by this VFD.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__mmap_ctl(H5FD_t H5_ATTR_UNUSED *_file, uint64_t H5_ATTR_UNUSED op_code, uint64_t flags,
+               const void H5_ATTR_UNUSED *input, void H5_ATTR_UNUSED **output)
+{
+    herr_t ret_value = SUCCEED;
+
+    FUNC_ENTER_PACKAGE
+
+    /* No op codes are understood. */
+    if (flags & H5FD_CTL_FAIL_IF_UNKNOWN_FLAG)
+        HGOTO_ERROR(H5E_VFL, H5E_FCNTL, FAIL, "unknown op_code and fail if unknown flag is set");
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__mmap_ctl() */
+
+#endif /* H5_HAVE_MMAP */
@@ -0,0 +1,75 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://www.hdfgroup.org/licenses.               *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose:	The public header file for the read-only memory-mapped (mmap)
+ *          virtual file driver (VFD)
+ */
+#ifndef H5FDmmap_H
+#define H5FDmmap_H
+
+#ifdef H5_HAVE_MMAP
+
+/** Initializer for the mmap VFD */
+#define H5FD_MMAP (H5FDperform_init(H5FD_mmap_init))
+
+/** Identifier for the mmap VFD */
+#define H5FD_MMAP_VALUE H5_VFD_MMAP
+
+#else
+
+/** Initializer for the mmap VFD (disabled) */
+#define H5FD_MMAP       (H5I_INVALID_HID)
+
+/** Identifier for the mmap VFD (disabled) */
+#define H5FD_MMAP_VALUE H5_VFD_INVALID
+
+#endif /* H5_HAVE_MMAP */
+
+#ifdef H5_HAVE_MMAP
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @private
+ *
+ * \brief Private initializer for the mmap VFD
+ */
+H5_DLL hid_t H5FD_mmap_init(void);
+
+/**
+ * \ingroup FAPL
+ *
+ * \brief Modifies the file access property list to use the #H5FD_MMAP driver
+ *
+ * \fapl_id
+ *
+ * \returns \herr_t
+ *
+ * \details H5Pset_fapl_mmap() modifies the file access property list to use the
+ *          #H5FD_MMAP driver. The file is mapped read-only when it is opened and
+ *          reads are served by copying from the mapping, so files cannot be
+ *          created or opened for writing with this driver.
+ *
+ *          As with the core driver, H5Fget_vfd_handle() returns a pointer to the
+ *          address of the mapping (a `void **`). The mapping stays valid until
+ *          the file is closed.
+ *
+ */
+H5_DLL herr_t H5Pset_fapl_mmap(hid_t fapl_id);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* H5_HAVE_MMAP */
+
+#endif
@@ -57,6 +57,26 @@
 #define H5D_ACS_PREEMPT_READ_CHUNKS_DEF  H5D_CHUNK_CACHE_W0_DEFAULT
 #define H5D_ACS_PREEMPT_READ_CHUNKS_ENC  H5P__encode_double
 #define H5D_ACS_PREEMPT_READ_CHUNKS_DEC  H5P__decode_double
+/* Definitions for slot lookup of raw data chunk cache */
+#define H5D_ACS_DATA_CACHE_HASH_SIZE sizeof(H5D_chunk_cache_hash_t)
+#define H5D_ACS_DATA_CACHE_HASH_DEF  H5D_CHUNK_CACHE_HASH_DIRECT
+#define H5D_ACS_DATA_CACHE_HASH_ENC  H5P__dacc_chunk_cache_hash_enc
+#define H5D_ACS_DATA_CACHE_HASH_DEC  H5P__dacc_chunk_cache_hash_dec
+/* Definitions for preemption policy of raw data chunk cache */
+#define H5D_ACS_DATA_CACHE_POLICY_SIZE sizeof(H5D_chunk_cache_policy_t)
+#define H5D_ACS_DATA_CACHE_POLICY_DEF  H5D_CHUNK_CACHE_POLICY_W0
+#define H5D_ACS_DATA_CACHE_POLICY_ENC  H5P__dacc_chunk_cache_policy_enc
+#define H5D_ACS_DATA_CACHE_POLICY_DEC  H5P__dacc_chunk_cache_policy_dec
+/* Definitions for snapshot of the chunk index */
+#define H5D_ACS_CHUNK_IDX_SNAPSHOT_SIZE sizeof(bool)
+#define H5D_ACS_CHUNK_IDX_SNAPSHOT_DEF  false
+#define H5D_ACS_CHUNK_IDX_SNAPSHOT_ENC  H5P__encode_bool
+#define H5D_ACS_CHUNK_IDX_SNAPSHOT_DEC  H5P__decode_bool
+/* Definitions for read-ahead of raw data chunk cache */
+#define H5D_ACS_DATA_CACHE_PREFETCH_SIZE sizeof(unsigned)
+#define H5D_ACS_DATA_CACHE_PREFETCH_DEF  0
+#define H5D_ACS_DATA_CACHE_PREFETCH_ENC  H5P__encode_unsigned
+#define H5D_ACS_DATA_CACHE_PREFETCH_DEC  H5P__decode_unsigned
 /* Definitions for VDS view option */
 #define H5D_ACS_VDS_VIEW_SIZE sizeof(H5D_vds_view_t)
 #define H5D_ACS_VDS_VIEW_DEF  H5D_VDS_LAST_AVAILABLE
@@ -117,6 +137,10 @@ static herr_t H5P__encode_chunk_cache_nbytes(const void *value, void **_pp, size
 static herr_t H5P__decode_chunk_cache_nbytes(const void **_pp, void *_value);
 
 /* Property list callbacks */
+static herr_t H5P__dacc_chunk_cache_hash_enc(const void *value, void **pp, size_t *size);
+static herr_t H5P__dacc_chunk_cache_hash_dec(const void **pp, void *value);
+static herr_t H5P__dacc_chunk_cache_policy_enc(const void *value, void **pp, size_t *size);
+static herr_t H5P__dacc_chunk_cache_policy_dec(const void **pp, void *value);
 static herr_t H5P__dacc_vds_view_enc(const void *value, void **pp, size_t *size);
 static herr_t H5P__dacc_vds_view_dec(const void **pp, void *value);
 static herr_t H5P__dapl_vds_file_pref_set(hid_t prop_id, const char *name, size_t size, void *value);
@@ -191,6 +215,10 @@ H5P__dacc_reg_prop(H5P_genclass_t *pclass)
     size_t rdcc_nslots = H5D_ACS_DATA_CACHE_NUM_SLOTS_DEF;    /* Default raw data chunk cache # of slots */
     size_t rdcc_nbytes = H5D_ACS_DATA_CACHE_BYTE_SIZE_DEF;    /* Default raw data chunk cache # of bytes */
     double rdcc_w0     = H5D_ACS_PREEMPT_READ_CHUNKS_DEF;     /* Default raw data chunk cache dirty ratio */
+    H5D_chunk_cache_hash_t   rdcc_hash     = H5D_ACS_DATA_CACHE_HASH_DEF;     /* Default chunk cache lookup */
+    H5D_chunk_cache_policy_t rdcc_policy   = H5D_ACS_DATA_CACHE_POLICY_DEF;   /* Default chunk cache policy */
+    bool                     idx_snapshot  = H5D_ACS_CHUNK_IDX_SNAPSHOT_DEF;  /* Default index snapshot */
+    unsigned                 rdcc_prefetch = H5D_ACS_DATA_CACHE_PREFETCH_DEF; /* Default chunk read-ahead */
     H5D_vds_view_t virtual_view = H5D_ACS_VDS_VIEW_DEF;       /* Default VDS view option */
     hsize_t        printf_gap   = H5D_ACS_VDS_PRINTF_GAP_DEF; /* Default VDS printf gap */
     herr_t         ret_value    = SUCCEED;                    /* Return value */
@@ -215,6 +243,30 @@ H5P__dacc_reg_prop(H5P_genclass_t *pclass)
                            H5D_ACS_PREEMPT_READ_CHUNKS_DEC, NULL, NULL, NULL, NULL) < 0)
         HGOTO_ERROR(H5E_PLIST, H5E_CANTINSERT, FAIL, "can't insert property into class");
 
+    /* Register the slot lookup of the raw data chunk cache */
+    if (H5P__register_real(pclass, H5D_ACS_DATA_CACHE_HASH_NAME, H5D_ACS_DATA_CACHE_HASH_SIZE, &rdcc_hash,
+                           NULL, NULL, NULL, H5D_ACS_DATA_CACHE_HASH_ENC, H5D_ACS_DATA_CACHE_HASH_DEC, NULL,
+                           NULL, NULL, NULL) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTINSERT, FAIL, "can't insert property into class");
+
+    /* Register the preemption policy of the raw data chunk cache */
+    if (H5P__register_real(pclass, H5D_ACS_DATA_CACHE_POLICY_NAME, H5D_ACS_DATA_CACHE_POLICY_SIZE,
+                           &rdcc_policy, NULL, NULL, NULL, H5D_ACS_DATA_CACHE_POLICY_ENC,
+                           H5D_ACS_DATA_CACHE_POLICY_DEC, NULL, NULL, NULL, NULL) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTINSERT, FAIL, "can't insert property into class");
+
+    /* Register the snapshot of the chunk index */
+    if (H5P__register_real(pclass, H5D_ACS_CHUNK_IDX_SNAPSHOT_NAME, H5D_ACS_CHUNK_IDX_SNAPSHOT_SIZE,
+                           &idx_snapshot, NULL, NULL, NULL, H5D_ACS_CHUNK_IDX_SNAPSHOT_ENC,
+                           H5D_ACS_CHUNK_IDX_SNAPSHOT_DEC, NULL, NULL, NULL, NULL) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTINSERT, FAIL, "can't insert property into class");
+
+    /* Register the read-ahead of the raw data chunk cache */
+    if (H5P__register_real(pclass, H5D_ACS_DATA_CACHE_PREFETCH_NAME, H5D_ACS_DATA_CACHE_PREFETCH_SIZE,
+                           &rdcc_prefetch, NULL, NULL, NULL, H5D_ACS_DATA_CACHE_PREFETCH_ENC,
+                           H5D_ACS_DATA_CACHE_PREFETCH_DEC, NULL, NULL, NULL, NULL) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTINSERT, FAIL, "can't insert property into class");
+
     /* Register the VDS view option */
     if (H5P__register_real(pclass, H5D_ACS_VDS_VIEW_NAME, H5D_ACS_VDS_VIEW_SIZE, &virtual_view, NULL, NULL,
                            NULL, H5D_ACS_VDS_VIEW_ENC, H5D_ACS_VDS_VIEW_DEC, NULL, NULL, NULL, NULL) < 0)
@@ -846,6 +898,314 @@ done:
     FUNC_LEAVE_API(ret_value)
 } /* end H5Pget_chunk_cache() */
 
+/*-------------------------------------------------------------------------
+ * Function:    H5Pset_chunk_cache_policy
+ *
+ * Purpose:     Sets how the raw data chunk cache of a dataset finds its
+ *              chunks, HASH, and which chunks it preempts first, POLICY.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pset_chunk_cache_policy(hid_t dapl_id, H5D_chunk_cache_hash_t hash, H5D_chunk_cache_policy_t policy)
+{
+    H5P_genplist_t *plist;               /* Property list pointer */
+    herr_t          ret_value = SUCCEED; /* return value */
+
+    FUNC_ENTER_API(FAIL)
+
+    /* Check arguments */
+    if (hash != H5D_CHUNK_CACHE_HASH_DIRECT && hash != H5D_CHUNK_CACHE_HASH_OPEN)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "not a valid chunk cache lookup");
+    if (policy != H5D_CHUNK_CACHE_POLICY_W0 && policy != H5D_CHUNK_CACHE_POLICY_2Q)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "not a valid chunk cache policy");
+
+    /* Get the plist structure */
+    if (NULL == (plist = H5P_object_verify(dapl_id, H5P_DATASET_ACCESS)))
+        HGOTO_ERROR(H5E_ID, H5E_BADID, FAIL, "can't find object for ID");
+
+    /* Update property list */
+    if (H5P_set(plist, H5D_ACS_DATA_CACHE_HASH_NAME, &hash) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "unable to set chunk cache lookup");
+    if (H5P_set(plist, H5D_ACS_DATA_CACHE_POLICY_NAME, &policy) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "unable to set chunk cache policy");
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pset_chunk_cache_policy() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pget_chunk_cache_policy
+ *
+ * Purpose:     Retrieves the values set with H5Pset_chunk_cache_policy.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pget_chunk_cache_policy(hid_t dapl_id, H5D_chunk_cache_hash_t *hash /*out*/,
+                          H5D_chunk_cache_policy_t *policy /*out*/)
+{
+    H5P_genplist_t *plist;               /* Property list pointer */
+    herr_t          ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+
+    /* Get the plist structure */
+    if (NULL == (plist = H5P_object_verify(dapl_id, H5P_DATASET_ACCESS)))
+        HGOTO_ERROR(H5E_ID, H5E_BADID, FAIL, "can't find object for ID");
+
+    /* Get values from property list */
+    if (hash)
+        if (H5P_get(plist, H5D_ACS_DATA_CACHE_HASH_NAME, hash) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "unable to get chunk cache lookup");
+    if (policy)
+        if (H5P_get(plist, H5D_ACS_DATA_CACHE_POLICY_NAME, policy) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "unable to get chunk cache policy");
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pget_chunk_cache_policy() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pset_chunk_index_snapshot
+ *
+ * Purpose:     Sets whether the chunk index of a dataset opened read-only
+ *              is loaded once into memory, so that the address of each
+ *              chunk is found without going through the index.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pset_chunk_index_snapshot(hid_t dapl_id, bool snapshot)
+{
+    H5P_genplist_t *plist;               /* Property list pointer */
+    herr_t          ret_value = SUCCEED; /* return value */
+
+    FUNC_ENTER_API(FAIL)
+
+    /* Get the plist structure */
+    if (NULL == (plist = H5P_object_verify(dapl_id, H5P_DATASET_ACCESS)))
+        HGOTO_ERROR(H5E_ID, H5E_BADID, FAIL, "can't find object for ID");
+
+    /* Update property list */
+    if (H5P_set(plist, H5D_ACS_CHUNK_IDX_SNAPSHOT_NAME, &snapshot) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "unable to set value");
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pset_chunk_index_snapshot() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pget_chunk_index_snapshot
+ *
+ * Purpose:     Retrieves the value set with H5Pset_chunk_index_snapshot.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pget_chunk_index_snapshot(hid_t dapl_id, bool *snapshot /*out*/)
+{
+    H5P_genplist_t *plist;               /* Property list pointer */
+    herr_t          ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+
+    /* Get the plist structure */
+    if (NULL == (plist = H5P_object_verify(dapl_id, H5P_DATASET_ACCESS)))
+        HGOTO_ERROR(H5E_ID, H5E_BADID, FAIL, "can't find object for ID");
+
+    /* Get value from property list */
+    if (snapshot)
+        if (H5P_get(plist, H5D_ACS_CHUNK_IDX_SNAPSHOT_NAME, snapshot) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "unable to get value");
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pget_chunk_index_snapshot() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pset_chunk_prefetch
+ *
+ * Purpose:     Sets the number of chunks that are read ahead into the
+ *              chunk cache when a dataset is read chunk after chunk in
+ *              storage order.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pset_chunk_prefetch(hid_t dapl_id, unsigned nchunks)
+{
+    H5P_genplist_t *plist;               /* Property list pointer */
+    herr_t          ret_value = SUCCEED; /* return value */
+
+    FUNC_ENTER_API(FAIL)
+
+    /* Get the plist structure */
+    if (NULL == (plist = H5P_object_verify(dapl_id, H5P_DATASET_ACCESS)))
+        HGOTO_ERROR(H5E_ID, H5E_BADID, FAIL, "can't find object for ID");
+
+    /* Update property list */
+    if (H5P_set(plist, H5D_ACS_DATA_CACHE_PREFETCH_NAME, &nchunks) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "unable to set value");
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pset_chunk_prefetch() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pget_chunk_prefetch
+ *
+ * Purpose:     Retrieves the value set with H5Pset_chunk_prefetch.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pget_chunk_prefetch(hid_t dapl_id, unsigned *nchunks /*out*/)
+{
+    H5P_genplist_t *plist;               /* Property list pointer */
+    herr_t          ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+
+    /* Get the plist structure */
+    if (NULL == (plist = H5P_object_verify(dapl_id, H5P_DATASET_ACCESS)))
+        HGOTO_ERROR(H5E_ID, H5E_BADID, FAIL, "can't find object for ID");
+
+    /* Get value from property list */
+    if (nchunks)
+        if (H5P_get(plist, H5D_ACS_DATA_CACHE_PREFETCH_NAME, nchunks) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "unable to get value");
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pget_chunk_prefetch() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5P__dacc_chunk_cache_hash_enc
+ *
+ * Purpose:     Callback routine which is called whenever the chunk cache
+ *              lookup property in the dataset access property list is
+ *              encoded.
+ *
+ * Return:      Success:        Non-negative
+ *              Failure:        Negative
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5P__dacc_chunk_cache_hash_enc(const void *value, void **_pp, size_t *size)
+{
+    const H5D_chunk_cache_hash_t *hash = (const H5D_chunk_cache_hash_t *)value;
+    uint8_t                     **pp   = (uint8_t **)_pp;
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    /* Sanity check */
+    assert(hash);
+    assert(size);
+
+    if (NULL != *pp)
+        *(*pp)++ = (uint8_t)*hash;
+
+    (*size)++;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5P__dacc_chunk_cache_hash_enc() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5P__dacc_chunk_cache_hash_dec
+ *
+ * Purpose:     Callback routine which is called whenever the chunk cache
+ *              lookup property in the dataset access property list is
+ *              decoded.
+ *
+ * Return:      Success:        Non-negative
+ *              Failure:        Negative
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5P__dacc_chunk_cache_hash_dec(const void **_pp, void *_value)
+{
+    H5D_chunk_cache_hash_t *hash = (H5D_chunk_cache_hash_t *)_value;
+    const uint8_t         **pp   = (const uint8_t **)_pp;
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    /* Sanity checks */
+    assert(pp);
+    assert(*pp);
+    assert(hash);
+
+    *hash = (H5D_chunk_cache_hash_t) * (*pp)++;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5P__dacc_chunk_cache_hash_dec() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5P__dacc_chunk_cache_policy_enc
+ *
+ * Purpose:     Callback routine which is called whenever the chunk cache
+ *              policy property in the dataset access property list is
+ *              encoded.
+ *
+ * Return:      Success:        Non-negative
+ *              Failure:        Negative
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5P__dacc_chunk_cache_policy_enc(const void *value, void **_pp, size_t *size)
+{
+    const H5D_chunk_cache_policy_t *policy = (const H5D_chunk_cache_policy_t *)value;
+    uint8_t                       **pp     = (uint8_t **)_pp;
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    /* Sanity check */
+    assert(policy);
+    assert(size);
+
+    if (NULL != *pp)
+        *(*pp)++ = (uint8_t)*policy;
+
+    (*size)++;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5P__dacc_chunk_cache_policy_enc() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5P__dacc_chunk_cache_policy_dec
+ *
+ * Purpose:     Callback routine which is called whenever the chunk cache
+ *              policy property in the dataset access property list is
+ *              decoded.
+ *
+ * Return:      Success:        Non-negative
+ *              Failure:        Negative
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5P__dacc_chunk_cache_policy_dec(const void **_pp, void *_value)
+{
+    H5D_chunk_cache_policy_t *policy = (H5D_chunk_cache_policy_t *)_value;
+    const uint8_t           **pp     = (const uint8_t **)_pp;
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    /* Sanity checks */
+    assert(pp);
+    assert(*pp);
+    assert(policy);
+
+    *policy = (H5D_chunk_cache_policy_t) * (*pp)++;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5P__dacc_chunk_cache_policy_dec() */
+
 /*-------------------------------------------------------------------------
  * Function:       H5P__encode_chunk_cache_nslots
  *
@@ -56,6 +56,12 @@
 #ifdef H5_HAVE_MIRROR_VFD
 #include "H5FDmirror.h"
 #endif
+#ifdef H5_HAVE_MMAP
+#include "H5FDmmap.h"
+#endif
+#ifdef H5_HAVE_IOURING
+#include "H5FDiouring.h"
+#endif
 #ifdef H5_HAVE_LIBHDFS
 #include "H5FDhdfs.h"
 #endif
@@ -1002,6 +1008,22 @@ H5P__facc_set_def_driver_check_predefined(const char *driver_name, hid_t *driver
             HGOTO_ERROR(H5E_VFL, H5E_UNINITIALIZED, FAIL, "couldn't initialize Direct I/O VFD");
 #else
         HGOTO_ERROR(H5E_VFL, H5E_BADVALUE, FAIL, "Direct I/O VFD is not enabled");
+#endif
+    }
+    else if (!strcmp(driver_name, "iouring")) {
+#ifdef H5_HAVE_IOURING
+        if ((*driver_id = H5FD_IOURING) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_UNINITIALIZED, FAIL, "couldn't initialize io_uring VFD");
+#else
+        HGOTO_ERROR(H5E_VFL, H5E_BADVALUE, FAIL, "io_uring VFD is not enabled");
+#endif
+    }
+    else if (!strcmp(driver_name, "mmap")) {
+#ifdef H5_HAVE_MMAP
+        if ((*driver_id = H5FD_MMAP) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_UNINITIALIZED, FAIL, "couldn't initialize mmap VFD");
+#else
+        HGOTO_ERROR(H5E_VFL, H5E_BADVALUE, FAIL, "mmap VFD is not enabled");
 #endif
     }
     else if (!strcmp(driver_name, "mirror")) {
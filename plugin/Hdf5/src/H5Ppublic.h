@@ -7244,6 +7244,54 @@ H5_DLL herr_t H5Pget_append_flush(hid_t dapl_id, unsigned dims, hsize_t boundary
  */
 H5_DLL herr_t H5Pget_chunk_cache(hid_t dapl_id, size_t *rdcc_nslots /*out*/, size_t *rdcc_nbytes /*out*/,
                                  double *rdcc_w0 /*out*/);
+/**
+ * \ingroup DAPL
+ *
+ * \brief Retrieves the slot lookup and replacement policy of the raw data
+ *        chunk cache
+ *
+ * \dapl_id
+ * \param[out] hash   Slot lookup of the chunk cache
+ * \param[out] policy Replacement policy of the chunk cache
+ *
+ * \return \herr_t
+ *
+ * \details H5Pget_chunk_cache_policy() retrieves the values set with
+ *          H5Pset_chunk_cache_policy(). Either pointer may be null.
+ *
+ */
+H5_DLL herr_t H5Pget_chunk_cache_policy(hid_t dapl_id, H5D_chunk_cache_hash_t *hash /*out*/,
+                                        H5D_chunk_cache_policy_t *policy /*out*/);
+/**
+ * \ingroup DAPL
+ *
+ * \brief Retrieves whether the chunk index is loaded into memory
+ *
+ * \dapl_id
+ * \param[out] snapshot Whether the chunk index is loaded into memory
+ *
+ * \return \herr_t
+ *
+ * \details H5Pget_chunk_index_snapshot() retrieves the value set with
+ *          H5Pset_chunk_index_snapshot().
+ *
+ */
+H5_DLL herr_t H5Pget_chunk_index_snapshot(hid_t dapl_id, bool *snapshot /*out*/);
+/**
+ * \ingroup DAPL
+ *
+ * \brief Retrieves the number of chunks read ahead into the chunk cache
+ *
+ * \dapl_id
+ * \param[out] nchunks Number of chunks read ahead
+ *
+ * \return \herr_t
+ *
+ * \details H5Pget_chunk_prefetch() retrieves the value set with
+ *          H5Pset_chunk_prefetch().
+ *
+ */
+H5_DLL herr_t H5Pget_chunk_prefetch(hid_t dapl_id, unsigned *nchunks /*out*/);
 /**
  * \ingroup DAPL
  *
@@ -7561,6 +7609,94 @@ H5_DLL herr_t H5Pset_append_flush(hid_t dapl_id, unsigned ndims, const hsize_t b
  *
  */
 H5_DLL herr_t H5Pset_chunk_cache(hid_t dapl_id, size_t rdcc_nslots, size_t rdcc_nbytes, double rdcc_w0);
+/**
+ * \ingroup DAPL
+ *
+ * \brief Sets the slot lookup and replacement policy of the raw data chunk
+ *        cache
+ *
+ * \dapl_id
+ * \param[in] hash   Slot lookup of the chunk cache
+ * \param[in] policy Replacement policy of the chunk cache
+ *
+ * \return \herr_t
+ *
+ * \details H5Pset_chunk_cache_policy() selects how the raw data chunk
+ *          cache of a dataset opened with \p dapl_id finds and preempts
+ *          chunks.
+ *
+ *          With #H5D_CHUNK_CACHE_HASH_DIRECT each chunk may only live in
+ *          the one slot computed from its coordinates, and a chunk whose
+ *          slot is taken evicts the previous one. With
+ *          #H5D_CHUNK_CACHE_HASH_OPEN the coordinates go through a mixing
+ *          hash and a taken slot is resolved by probing the next slots, so
+ *          that strided access patterns do not evict each other. The table
+ *          is then kept at most three quarters full, so \p rdcc_nslots of
+ *          H5Pset_chunk_cache() also bounds the number of cached chunks.
+ *
+ *          With #H5D_CHUNK_CACHE_POLICY_W0 the cache is preempted as
+ *          described for H5Pset_chunk_cache(). With
+ *          #H5D_CHUNK_CACHE_POLICY_2Q chunks that were used only once are
+ *          kept apart from chunks used again and are preempted first, so a
+ *          single pass over a large part of the dataset does not flush the
+ *          chunks that are used repeatedly.
+ *
+ *          The hit, miss, collision and eviction counters of the cache
+ *          can be read with H5Dget_chunk_cache_stats().
+ *
+ */
+H5_DLL herr_t H5Pset_chunk_cache_policy(hid_t dapl_id, H5D_chunk_cache_hash_t hash,
+                                        H5D_chunk_cache_policy_t policy);
+/**
+ * \ingroup DAPL
+ *
+ * \brief Sets whether the chunk index is loaded into memory
+ *
+ * \dapl_id
+ * \param[in] snapshot Whether the chunk index is loaded into memory
+ *
+ * \return \herr_t
+ *
+ * \details H5Pset_chunk_index_snapshot() makes a chunked dataset opened
+ *          with \p dapl_id load its whole chunk index the first time a
+ *          chunk is looked up. The file address, stored size and filter
+ *          mask of every written chunk are kept in a hash table in memory,
+ *          so that later lookups take constant time and do not go through
+ *          the B-tree or array index and the metadata cache.
+ *
+ *          The table takes at most 48 bytes for every written chunk. A
+ *          dataset with more than 2^20 written chunks keeps using its
+ *          chunk index. The snapshot is only used when the file is opened
+ *          read-only and not for SWMR reading, as the index cannot change
+ *          then; otherwise the setting is ignored.
+ *
+ */
+H5_DLL herr_t H5Pset_chunk_index_snapshot(hid_t dapl_id, bool snapshot);
+/**
+ * \ingroup DAPL
+ *
+ * \brief Sets the number of chunks read ahead into the chunk cache
+ *
+ * \dapl_id
+ * \param[in] nchunks Number of chunks read ahead, 0 to disable
+ *
+ * \return \herr_t
+ *
+ * \details H5Pset_chunk_prefetch() makes a chunked dataset opened with
+ *          \p dapl_id detect reads that walk its chunks in storage order,
+ *          the same chunk after chunk or with a constant step. Once two
+ *          successive chunk cache misses follow the step, the next \p
+ *          nchunks chunks along it that are not cached yet are read with
+ *          a single vector read, decompressed and stored in the chunk
+ *          cache, so that the following reads find them there.
+ *
+ *          Read-ahead only applies to datasets with filters, and never
+ *          takes more than the chunk cache can hold besides the chunk
+ *          being read. The number of chunks read ahead is returned in the
+ *          \c nprefetches field of H5Dget_chunk_cache_stats().
+ *
+ */
+H5_DLL herr_t H5Pset_chunk_prefetch(hid_t dapl_id, unsigned nchunks);
 /**
  * \ingroup DAPL
  *
@@ -24,6 +24,7 @@
 /***********/
 #include "H5Tconv.h"
 #include "H5Tconv_macros.h"
+#include "H5Tconv_vec.h"
 #include "H5Tconv_float.h"
 
 /*-------------------------------------------------------------------------
@@ -1610,7 +1611,7 @@ H5T__conv_float_int(const H5T_t *st, const H5T_t *dt, H5T_cdata_t *cdata, const
                     void H5_ATTR_UNUSED *bkg)
 {
     H5_GCC_CLANG_DIAG_OFF("float-equal")
-    H5T_CONV_Fx(FLOAT, INT, float, int, INT_MIN, INT_MAX);
+    H5T_CONV_Fx_VEC(FLOAT, INT, float, int, INT_MIN, INT_MAX, H5T__conv_float_int_vec);
     H5_GCC_CLANG_DIAG_ON("float-equal")
 }
 
@@ -1650,7 +1651,7 @@ H5T__conv_float_long(const H5T_t *st, const H5T_t *dt, H5T_cdata_t *cdata, const
                      void H5_ATTR_UNUSED *bkg)
 {
     H5_GCC_CLANG_DIAG_OFF("float-equal")
-    H5T_CONV_Fx(FLOAT, LONG, float, long, LONG_MIN, LONG_MAX);
+    H5T_CONV_Fx_VEC(FLOAT, LONG, float, long, LONG_MIN, LONG_MAX, H5T__conv_float_long_vec);
     H5_GCC_CLANG_DIAG_ON("float-equal")
 }
 
@@ -1690,7 +1691,7 @@ H5T__conv_float_llong(const H5T_t *st, const H5T_t *dt, H5T_cdata_t *cdata, cons
                       void H5_ATTR_UNUSED *bkg)
 {
     H5_GCC_CLANG_DIAG_OFF("float-equal")
-    H5T_CONV_Fx(FLOAT, LLONG, float, long long, LLONG_MIN, LLONG_MAX);
+    H5T_CONV_Fx_VEC(FLOAT, LLONG, float, long long, LLONG_MIN, LLONG_MAX, H5T__conv_float_llong_vec);
     H5_GCC_CLANG_DIAG_ON("float-equal")
 }
 
@@ -1752,7 +1753,7 @@ H5T__conv_float_double(const H5T_t *st, const H5T_t *dt, H5T_cdata_t *cdata, con
                        size_t nelmts, size_t buf_stride, size_t H5_ATTR_UNUSED bkg_stride, void *buf,
                        void H5_ATTR_UNUSED *bkg)
 {
-    H5T_CONV_fF(FLOAT, DOUBLE, float, double, -, -);
+    H5T_CONV_fF_VEC(FLOAT, DOUBLE, float, double, -, -, H5T__conv_float_double_vec);
 }
 
 /*-------------------------------------------------------------------------
@@ -1869,7 +1870,7 @@ H5T__conv_double_int(const H5T_t *st, const H5T_t *dt, H5T_cdata_t *cdata, const
                      void H5_ATTR_UNUSED *bkg)
 {
     H5_GCC_CLANG_DIAG_OFF("float-equal")
-    H5T_CONV_Fx(DOUBLE, INT, double, int, INT_MIN, INT_MAX);
+    H5T_CONV_Fx_VEC(DOUBLE, INT, double, int, INT_MIN, INT_MAX, H5T__conv_double_int_vec);
     H5_GCC_CLANG_DIAG_ON("float-equal")
 }
 
@@ -1909,7 +1910,7 @@ H5T__conv_double_long(const H5T_t *st, const H5T_t *dt, H5T_cdata_t *cdata, cons
                       void H5_ATTR_UNUSED *bkg)
 {
     H5_GCC_CLANG_DIAG_OFF("float-equal")
-    H5T_CONV_Fx(DOUBLE, LONG, double, long, LONG_MIN, LONG_MAX);
+    H5T_CONV_Fx_VEC(DOUBLE, LONG, double, long, LONG_MIN, LONG_MAX, H5T__conv_double_long_vec);
     H5_GCC_CLANG_DIAG_ON("float-equal")
 }
 
@@ -1949,7 +1950,7 @@ H5T__conv_double_llong(const H5T_t *st, const H5T_t *dt, H5T_cdata_t *cdata, con
                        void H5_ATTR_UNUSED *bkg)
 {
     H5_GCC_CLANG_DIAG_OFF("float-equal")
-    H5T_CONV_Fx(DOUBLE, LLONG, double, long long, LLONG_MIN, LLONG_MAX);
+    H5T_CONV_Fx_VEC(DOUBLE, LLONG, double, long long, LLONG_MIN, LLONG_MAX, H5T__conv_double_llong_vec);
     H5_GCC_CLANG_DIAG_ON("float-equal")
 }
 
@@ -2011,7 +2012,7 @@ H5T__conv_double_float(const H5T_t *st, const H5T_t *dt, H5T_cdata_t *cdata, con
                        size_t nelmts, size_t buf_stride, size_t H5_ATTR_UNUSED bkg_stride, void *buf,
                        void H5_ATTR_UNUSED *bkg)
 {
-    H5T_CONV_Ff(DOUBLE, FLOAT, double, float, -FLT_MAX, FLT_MAX);
+    H5T_CONV_Ff_VEC(DOUBLE, FLOAT, double, float, -FLT_MAX, FLT_MAX, H5T__conv_double_float_vec);
 }
 
 /*-------------------------------------------------------------------------
@@ -24,6 +24,7 @@
 /***********/
 #include "H5Tconv.h"
 #include "H5Tconv_macros.h"
+#include "H5Tconv_vec.h"
 #include "H5Tconv_integer.h"
 
 /*-------------------------------------------------------------------------
@@ -1992,7 +1993,7 @@ H5T__conv_int_float(const H5T_t *st, const H5T_t *dt, H5T_cdata_t *cdata, const
                     size_t nelmts, size_t buf_stride, size_t H5_ATTR_UNUSED bkg_stride, void *buf,
                     void H5_ATTR_UNUSED *bkg)
 {
-    H5T_CONV_xF(INT, FLOAT, int, float, -, -);
+    H5T_CONV_xF_VEC(INT, FLOAT, int, float, -, -, H5T__conv_int_float_vec);
 }
 
 /*-------------------------------------------------------------------------
@@ -2010,7 +2011,7 @@ H5T__conv_int_double(const H5T_t *st, const H5T_t *dt, H5T_cdata_t *cdata, const
                      size_t nelmts, size_t buf_stride, size_t H5_ATTR_UNUSED bkg_stride, void *buf,
                      void H5_ATTR_UNUSED *bkg)
 {
-    H5T_CONV_xF(INT, DOUBLE, int, double, -, -);
+    H5T_CONV_xF_VEC(INT, DOUBLE, int, double, -, -, H5T__conv_int_double_vec);
 }
 
 /*-------------------------------------------------------------------------
@@ -255,7 +255,7 @@ typedef struct H5T_conv_hw_t {
 #define H5T_CONV_sS(STYPE, DTYPE, ST, DT, D_MIN, D_MAX)                                                      \
     do {                                                                                                     \
         HDcompile_assert(sizeof(ST) <= sizeof(DT));                                                          \
-        H5T_CONV(H5T_CONV_xX, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N)                                         \
+        H5T_CONV(H5T_CONV_xX, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N, H5T_CONV_NO_VEC)                        \
     } while (0)
 
 #define H5T_CONV_sU_CORE(STYPE, DTYPE, S, D, ST, DT, D_MIN, D_MAX)                                           \
@@ -285,7 +285,7 @@ typedef struct H5T_conv_hw_t {
 #define H5T_CONV_sU(STYPE, DTYPE, ST, DT, D_MIN, D_MAX)                                                      \
     do {                                                                                                     \
         HDcompile_assert(sizeof(ST) <= sizeof(DT));                                                          \
-        H5T_CONV(H5T_CONV_sU, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N)                                         \
+        H5T_CONV(H5T_CONV_sU, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N, H5T_CONV_NO_VEC)                        \
     } while (0)
 
 /* Define to 1 if overflow is possible during conversion, 0 otherwise
@@ -368,19 +368,19 @@ typedef struct H5T_conv_hw_t {
 #define H5T_CONV_uS(STYPE, DTYPE, ST, DT, D_MIN, D_MAX)                                                      \
     do {                                                                                                     \
         HDcompile_assert(sizeof(ST) <= sizeof(DT));                                                          \
-        H5T_CONV(H5T_CONV_uS, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N)                                         \
+        H5T_CONV(H5T_CONV_uS, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N, H5T_CONV_NO_VEC)                        \
     } while (0)
 
 #define H5T_CONV_uU(STYPE, DTYPE, ST, DT, D_MIN, D_MAX)                                                      \
     do {                                                                                                     \
         HDcompile_assert(sizeof(ST) <= sizeof(DT));                                                          \
-        H5T_CONV(H5T_CONV_xX, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N)                                         \
+        H5T_CONV(H5T_CONV_xX, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N, H5T_CONV_NO_VEC)                        \
     } while (0)
 
 #define H5T_CONV_Ss(STYPE, DTYPE, ST, DT, D_MIN, D_MAX)                                                      \
     do {                                                                                                     \
         HDcompile_assert(sizeof(ST) >= sizeof(DT));                                                          \
-        H5T_CONV(H5T_CONV_Xx, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N)                                         \
+        H5T_CONV(H5T_CONV_Xx, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N, H5T_CONV_NO_VEC)                        \
     } while (0)
 
 #define H5T_CONV_Su_CORE(STYPE, DTYPE, S, D, ST, DT, D_MIN, D_MAX)                                           \
@@ -423,19 +423,19 @@ typedef struct H5T_conv_hw_t {
 #define H5T_CONV_Su(STYPE, DTYPE, ST, DT, D_MIN, D_MAX)                                                      \
     do {                                                                                                     \
         HDcompile_assert(sizeof(ST) >= sizeof(DT));                                                          \
-        H5T_CONV(H5T_CONV_Su, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N)                                         \
+        H5T_CONV(H5T_CONV_Su, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N, H5T_CONV_NO_VEC)                        \
     } while (0)
 
 #define H5T_CONV_Us(STYPE, DTYPE, ST, DT, D_MIN, D_MAX)                                                      \
     do {                                                                                                     \
         HDcompile_assert(sizeof(ST) >= sizeof(DT));                                                          \
-        H5T_CONV(H5T_CONV_Ux, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N)                                         \
+        H5T_CONV(H5T_CONV_Ux, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N, H5T_CONV_NO_VEC)                        \
     } while (0)
 
 #define H5T_CONV_Uu(STYPE, DTYPE, ST, DT, D_MIN, D_MAX)                                                      \
     do {                                                                                                     \
         HDcompile_assert(sizeof(ST) >= sizeof(DT));                                                          \
-        H5T_CONV(H5T_CONV_Ux, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N)                                         \
+        H5T_CONV(H5T_CONV_Ux, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N, H5T_CONV_NO_VEC)                        \
     } while (0)
 
 #define H5T_CONV_su_CORE(STYPE, DTYPE, S, D, ST, DT, D_MIN, D_MAX)                                           \
@@ -467,7 +467,7 @@ typedef struct H5T_conv_hw_t {
 #define H5T_CONV_su(STYPE, DTYPE, ST, DT, D_MIN, D_MAX)                                                      \
     do {                                                                                                     \
         HDcompile_assert(sizeof(ST) == sizeof(DT));                                                          \
-        H5T_CONV(H5T_CONV_su, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N)                                         \
+        H5T_CONV(H5T_CONV_su, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N, H5T_CONV_NO_VEC)                        \
     } while (0)
 
 #define H5T_CONV_us_CORE(STYPE, DTYPE, S, D, ST, DT, D_MIN, D_MAX)                                           \
@@ -499,13 +499,15 @@ typedef struct H5T_conv_hw_t {
 #define H5T_CONV_us(STYPE, DTYPE, ST, DT, D_MIN, D_MAX)                                                      \
     do {                                                                                                     \
         HDcompile_assert(sizeof(ST) == sizeof(DT));                                                          \
-        H5T_CONV(H5T_CONV_us, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N)                                         \
+        H5T_CONV(H5T_CONV_us, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N, H5T_CONV_NO_VEC)                        \
     } while (0)
 
 #define H5T_CONV_fF(STYPE, DTYPE, ST, DT, D_MIN, D_MAX)                                                      \
+    H5T_CONV_fF_VEC(STYPE, DTYPE, ST, DT, D_MIN, D_MAX, H5T_CONV_NO_VEC)
+#define H5T_CONV_fF_VEC(STYPE, DTYPE, ST, DT, D_MIN, D_MAX, VEC)                                             \
     do {                                                                                                     \
         HDcompile_assert(sizeof(ST) <= sizeof(DT));                                                          \
-        H5T_CONV(H5T_CONV_xX, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N)                                         \
+        H5T_CONV(H5T_CONV_xX, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N, VEC)                                    \
     } while (0)
 
 /* Same as H5T_CONV_Xx_CORE, except that instead of using D_MAX and D_MIN
@@ -549,9 +551,11 @@ typedef struct H5T_conv_hw_t {
     }
 
 #define H5T_CONV_Ff(STYPE, DTYPE, ST, DT, D_MIN, D_MAX)                                                      \
+    H5T_CONV_Ff_VEC(STYPE, DTYPE, ST, DT, D_MIN, D_MAX, H5T_CONV_NO_VEC)
+#define H5T_CONV_Ff_VEC(STYPE, DTYPE, ST, DT, D_MIN, D_MAX, VEC)                                             \
     do {                                                                                                     \
         HDcompile_assert(sizeof(ST) >= sizeof(DT));                                                          \
-        H5T_CONV(H5T_CONV_Ff, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N)                                         \
+        H5T_CONV(H5T_CONV_Ff, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N, VEC)                                    \
     } while (0)
 
 #define H5T_HI_LO_BIT_SET(TYP, V, LO, HI)                                                                    \
@@ -646,8 +650,10 @@ typedef struct H5T_conv_hw_t {
     }
 
 #define H5T_CONV_xF(STYPE, DTYPE, ST, DT, D_MIN, D_MAX)                                                      \
+    H5T_CONV_xF_VEC(STYPE, DTYPE, ST, DT, D_MIN, D_MAX, H5T_CONV_NO_VEC)
+#define H5T_CONV_xF_VEC(STYPE, DTYPE, ST, DT, D_MIN, D_MAX, VEC)                                             \
     do {                                                                                                     \
-        H5T_CONV(H5T_CONV_xF, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, Y)                                         \
+        H5T_CONV(H5T_CONV_xF, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, Y, VEC)                                    \
     } while (0)
 
 /* Quincey added the condition branch (else if (*(S) != (ST)((DT)(*(S))))).
@@ -707,14 +713,16 @@ typedef struct H5T_conv_hw_t {
     }
 
 #define H5T_CONV_Fx(STYPE, DTYPE, ST, DT, D_MIN, D_MAX)                                                      \
+    H5T_CONV_Fx_VEC(STYPE, DTYPE, ST, DT, D_MIN, D_MAX, H5T_CONV_NO_VEC)
+#define H5T_CONV_Fx_VEC(STYPE, DTYPE, ST, DT, D_MIN, D_MAX, VEC)                                             \
     do {                                                                                                     \
-        H5T_CONV(H5T_CONV_Fx, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, Y)                                         \
+        H5T_CONV(H5T_CONV_Fx, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, Y, VEC)                                    \
     } while (0)
 
 #define H5T_CONV_fX(STYPE, DTYPE, ST, DT, D_MIN, D_MAX)                                                      \
     do {                                                                                                     \
         HDcompile_assert(sizeof(ST) <= sizeof(DT));                                                          \
-        H5T_CONV(H5T_CONV_xX, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N)                                         \
+        H5T_CONV(H5T_CONV_xX, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, N, H5T_CONV_NO_VEC)                        \
     } while (0)
 
 #define H5T_CONV_Xf_CORE(STYPE, DTYPE, S, D, ST, DT, D_MIN, D_MAX)                                           \
@@ -801,7 +809,7 @@ typedef struct H5T_conv_hw_t {
 #define H5T_CONV_Xf(STYPE, DTYPE, ST, DT, D_MIN, D_MAX)                                                      \
     do {                                                                                                     \
         HDcompile_assert(sizeof(ST) >= sizeof(DT));                                                          \
-        H5T_CONV(H5T_CONV_Xf, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, Y)                                         \
+        H5T_CONV(H5T_CONV_Xf, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, Y, H5T_CONV_NO_VEC)                        \
     } while (0)
 
 /* Since all "no exception" cores do the same thing (assign the value in the
@@ -815,6 +823,19 @@ typedef struct H5T_conv_hw_t {
     }
 #endif /* H5_WANT_DCONV_EXCEPTION */
 
+/* Whether a pass can be given to the kernel VEC(src, dst, nelmts) of the
+ * conversion, which converts packed buffers like the "no exception" guts do.
+ * H5T_CONV_NO_VEC is the lack of a kernel.
+ */
+#ifdef H5_WANT_DCONV_EXCEPTION
+#define H5T_CONV_VEC_OK(ST, DT)                                                                              \
+    (!conv_ctx->u.conv.cb_struct.func && s_stride == (ssize_t)sizeof(ST) &&                                  \
+     d_stride == (ssize_t)sizeof(DT))
+#else /* H5_WANT_DCONV_EXCEPTION */
+#define H5T_CONV_VEC_OK(ST, DT) false
+#endif /* H5_WANT_DCONV_EXCEPTION */
+#define H5T_CONV_NO_VEC(S, D, N) false
+
 /* Declare the source & destination precision variables */
 #define H5T_CONV_DECL_PREC(PREC) H5_GLUE(H5T_CONV_DECL_PREC_, PREC)
 
@@ -958,7 +979,7 @@ typedef struct H5T_conv_hw_t {
     }
 
 /* The main part of every integer hardware conversion macro */
-#define H5T_CONV(GUTS, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, PREC)                                             \
+#define H5T_CONV(GUTS, STYPE, DTYPE, ST, DT, D_MIN, D_MAX, PREC, VEC)                                        \
     {                                                                                                        \
         herr_t ret_value = SUCCEED; /* Return value         */                                               \
                                                                                                              \
@@ -1041,9 +1062,9 @@ typedef struct H5T_conv_hw_t {
                             /* with a "real" reverse copy */                                                 \
                             if (safe < 2) {                                                                  \
                                 src      = (ST *)(src_buf = (void *)((uint8_t *)buf +                        \
-                                                                (nelmts - 1) * (size_t)s_stride));      \
+                                                                (nelmts - 1) * (size_t)s_stride));           \
                                 dst      = (DT *)(dst_buf = (void *)((uint8_t *)buf +                        \
-                                                                (nelmts - 1) * (size_t)d_stride));      \
+                                                                (nelmts - 1) * (size_t)d_stride));           \
                                 s_stride = -s_stride;                                                        \
                                 d_stride = -d_stride;                                                        \
                                                                                                              \
@@ -1081,6 +1102,9 @@ typedef struct H5T_conv_hw_t {
                             H5T_CONV_LOOP_OUTER(PRE_SNOALIGN, PRE_DALIGN, POST_SNOALIGN, POST_DALIGN, GUTS,  \
                                                 STYPE, DTYPE, src, d, ST, DT, D_MIN, D_MAX)                  \
                         }                                                                                    \
+                        else if (H5T_CONV_VEC_OK(ST, DT) && VEC(src, dst, safe)) {                           \
+                            /* Packed elements without exception callback, done by the kernel */             \
+                        }                                                                                    \
                         else {                                                                               \
                             /* Alignment is not required for both source and destination */                  \
                             H5T_CONV_LOOP_OUTER(PRE_SNOALIGN, PRE_DNOALIGN, POST_SNOALIGN, POST_DNOALIGN,    \
@@ -0,0 +1,343 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://www.hdfgroup.org/licenses.               *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose: Kernels of the hard conversion functions between floating-point
+ *          and integer datatypes, for whole buffers of packed elements
+ */
+
+/****************/
+/* Module Setup */
+/****************/
+#include "H5Tmodule.h" /* This source code file is part of the H5T module */
+
+/***********/
+/* Headers */
+/***********/
+#include "H5MMprivate.h" /* Memory management			*/
+#include "H5Tconv_vec.h"
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* SSE2 is always present on x86-64.  The conversions to 64-bit integers use
+ * its scalar instructions, which have defined results out of range.  The
+ * conversions from 64-bit integers have no SIMD instructions before AVX-512
+ * and are left to the generic loop.
+ */
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define H5T_CONV_SSE2
+#include <emmintrin.h>
+#if defined(__x86_64__) || defined(_M_X64)
+#define H5T_CONV_SSE2_64 /* Scalar 64-bit conversions */
+#endif
+#endif
+
+/* The scalar loops go through memcpy() because the source and destination
+ * types share the buffer.  Each one is the "no exception" guts of the
+ * conversion.
+ */
+#define H5T_CONV_VEC_LOOP(ST, DT, SRC, DST, I, N, GUTS)                                                      \
+    for (; (I) < (N); (I)++) {                                                                               \
+        ST s;                                                                                                \
+        DT d;                                                                                                \
+                                                                                                             \
+        H5MM_memcpy(&s, (SRC) + (I), sizeof(ST));                                                            \
+        GUTS;                                                                                                \
+        H5MM_memcpy((DST) + (I), &d, sizeof(DT));                                                            \
+    }
+
+/* H5T_CONV_xF_NOEX_CORE */
+#define H5T_CONV_VEC_xF(ST, DT) d = (DT)s
+
+/* H5T_CONV_Ff_NOEX_CORE */
+#define H5T_CONV_VEC_Ff(ST, DT, D_MIN, D_MAX, POS_INF, NEG_INF)                                              \
+    if (s > (ST)(D_MAX))                                                                                     \
+        d = (POS_INF);                                                                                       \
+    else if (s < (ST)(D_MIN))                                                                                \
+        d = (NEG_INF);                                                                                       \
+    else                                                                                                     \
+        d = (DT)s
+
+/* H5T_CONV_Fx_NOEX_CORE */
+#define H5T_CONV_VEC_Fx(ST, DT, D_MIN, D_MAX)                                                                \
+    if (s > (ST)(D_MAX))                                                                                     \
+        d = (DT)(D_MAX);                                                                                     \
+    else if (s < (ST)(D_MIN))                                                                                \
+        d = (DT)(D_MIN);                                                                                     \
+    else                                                                                                     \
+        d = (DT)s
+
+/*-------------------------------------------------------------------------
+ * Function:    H5T__conv_float_double_vec
+ *
+ * Purpose:     Convert packed native `float' to native `double'.
+ *
+ * Return:      true
+ *
+ *-------------------------------------------------------------------------
+ */
+bool
+H5T__conv_float_double_vec(const float *src, double *dst, size_t nelmts)
+{
+    size_t i = 0;
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+#ifdef H5T_CONV_SSE2
+    for (; i + 4 <= nelmts; i += 4) {
+        __m128 x = _mm_loadu_ps(src + i);
+
+        _mm_storeu_pd(dst + i, _mm_cvtps_pd(x));
+        _mm_storeu_pd(dst + i + 2, _mm_cvtps_pd(_mm_movehl_ps(x, x)));
+    }
+#endif
+    H5T_CONV_VEC_LOOP(float, double, src, dst, i, nelmts, H5T_CONV_VEC_xF(float, double))
+
+    FUNC_LEAVE_NOAPI(true)
+} /* end H5T__conv_float_double_vec() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5T__conv_double_float_vec
+ *
+ * Purpose:     Convert packed native `double' to native `float'.  Values
+ *              beyond the range of `float' become infinities.
+ *
+ * Return:      true
+ *
+ *-------------------------------------------------------------------------
+ */
+bool
+H5T__conv_double_float_vec(const double *src, float *dst, size_t nelmts)
+{
+    size_t i = 0;
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+#ifdef H5T_CONV_SSE2
+    {
+        const __m128d max     = _mm_set1_pd((double)FLT_MAX);
+        const __m128d min     = _mm_set1_pd((double)-FLT_MAX);
+        const __m128d pos_inf = _mm_set1_pd((double)H5T_NATIVE_FLOAT_POS_INF_g);
+        const __m128d neg_inf = _mm_set1_pd((double)H5T_NATIVE_FLOAT_NEG_INF_g);
+
+        for (; i + 4 <= nelmts; i += 4) {
+            __m128d x[2];
+            __m128  f[2];
+            int     j;
+
+            /* Both vectors are loaded before the store, which may overwrite them */
+            x[0] = _mm_loadu_pd(src + i);
+            x[1] = _mm_loadu_pd(src + i + 2);
+            for (j = 0; j < 2; j++) {
+                __m128d hi = _mm_cmpgt_pd(x[j], max);
+                __m128d lo = _mm_cmplt_pd(x[j], min);
+
+                x[j] = _mm_or_pd(_mm_andnot_pd(_mm_or_pd(hi, lo), x[j]),
+                                 _mm_or_pd(_mm_and_pd(hi, pos_inf), _mm_and_pd(lo, neg_inf)));
+                f[j] = _mm_cvtpd_ps(x[j]);
+            }
+            _mm_storeu_ps(dst + i, _mm_movelh_ps(f[0], f[1]));
+        }
+    }
+#endif
+    H5T_CONV_VEC_LOOP(double, float, src, dst, i, nelmts,
+                      H5T_CONV_VEC_Ff(double, float, -FLT_MAX, FLT_MAX, H5T_NATIVE_FLOAT_POS_INF_g,
+                                      H5T_NATIVE_FLOAT_NEG_INF_g))
+
+    FUNC_LEAVE_NOAPI(true)
+} /* end H5T__conv_double_float_vec() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5T__conv_int_float_vec
+ *
+ * Purpose:     Convert packed native `int' to native `float'.
+ *
+ * Return:      true
+ *
+ *-------------------------------------------------------------------------
+ */
+bool
+H5T__conv_int_float_vec(const int *src, float *dst, size_t nelmts)
+{
+    size_t i = 0;
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+#ifdef H5T_CONV_SSE2
+    if (sizeof(int) == 4)
+        for (; i + 4 <= nelmts; i += 4)
+            _mm_storeu_ps(dst + i, _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)(src + i))));
+#endif
+    H5T_CONV_VEC_LOOP(int, float, src, dst, i, nelmts, H5T_CONV_VEC_xF(int, float))
+
+    FUNC_LEAVE_NOAPI(true)
+} /* end H5T__conv_int_float_vec() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5T__conv_int_double_vec
+ *
+ * Purpose:     Convert packed native `int' to native `double'.
+ *
+ * Return:      true
+ *
+ *-------------------------------------------------------------------------
+ */
+bool
+H5T__conv_int_double_vec(const int *src, double *dst, size_t nelmts)
+{
+    size_t i = 0;
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+#ifdef H5T_CONV_SSE2
+    if (sizeof(int) == 4)
+        for (; i + 4 <= nelmts; i += 4) {
+            __m128i x = _mm_loadu_si128((const __m128i *)(src + i));
+
+            _mm_storeu_pd(dst + i, _mm_cvtepi32_pd(x));
+            _mm_storeu_pd(dst + i + 2, _mm_cvtepi32_pd(_mm_unpackhi_epi64(x, x)));
+        }
+#endif
+    H5T_CONV_VEC_LOOP(int, double, src, dst, i, nelmts, H5T_CONV_VEC_xF(int, double))
+
+    FUNC_LEAVE_NOAPI(true)
+} /* end H5T__conv_int_double_vec() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5T__conv_float_int_vec
+ *
+ * Purpose:     Convert packed native `float' to native `int'.  Values
+ *              beyond the range of `int' are clamped.
+ *
+ * Return:      true
+ *
+ *-------------------------------------------------------------------------
+ */
+bool
+H5T__conv_float_int_vec(const float *src, int *dst, size_t nelmts)
+{
+    size_t i = 0;
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+#ifdef H5T_CONV_SSE2
+    if (sizeof(int) == 4) {
+        const __m128  max  = _mm_set1_ps((float)INT_MAX);
+        const __m128i imax = _mm_set1_epi32(INT_MAX);
+
+        /* The truncation gives INT_MIN below the range (and for NaN, as the
+         * cast does), so only the values above it need to be clamped.
+         */
+        for (; i + 4 <= nelmts; i += 4) {
+            __m128  x  = _mm_loadu_ps(src + i);
+            __m128i hi = _mm_castps_si128(_mm_cmpgt_ps(x, max));
+            __m128i r  = _mm_cvttps_epi32(x);
+
+            _mm_storeu_si128((__m128i *)(dst + i), _mm_or_si128(_mm_andnot_si128(hi, r), _mm_and_si128(hi, imax)));
+        }
+    }
+#endif
+    H5T_CONV_VEC_LOOP(float, int, src, dst, i, nelmts, H5T_CONV_VEC_Fx(float, int, INT_MIN, INT_MAX))
+
+    FUNC_LEAVE_NOAPI(true)
+} /* end H5T__conv_float_int_vec() */
+
+/*-------------------------------------------------------------------------
+ * Function:    H5T__conv_double_int_vec
+ *
+ * Purpose:     Convert packed native `double' to native `int'.  Values
+ *              beyond the range of `int' are clamped.
+ *
+ * Return:      true
+ *
+ *-------------------------------------------------------------------------
+ */
+bool
+H5T__conv_double_int_vec(const double *src, int *dst, size_t nelmts)
+{
+    size_t i = 0;
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+#ifdef H5T_CONV_SSE2
+    if (sizeof(int) == 4) {
+        const __m128d max = _mm_set1_pd((double)INT_MAX);
+
+        /* INT_MAX is exact as a double, so the values above it are clamped
+         * before the truncation (the minimum keeps NaN).  The truncation
+         * gives INT_MIN below the range, as the cast does.
+         */
+        for (; i + 4 <= nelmts; i += 4) {
+            __m128i r0 = _mm_cvttpd_epi32(_mm_min_pd(max, _mm_loadu_pd(src + i)));
+            __m128i r1 = _mm_cvttpd_epi32(_mm_min_pd(max, _mm_loadu_pd(src + i + 2)));
+
+            _mm_storeu_si128((__m128i *)(dst + i), _mm_unpacklo_epi64(r0, r1));
+        }
+    }
+#endif
+    H5T_CONV_VEC_LOOP(double, int, src, dst, i, nelmts, H5T_CONV_VEC_Fx(double, int, INT_MIN, INT_MAX))
+
+    FUNC_LEAVE_NOAPI(true)
+} /* end H5T__conv_double_int_vec() */
+
+/* Defines the kernel of a conversion from `float' or `double' to a 64-bit
+ * integer.  LOAD2(p) loads two source values as doubles, which is exact.  As
+ * for int, only the values above the range need to be clamped.
+ */
+#ifdef H5T_CONV_SSE2_64
+#define H5T_CONV_VEC_F64(NAME, ST, DT, D_MIN, D_MAX, LOAD2)                                                  \
+    bool NAME(const ST *src, DT *dst, size_t nelmts)                                                         \
+    {                                                                                                        \
+        size_t i = 0;                                                                                        \
+                                                                                                             \
+        FUNC_ENTER_PACKAGE_NOERR                                                                             \
+                                                                                                             \
+        if (sizeof(DT) == 8) {                                                                               \
+            const __m128d max  = _mm_set1_pd((double)(ST)(D_MAX));                                           \
+            const __m128i imax = _mm_set1_epi64x((long long)(D_MAX));                                        \
+                                                                                                             \
+            for (; i + 2 <= nelmts; i += 2) {                                                                \
+                __m128d x  = LOAD2(src + i);                                                                 \
+                __m128i hi = _mm_castpd_si128(_mm_cmpgt_pd(x, max));                                         \
+                __m128i r  = _mm_set_epi64x(_mm_cvttsd_si64(_mm_unpackhi_pd(x, x)), _mm_cvttsd_si64(x));     \
+                                                                                                             \
+                _mm_storeu_si128((__m128i *)(dst + i),                                                       \
+                                 _mm_or_si128(_mm_andnot_si128(hi, r), _mm_and_si128(hi, imax)));            \
+            }                                                                                                \
+        }                                                                                                    \
+        H5T_CONV_VEC_LOOP(ST, DT, src, dst, i, nelmts, H5T_CONV_VEC_Fx(ST, DT, D_MIN, D_MAX))                \
+                                                                                                             \
+        FUNC_LEAVE_NOAPI(true)                                                                               \
+    }
+#define H5T_CONV_VEC_LOAD2_FLOAT(P)  _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i *)(P))))
+#define H5T_CONV_VEC_LOAD2_DOUBLE(P) _mm_loadu_pd(P)
+#else
+#define H5T_CONV_VEC_F64(NAME, ST, DT, D_MIN, D_MAX, LOAD2)                                                  \
+    bool NAME(const ST *src, DT *dst, size_t nelmts)                                                         \
+    {                                                                                                        \
+        size_t i = 0;                                                                                        \
+                                                                                                             \
+        FUNC_ENTER_PACKAGE_NOERR                                                                             \
+                                                                                                             \
+        H5T_CONV_VEC_LOOP(ST, DT, src, dst, i, nelmts, H5T_CONV_VEC_Fx(ST, DT, D_MIN, D_MAX))                \
+                                                                                                             \
+        FUNC_LEAVE_NOAPI(true)                                                                               \
+    }
+#endif
+
+H5T_CONV_VEC_F64(H5T__conv_float_long_vec, float, long, LONG_MIN, LONG_MAX, H5T_CONV_VEC_LOAD2_FLOAT)
+H5T_CONV_VEC_F64(H5T__conv_double_long_vec, double, long, LONG_MIN, LONG_MAX, H5T_CONV_VEC_LOAD2_DOUBLE)
+H5T_CONV_VEC_F64(H5T__conv_float_llong_vec, float, long long, LLONG_MIN, LLONG_MAX, H5T_CONV_VEC_LOAD2_FLOAT)
+H5T_CONV_VEC_F64(H5T__conv_double_llong_vec, double, long long, LLONG_MIN, LLONG_MAX,
+                 H5T_CONV_VEC_LOAD2_DOUBLE)
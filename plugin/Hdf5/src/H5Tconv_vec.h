@@ -0,0 +1,39 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://www.hdfgroup.org/licenses.               *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef H5Tconv_vec_H
+#define H5Tconv_vec_H
+
+/* Private headers needed by this file */
+#include "H5Tpkg.h"
+
+/***********************/
+/* Function Prototypes */
+/***********************/
+
+/* Kernels of the hard conversion functions for packed buffers when there is
+ * no exception callback (see H5T_CONV_VEC_OK).  They give the same results as
+ * the "no exception" guts and return true once the elements are converted.
+ * The source and the destination may be the same buffer.
+ */
+H5_DLL bool H5T__conv_float_double_vec(const float *src, double *dst, size_t nelmts);
+H5_DLL bool H5T__conv_double_float_vec(const double *src, float *dst, size_t nelmts);
+H5_DLL bool H5T__conv_int_float_vec(const int *src, float *dst, size_t nelmts);
+H5_DLL bool H5T__conv_int_double_vec(const int *src, double *dst, size_t nelmts);
+H5_DLL bool H5T__conv_float_int_vec(const float *src, int *dst, size_t nelmts);
+H5_DLL bool H5T__conv_double_int_vec(const double *src, int *dst, size_t nelmts);
+H5_DLL bool H5T__conv_float_long_vec(const float *src, long *dst, size_t nelmts);
+H5_DLL bool H5T__conv_double_long_vec(const double *src, long *dst, size_t nelmts);
+H5_DLL bool H5T__conv_float_llong_vec(const float *src, long long *dst, size_t nelmts);
+H5_DLL bool H5T__conv_double_llong_vec(const double *src, long long *dst, size_t nelmts);
+
+#endif /* H5Tconv_vec_H */
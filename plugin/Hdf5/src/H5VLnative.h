@@ -75,6 +75,8 @@ typedef union H5VL_native_attr_optional_args_t {
 #define H5VL_NATIVE_DATASET_GET_VLEN_BUF_SIZE       8  /* H5Dvlen_get_buf_size         */
 #define H5VL_NATIVE_DATASET_GET_OFFSET              9  /* H5Dget_offset                */
 #define H5VL_NATIVE_DATASET_CHUNK_ITER              10 /* H5Dchunk_iter                */
+#define H5VL_NATIVE_DATASET_GET_CHUNK_CACHE_STATS   11 /* H5Dget_chunk_cache_stats     */
+#define H5VL_NATIVE_DATASET_FORMAT_UPGRADE          12 /* H5Dformat_upgrade            */
 /* NOTE: If values over 1023 are added, the H5VL_RESERVED_NATIVE_OPTIONAL macro
  *      must be updated.
  */
@@ -173,6 +175,14 @@ typedef union H5VL_native_dataset_optional_args_t {
         void               *op_data; /* Context to pass to iteration callback */
     } chunk_iter;
 
+    /* H5VL_NATIVE_DATASET_GET_CHUNK_CACHE_STATS */
+    struct {
+        H5D_chunk_cache_stats_t *stats; /* Counters of the chunk cache (OUT) */
+    } get_chunk_cache_stats;
+
+    /* H5VL_NATIVE_DATASET_FORMAT_UPGRADE */
+    /* No args */
+
 } H5VL_native_dataset_optional_args_t;
 
 /* Values for native VOL connector file optional VOL operations */
@@ -798,6 +798,26 @@ H5VL__native_dataset_optional(void *obj, H5VL_optional_args_t *args, hid_t dxpl_
             break;
         }
 
+        /* H5Dget_chunk_cache_stats */
+        case H5VL_NATIVE_DATASET_GET_CHUNK_CACHE_STATS: {
+            if (H5D__get_chunk_cache_stats(dset, opt_args->get_chunk_cache_stats.stats) < 0)
+                HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get chunk cache statistics");
+
+            break;
+        }
+
+        /* H5Dformat_upgrade */
+        case H5VL_NATIVE_DATASET_FORMAT_UPGRADE: {
+            /* Convert the chunk indexing type from version 1 B-tree, if so */
+            if (dset->shared->layout.type == H5D_CHUNKED &&
+                dset->shared->layout.u.chunk.idx_type == H5D_CHUNK_IDX_BTREE)
+                if (H5D__format_upgrade(dset) < 0)
+                    HGOTO_ERROR(H5E_DATASET, H5E_CANTUPDATE, FAIL,
+                                "unable to upgrade chunk indexing type for dataset");
+
+            break;
+        }
+
         default:
             HGOTO_ERROR(H5E_VOL, H5E_UNSUPPORTED, FAIL, "invalid optional operation");
     } /* end switch */
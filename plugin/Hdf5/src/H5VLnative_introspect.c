@@ -109,6 +109,7 @@ H5VL__native_introspect_opt_query(void H5_ATTR_UNUSED *obj, H5VL_subclass_t subc
         case H5VL_SUBCLS_DATASET:
             switch (opt_type) {
                 case H5VL_NATIVE_DATASET_FORMAT_CONVERT:
+                case H5VL_NATIVE_DATASET_FORMAT_UPGRADE:
                     *flags |= H5VL_OPT_QUERY_MODIFY_METADATA;
                     break;
 
@@ -119,6 +120,7 @@ H5VL__native_introspect_opt_query(void H5_ATTR_UNUSED *obj, H5VL_subclass_t subc
                 case H5VL_NATIVE_DATASET_GET_CHUNK_INFO_BY_COORD:
                 case H5VL_NATIVE_DATASET_GET_VLEN_BUF_SIZE:
                 case H5VL_NATIVE_DATASET_GET_OFFSET:
+                case H5VL_NATIVE_DATASET_GET_CHUNK_CACHE_STATS:
                     *flags |= H5VL_OPT_QUERY_QUERY_METADATA;
                     break;
 
@@ -102,6 +102,8 @@ H5Z_init(void)
         HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, FAIL, "unable to register nbit filter");
     if (H5Z_register(H5Z_SCALEOFFSET) < 0)
         HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, FAIL, "unable to register scaleoffset filter");
+    if (H5Z_register(H5Z_BITSHUFFLE) < 0)
+        HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, FAIL, "unable to register bitshuffle filter");
 
         /* External filters */
 #ifdef H5_HAVE_FILTER_DEFLATE
@@ -119,6 +121,14 @@ H5Z_init(void)
             HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, FAIL, "unable to register szip filter");
     }
 #endif /* H5_HAVE_FILTER_SZIP */
+#ifdef H5_HAVE_FILTER_LZ4
+    if (H5Z_register(H5Z_LZ4) < 0)
+        HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, FAIL, "unable to register lz4 filter");
+#endif /* H5_HAVE_FILTER_LZ4 */
+#ifdef H5_HAVE_FILTER_ZSTD
+    if (H5Z_register(H5Z_ZSTD) < 0)
+        HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, FAIL, "unable to register zstd filter");
+#endif /* H5_HAVE_FILTER_ZSTD */
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
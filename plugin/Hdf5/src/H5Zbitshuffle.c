@@ -0,0 +1,481 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://www.hdfgroup.org/licenses.               *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "H5Zmodule.h" /* This source code file is part of the H5Z module */
+
+#include "H5private.h"   /* Generic Functions			*/
+#include "H5Eprivate.h"  /* Error handling		  	*/
+#include "H5Iprivate.h"  /* IDs			  		*/
+#include "H5MMprivate.h" /* Memory management			*/
+#include "H5Pprivate.h"  /* Property lists                       */
+#include "H5Tprivate.h"  /* Datatypes         			*/
+#include "H5Zpkg.h"      /* Data filters				*/
+
+#ifdef H5_HAVE_FILTER_LZ4
+#include H5_LZ4_HEADER /* "lz4.h" */
+#endif
+#ifdef H5_HAVE_FILTER_ZSTD
+#include H5_ZSTD_HEADER /* "zstd.h" */
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define H5Z_BSHUF_SSE2
+#include <emmintrin.h>
+#endif
+
+/* Local function prototypes */
+static herr_t H5Z__set_local_bitshuffle(hid_t dcpl_id, hid_t type_id, hid_t space_id);
+static size_t H5Z__filter_bitshuffle(unsigned flags, size_t cd_nelmts, const unsigned cd_values[],
+                                     size_t nbytes, size_t *buf_size, void **buf);
+
+/* This message derives from H5Z */
+const H5Z_class2_t H5Z_BITSHUFFLE[1] = {{
+    H5Z_CLASS_T_VERS,          /* H5Z_class_t version */
+    H5Z_FILTER_BITSHUFFLE,     /* Filter id number		*/
+    1,                         /* encoder_present flag (set to true) */
+    1,                         /* decoder_present flag (set to true) */
+    "bitshuffle",              /* Filter name for debugging	*/
+    NULL,                      /* The "can apply" callback     */
+    H5Z__set_local_bitshuffle, /* The "set local" callback     */
+    H5Z__filter_bitshuffle,    /* The actual filter function	*/
+}};
+
+/* Local macros.  The parameters are those of the reference filter: its
+ * version, then the element size, and then the user parameters (block size,
+ * compression and compression level).
+ */
+#define H5Z_BSHUF_VERSION_MAJOR 0
+#define H5Z_BSHUF_VERSION_MINOR 5
+#define H5Z_BSHUF_PARM_ELEMSIZE 2  /* "Local" parameter for the element size */
+#define H5Z_BSHUF_PARM_BLOCK    3  /* Block size in elements */
+#define H5Z_BSHUF_PARM_COMPRESS 4  /* Compression done after the bitshuffle */
+#define H5Z_BSHUF_PARM_LEVEL    5  /* Compression level (Zstandard) */
+#define H5Z_BSHUF_NPARMS_MAX    11 /* Version, element size and up to 8 user parameters */
+#define H5Z_BSHUF_TARGET_BLOCK  8192 /* Default block size in bytes */
+#define H5Z_BSHUF_MIN_BLOCK     128  /* Minimum default block size in elements */
+#define H5Z_BSHUF_HEADER_SIZE   12   /* Original size (8 bytes) and block size in bytes (4 bytes) */
+
+/* Transposes the 8x8 bit matrix in x (row i is byte i, column j is bit j) */
+#define H5Z_BSHUF_TRANS_BIT_8X8(x, t)                                                                        \
+    do {                                                                                                     \
+        t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;                                                          \
+        x = x ^ t ^ (t << 7);                                                                                \
+        t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;                                                         \
+        x = x ^ t ^ (t << 14);                                                                               \
+        t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;                                                         \
+        x = x ^ t ^ (t << 28);                                                                               \
+    } while (0)
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__set_local_bitshuffle
+ *
+ * Purpose:	Set the "local" dataset parameters for bitshuffle: the
+ *              version and the size of the datatype, in front of the
+ *              parameters given by the user.
+ *
+ * Return:	Success: Non-negative
+ *		Failure: Negative
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5Z__set_local_bitshuffle(hid_t dcpl_id, hid_t type_id, hid_t H5_ATTR_UNUSED space_id)
+{
+    H5P_genplist_t *dcpl_plist;                          /* Property list pointer */
+    const H5T_t    *type;                                /* Datatype */
+    unsigned        flags;                               /* Filter flags */
+    size_t          cd_nelmts = H5Z_BSHUF_NPARMS_MAX - 3; /* Number of user parameters */
+    unsigned        user_values[H5Z_BSHUF_NPARMS_MAX - 3]; /* User parameters */
+    unsigned        cd_values[H5Z_BSHUF_NPARMS_MAX];     /* Filter parameters */
+    size_t          u;
+    herr_t          ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    /* Get the plist structure */
+    if (NULL == (dcpl_plist = H5P_object_verify(dcpl_id, H5P_DATASET_CREATE)))
+        HGOTO_ERROR(H5E_ID, H5E_BADID, FAIL, "can't find object for ID");
+
+    /* Get datatype */
+    if (NULL == (type = (const H5T_t *)H5I_object_verify(type_id, H5I_DATATYPE)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a datatype");
+
+    /* Get the filter's current parameters */
+    if (H5P_get_filter_by_id(dcpl_plist, H5Z_FILTER_BITSHUFFLE, &flags, &cd_nelmts, user_values, (size_t)0,
+                             NULL, NULL) < 0)
+        HGOTO_ERROR(H5E_PLINE, H5E_CANTGET, FAIL, "can't get bitshuffle parameters");
+    cd_nelmts = MIN(cd_nelmts, H5Z_BSHUF_NPARMS_MAX - 3);
+
+    /* Set "local" parameters for this dataset */
+    memset(cd_values, 0, sizeof(cd_values));
+    cd_values[0] = H5Z_BSHUF_VERSION_MAJOR;
+    cd_values[1] = H5Z_BSHUF_VERSION_MINOR;
+    if ((cd_values[H5Z_BSHUF_PARM_ELEMSIZE] = (unsigned)H5T_get_size(type)) == 0)
+        HGOTO_ERROR(H5E_PLINE, H5E_BADTYPE, FAIL, "bad datatype size");
+    for (u = 0; u < cd_nelmts; u++)
+        cd_values[H5Z_BSHUF_PARM_BLOCK + u] = user_values[u];
+
+    /* Check the user parameters */
+    if (cd_values[H5Z_BSHUF_PARM_BLOCK] % 8)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "bitshuffle block size is not a multiple of 8");
+    switch (cd_values[H5Z_BSHUF_PARM_COMPRESS]) {
+        case H5Z_BSHUF_COMPRESS_NONE:
+            break;
+#ifdef H5_HAVE_FILTER_LZ4
+        case H5Z_BSHUF_COMPRESS_LZ4:
+            break;
+#endif
+#ifdef H5_HAVE_FILTER_ZSTD
+        case H5Z_BSHUF_COMPRESS_ZSTD:
+            break;
+#endif
+        default:
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "bitshuffle compression is not available");
+    }
+
+    /* Modify the filter's parameters for this dataset */
+    if (H5P_modify_filter(dcpl_plist, H5Z_FILTER_BITSHUFFLE, flags, 3 + cd_nelmts, cd_values) < 0)
+        HGOTO_ERROR(H5E_PLINE, H5E_CANTSET, FAIL, "can't set local bitshuffle parameters");
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5Z__set_local_bitshuffle() */
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__bshuf_trans_bits
+ *
+ * Purpose:	Transposes the bits of each of the NWORDS 8-byte words in
+ *              BUF as 8x8 bit matrices, in place.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5Z__bshuf_trans_bits(uint8_t *buf, size_t nwords)
+{
+    size_t i = 0;
+
+#ifdef H5Z_BSHUF_SSE2
+    {
+        const __m128i m1 = _mm_set1_epi64x(0x00AA00AA00AA00AALL);
+        const __m128i m2 = _mm_set1_epi64x(0x0000CCCC0000CCCCLL);
+        const __m128i m3 = _mm_set1_epi64x(0x00000000F0F0F0F0LL);
+
+        for (; i + 2 <= nwords; i += 2) {
+            __m128i x = _mm_loadu_si128((const __m128i *)(buf + 8 * i)), t;
+
+            t = _mm_and_si128(_mm_xor_si128(x, _mm_srli_epi64(x, 7)), m1);
+            x = _mm_xor_si128(x, _mm_xor_si128(t, _mm_slli_epi64(t, 7)));
+            t = _mm_and_si128(_mm_xor_si128(x, _mm_srli_epi64(x, 14)), m2);
+            x = _mm_xor_si128(x, _mm_xor_si128(t, _mm_slli_epi64(t, 14)));
+            t = _mm_and_si128(_mm_xor_si128(x, _mm_srli_epi64(x, 28)), m3);
+            x = _mm_xor_si128(x, _mm_xor_si128(t, _mm_slli_epi64(t, 28)));
+            _mm_storeu_si128((__m128i *)(buf + 8 * i), x);
+        }
+    }
+#endif
+
+    for (; i < nwords; i++) {
+        uint8_t *p = buf + 8 * i;
+        uint64_t x = 0, t;
+        unsigned j;
+
+        /* Byte j is row j, whatever the byte order of the machine */
+        for (j = 0; j < 8; j++)
+            x |= (uint64_t)p[j] << (8 * j);
+        H5Z_BSHUF_TRANS_BIT_8X8(x, t);
+        for (j = 0; j < 8; j++)
+            p[j] = (uint8_t)(x >> (8 * j));
+    }
+} /* end H5Z__bshuf_trans_bits() */
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__bshuf_block
+ *
+ * Purpose:	Bitshuffles (or unshuffles, when REVERSE is set) one block
+ *              of N elements, N a multiple of 8, from SRC into DEST.  TMP
+ *              has room for the block.
+ *
+ *              The result has one row of N bits for every bit of every
+ *              byte of the elements, bit 0 of byte 0 first; the bit of
+ *              element i is bit i%8 of byte i/8 of the row.  This is done
+ *              as a byte shuffle of the elements, an 8x8 bit transpose of
+ *              each group of 8 bytes, and a byte shuffle of the groups of
+ *              each byte position, so all steps use the SIMD kernels.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5Z__bshuf_block(uint8_t *dest, const uint8_t *src, uint8_t *tmp, size_t n, size_t elem_size, bool reverse)
+{
+    size_t nbytes = n * elem_size;
+    size_t b;
+
+    if (!reverse) {
+        if (elem_size > 1)
+            H5Z_shuffle_buf(tmp, src, nbytes, (unsigned)elem_size, false);
+        else
+            H5MM_memcpy(tmp, src, nbytes);
+        H5Z__bshuf_trans_bits(tmp, nbytes / 8);
+        for (b = 0; b < elem_size; b++)
+            H5Z_shuffle_buf(dest + b * n, tmp + b * n, n, 8, false);
+    }
+    else {
+        for (b = 0; b < elem_size; b++)
+            H5Z_shuffle_buf(tmp + b * n, src + b * n, n, 8, true);
+        H5Z__bshuf_trans_bits(tmp, nbytes / 8);
+        if (elem_size > 1)
+            H5Z_shuffle_buf(dest, tmp, nbytes, (unsigned)elem_size, true);
+        else
+            H5MM_memcpy(dest, tmp, nbytes);
+    }
+} /* end H5Z__bshuf_block() */
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__filter_bitshuffle
+ *
+ * Purpose:	Implement an I/O filter which transposes the bits of the
+ *              elements in blocks, so that the same bit of consecutive
+ *              elements is stored together.  The blocks may then be
+ *              compressed with LZ4 or Zstandard.
+ *
+ *              The layout is the one of the registered bitshuffle filter
+ *              (32008), so files are readable by other installations.
+ *              Blocks have H5Z_BSHUF_PARM_BLOCK elements, then one block
+ *              has the rest of the elements rounded down to a multiple of
+ *              8, and the last elements are stored as they are.  With
+ *              compression the data starts with the original size
+ *              (big-endian 64-bit) and the block size in bytes (big-endian
+ *              32-bit), and each block is stored as its compressed size
+ *              (big-endian 32-bit) and its bytes.
+ *
+ * Return:	Success: Size of buffer filtered
+ *		Failure: 0
+ *
+ *-------------------------------------------------------------------------
+ */
+static size_t
+H5Z__filter_bitshuffle(unsigned flags, size_t cd_nelmts, const unsigned cd_values[], size_t nbytes,
+                       size_t *buf_size, void **buf)
+{
+    const uint8_t *src      = (const uint8_t *)*buf; /* Current read position */
+    const uint8_t *end      = src + nbytes;          /* End of the input */
+    uint8_t       *outbuf   = NULL;                  /* Pointer to new buffer */
+    uint8_t       *tmp      = NULL;                  /* Block being transposed */
+    uint8_t       *tmp2     = NULL;                  /* Block being compressed */
+    uint8_t       *dst;                              /* Current write position */
+    size_t         elem_size;                        /* Bytes per element */
+    size_t         block;                            /* Elements per block */
+    unsigned       compress = H5Z_BSHUF_COMPRESS_NONE; /* Compression after the transpose */
+#ifdef H5_HAVE_FILTER_ZSTD
+    int level = 0; /* Compression level */
+#endif
+    size_t         origsize;                         /* Uncompressed size */
+    size_t         outsize;                          /* Size of the output buffer */
+    size_t         nelmts, done, n, last, leftover;
+    bool           reverse = (flags & H5Z_FLAG_REVERSE) != 0;
+    size_t         ret_value = 0; /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    /* Sanity check */
+    assert(*buf_size > 0);
+    assert(buf);
+    assert(*buf);
+
+    /* Check arguments */
+    if (cd_nelmts <= H5Z_BSHUF_PARM_ELEMSIZE || cd_values[H5Z_BSHUF_PARM_ELEMSIZE] == 0)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, 0, "invalid bitshuffle parameters");
+    elem_size = cd_values[H5Z_BSHUF_PARM_ELEMSIZE];
+    block     = cd_nelmts > H5Z_BSHUF_PARM_BLOCK ? cd_values[H5Z_BSHUF_PARM_BLOCK] : 0;
+    if (cd_nelmts > H5Z_BSHUF_PARM_COMPRESS)
+        compress = cd_values[H5Z_BSHUF_PARM_COMPRESS];
+#ifdef H5_HAVE_FILTER_ZSTD
+    if (cd_nelmts > H5Z_BSHUF_PARM_LEVEL)
+        level = (int)cd_values[H5Z_BSHUF_PARM_LEVEL];
+#endif
+
+    /* Default block size, which must never change as it isn't stored */
+    if (block == 0) {
+        block = (H5Z_BSHUF_TARGET_BLOCK / elem_size) / 8 * 8;
+        block = MAX(block, H5Z_BSHUF_MIN_BLOCK);
+    }
+
+    switch (compress) {
+        case H5Z_BSHUF_COMPRESS_NONE:
+            break;
+#ifdef H5_HAVE_FILTER_LZ4
+        case H5Z_BSHUF_COMPRESS_LZ4:
+            break;
+#endif
+#ifdef H5_HAVE_FILTER_ZSTD
+        case H5Z_BSHUF_COMPRESS_ZSTD:
+            break;
+#endif
+        default:
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "bitshuffle compression is not available");
+    }
+
+    /* The compressed data starts with the sizes */
+    if (compress != H5Z_BSHUF_COMPRESS_NONE && reverse) {
+        uint64_t size64 = 0;
+        unsigned u;
+
+        if (nbytes < H5Z_BSHUF_HEADER_SIZE)
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "bitshuffle header is truncated");
+        for (u = 0; u < 8; u++)
+            size64 = (size64 << 8) | *src++;
+        block = (((size_t)src[0] << 24) | ((size_t)src[1] << 16) | ((size_t)src[2] << 8) | src[3]) / elem_size;
+        src += 4;
+        if (size64 > (uint64_t)SIZE_MAX)
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "invalid bitshuffle header");
+        origsize = (size_t)size64;
+    }
+    else
+        origsize = nbytes;
+    if (block == 0 || block % 8)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, 0, "invalid bitshuffle block size");
+    if (origsize % elem_size)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, 0, "bitshuffle data is not a whole number of elements");
+    nelmts = origsize / elem_size;
+
+    /* Size of the output buffer */
+    if (compress != H5Z_BSHUF_COMPRESS_NONE && !reverse) {
+        size_t nblocks = nelmts / block + 1;
+
+        outsize = H5Z_BSHUF_HEADER_SIZE + 4 * nblocks + origsize;
+#ifdef H5_HAVE_FILTER_LZ4
+        if (compress == H5Z_BSHUF_COMPRESS_LZ4)
+            outsize += nblocks * ((size_t)LZ4_compressBound((int)MIN(block * elem_size, INT32_MAX / 2)) -
+                                  block * elem_size);
+#endif
+#ifdef H5_HAVE_FILTER_ZSTD
+        if (compress == H5Z_BSHUF_COMPRESS_ZSTD)
+            outsize += nblocks * (ZSTD_compressBound(block * elem_size) - block * elem_size);
+#endif
+    }
+    else
+        outsize = origsize;
+
+    if (NULL == (outbuf = (uint8_t *)H5MM_malloc(MAX(outsize, 1))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "memory allocation failed for bitshuffle buffer");
+    if (NULL == (tmp = (uint8_t *)H5MM_malloc(MAX(block * elem_size, 1))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "memory allocation failed for bitshuffle buffer");
+    if (compress != H5Z_BSHUF_COMPRESS_NONE && NULL == (tmp2 = (uint8_t *)H5MM_malloc(MAX(block * elem_size, 1))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "memory allocation failed for bitshuffle buffer");
+    dst = outbuf;
+
+    if (compress != H5Z_BSHUF_COMPRESS_NONE && !reverse) {
+        int u;
+
+        if (block * elem_size > UINT32_MAX)
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, 0, "bitshuffle block is too large");
+        for (u = 7; u >= 0; u--)
+            *dst++ = (uint8_t)((uint64_t)origsize >> (8 * u));
+        for (u = 3; u >= 0; u--)
+            *dst++ = (uint8_t)((block * elem_size) >> (8 * u));
+    }
+
+    /* Whole blocks, then the rest rounded down to a multiple of 8 */
+    last = (nelmts % block) / 8 * 8;
+    for (done = 0; done < nelmts - nelmts % block + last; done += n) {
+        size_t len;
+
+        n   = done < nelmts - nelmts % block ? block : last;
+        len = n * elem_size;
+
+        if (compress == H5Z_BSHUF_COMPRESS_NONE) {
+            H5Z__bshuf_block(dst, src, tmp, n, elem_size, reverse);
+            src += len;
+            dst += len;
+        }
+        else if (!reverse) {
+            size_t complen = 0;
+
+            H5Z__bshuf_block(tmp2, src, tmp, n, elem_size, false);
+#ifdef H5_HAVE_FILTER_LZ4
+            if (compress == H5Z_BSHUF_COMPRESS_LZ4) {
+                int ret = LZ4_compress_default((const char *)tmp2, (char *)dst + 4, (int)len,
+                                               LZ4_compressBound((int)len));
+
+                if (ret <= 0)
+                    HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "lz4 compression failed");
+                complen = (size_t)ret;
+            }
+#endif
+#ifdef H5_HAVE_FILTER_ZSTD
+            if (compress == H5Z_BSHUF_COMPRESS_ZSTD) {
+                complen = ZSTD_compress(dst + 4, ZSTD_compressBound(len), tmp2, len,
+                                        level != 0 ? level : ZSTD_CLEVEL_DEFAULT);
+                if (ZSTD_isError(complen))
+                    HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "zstd compression failed");
+            }
+#endif
+            dst[0] = (uint8_t)(complen >> 24);
+            dst[1] = (uint8_t)(complen >> 16);
+            dst[2] = (uint8_t)(complen >> 8);
+            dst[3] = (uint8_t)complen;
+            src += len;
+            dst += 4 + complen;
+        }
+        else {
+            size_t complen;
+
+            if (end - src < 4)
+                HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "bitshuffle block is truncated");
+            complen = ((size_t)src[0] << 24) | ((size_t)src[1] << 16) | ((size_t)src[2] << 8) | src[3];
+            src += 4;
+            if ((size_t)(end - src) < complen)
+                HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "bitshuffle block is truncated");
+#ifdef H5_HAVE_FILTER_LZ4
+            if (compress == H5Z_BSHUF_COMPRESS_LZ4 &&
+                LZ4_decompress_safe((const char *)src, (char *)tmp2, (int)complen, (int)len) != (int)len)
+                HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "lz4 uncompression failed");
+#endif
+#ifdef H5_HAVE_FILTER_ZSTD
+            if (compress == H5Z_BSHUF_COMPRESS_ZSTD && ZSTD_decompress(tmp2, len, src, complen) != len)
+                HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "zstd uncompression failed");
+#endif
+            H5Z__bshuf_block(dst, tmp2, tmp, n, elem_size, true);
+            src += complen;
+            dst += len;
+        }
+    }
+
+    /* The last elements are stored as they are */
+    leftover = (nelmts % 8) * elem_size;
+    if ((size_t)(end - src) < leftover)
+        HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "bitshuffle data is truncated");
+    H5MM_memcpy(dst, src, leftover);
+    dst += leftover;
+
+    /* Free the input buffer */
+    H5MM_xfree(*buf);
+
+    /* Set return values */
+    ret_value = (size_t)(dst - outbuf);
+    *buf      = outbuf;
+    outbuf    = NULL;
+    *buf_size = MAX(outsize, 1);
+
+done:
+    if (outbuf)
+        H5MM_xfree(outbuf);
+    if (tmp)
+        H5MM_xfree(tmp);
+    if (tmp2)
+        H5MM_xfree(tmp2);
+    FUNC_LEAVE_NOAPI(ret_value)
+}
@@ -415,6 +415,12 @@ H5_DLL herr_t H5Zregister(const void *cls);
  */
 H5_DLL herr_t H5Zunregister(H5Z_filter_t id);
 
+/* Library routines used to decode and encode raw chunks outside the library. They do not enter the API, so
+ * they can be called from any thread while another one is in the library */
+H5_DLL uint32_t H5_checksum_fletcher32(const void *data, size_t len);
+H5_DLL void     H5Z_shuffle_buf(void *dest, const void *src, size_t nbytes, unsigned bytesoftype,
+                                bool reverse);
+
 #ifdef __cplusplus
 }
 #endif
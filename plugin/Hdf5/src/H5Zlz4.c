@@ -0,0 +1,201 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://www.hdfgroup.org/licenses.               *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "H5Zmodule.h" /* This source code file is part of the H5Z module */
+
+#include "H5private.h"   /* Generic Functions			*/
+#include "H5Eprivate.h"  /* Error handling		  	*/
+#include "H5MMprivate.h" /* Memory management			*/
+#include "H5Zpkg.h"      /* Data filters				*/
+
+#ifdef H5_HAVE_FILTER_LZ4
+
+#include H5_LZ4_HEADER /* "lz4.h" */
+
+/* Local function prototypes */
+static size_t H5Z__filter_lz4(unsigned flags, size_t cd_nelmts, const unsigned cd_values[], size_t nbytes,
+                              size_t *buf_size, void **buf);
+
+/* This message derives from H5Z */
+const H5Z_class2_t H5Z_LZ4[1] = {{
+    H5Z_CLASS_T_VERS, /* H5Z_class_t version */
+    H5Z_FILTER_LZ4,   /* Filter id number		*/
+    1,                /* encoder_present flag (set to true) */
+    1,                /* decoder_present flag (set to true) */
+    "lz4",            /* Filter name for debugging	*/
+    NULL,             /* The "can apply" callback     */
+    NULL,             /* The "set local" callback     */
+    H5Z__filter_lz4,  /* The actual filter function	*/
+}};
+
+/* Local macros */
+#define H5Z_LZ4_HEADER_SIZE      12         /* Original size (8 bytes) and block size (4 bytes) */
+#define H5Z_LZ4_DEFAULT_BLOCK    (1 << 30)  /* Block size when none is given */
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__filter_lz4
+ *
+ * Purpose:	Implement an I/O filter around the LZ4 block compressor.
+ *
+ *              The layout is the one of the registered LZ4 filter (32004),
+ *              so files are readable by other installations: the original
+ *              size as a big-endian 64-bit value and the block size as a
+ *              big-endian 32-bit value, then every block as its compressed
+ *              size (big-endian 32-bit) and its bytes.  A block whose
+ *              compressed size equals its original size is stored as is.
+ *
+ *              The optional cd_values[0] is the block size in bytes.
+ *
+ * Return:	Success: Size of buffer filtered
+ *		Failure: 0
+ *
+ *-------------------------------------------------------------------------
+ */
+static size_t
+H5Z__filter_lz4(unsigned flags, size_t cd_nelmts, const unsigned cd_values[], size_t nbytes, size_t *buf_size,
+                void **buf)
+{
+    void          *outbuf = NULL; /* Pointer to new buffer */
+    const uint8_t *src;           /* Current read position */
+    uint8_t       *dst;           /* Current write position */
+    size_t         blocksize;     /* Uncompressed size of each block */
+    size_t         ret_value = 0; /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    /* Sanity check */
+    assert(*buf_size > 0);
+    assert(buf);
+    assert(*buf);
+
+    src = (const uint8_t *)*buf;
+
+    if (flags & H5Z_FLAG_REVERSE) {
+        /* Input; uncompress */
+        const uint8_t *end = src + nbytes; /* End of compressed data */
+        uint64_t       origsize = 0;       /* Uncompressed size */
+        size_t         done     = 0;       /* Bytes uncompressed so far */
+        unsigned       u;
+
+        if (nbytes < H5Z_LZ4_HEADER_SIZE)
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "lz4 header is truncated");
+        for (u = 0; u < 8; u++)
+            origsize = (origsize << 8) | *src++;
+        blocksize = ((size_t)src[0] << 24) | ((size_t)src[1] << 16) | ((size_t)src[2] << 8) | src[3];
+        src += 4;
+        if (origsize > (uint64_t)SIZE_MAX || (origsize > 0 && blocksize == 0))
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "invalid lz4 header");
+        if (blocksize > origsize)
+            blocksize = (size_t)origsize;
+
+        if (NULL == (outbuf = H5MM_malloc(MAX((size_t)origsize, 1))))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "memory allocation failed for lz4 uncompression");
+        dst = (uint8_t *)outbuf;
+
+        while (done < origsize) {
+            size_t len = MIN(blocksize, (size_t)origsize - done); /* The last block can be shorter */
+            size_t complen;                                       /* Compressed size of the block */
+
+            if (end - src < 4)
+                HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "lz4 block is truncated");
+            complen = ((size_t)src[0] << 24) | ((size_t)src[1] << 16) | ((size_t)src[2] << 8) | src[3];
+            src += 4;
+            if ((size_t)(end - src) < complen)
+                HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "lz4 block is truncated");
+
+            if (complen == len)
+                H5MM_memcpy(dst, src, len);
+            else if (LZ4_decompress_safe((const char *)src, (char *)dst, (int)complen, (int)len) != (int)len)
+                HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "lz4 uncompression failed");
+
+            src += complen;
+            dst += len;
+            done += len;
+        }
+
+        /* Free the input buffer */
+        H5MM_xfree(*buf);
+
+        /* Set return values */
+        *buf      = outbuf;
+        outbuf    = NULL;
+        *buf_size = MAX((size_t)origsize, 1);
+        ret_value = (size_t)origsize;
+    } /* end if */
+    else {
+        /* Output; compress */
+        size_t nblocks; /* Number of blocks */
+        size_t outsize; /* Size of the output buffer */
+        size_t done;    /* Bytes compressed so far */
+        int    u;
+
+        /* LZ4 works with int sizes */
+        if (nbytes > INT32_MAX)
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, 0, "chunk is too large for lz4");
+
+        if (cd_nelmts > 0 && cd_values[0] > 0)
+            blocksize = cd_values[0];
+        else
+            blocksize = H5Z_LZ4_DEFAULT_BLOCK;
+        if (blocksize > nbytes)
+            blocksize = nbytes;
+        nblocks = nbytes > 0 ? (nbytes - 1) / blocksize + 1 : 0;
+
+        /* A block that doesn't shrink is stored as is, so the output is at
+         * most as big as the input plus the headers
+         */
+        outsize = H5Z_LZ4_HEADER_SIZE + 4 * nblocks + nbytes;
+        if (NULL == (outbuf = H5MM_malloc(outsize)))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "unable to allocate lz4 destination buffer");
+        dst = (uint8_t *)outbuf;
+
+        for (u = 7; u >= 0; u--)
+            *dst++ = (uint8_t)((uint64_t)nbytes >> (8 * u));
+        for (u = 3; u >= 0; u--)
+            *dst++ = (uint8_t)(blocksize >> (8 * u));
+
+        for (done = 0; done < nbytes; done += blocksize) {
+            size_t len = MIN(blocksize, nbytes - done); /* The last block can be shorter */
+            int    complen;                             /* Compressed size of the block */
+
+            /* Compressing into one byte less than the block either shrinks it
+             * or fails, and then the block is stored as is
+             */
+            complen = len > 1 ? LZ4_compress_default((const char *)src, (char *)dst + 4, (int)len, (int)len - 1)
+                              : 0;
+            if (complen <= 0) {
+                H5MM_memcpy(dst + 4, src, len);
+                complen = (int)len;
+            }
+            for (u = 3; u >= 0; u--)
+                *dst++ = (uint8_t)((unsigned)complen >> (8 * u));
+
+            src += len;
+            dst += complen;
+        }
+
+        /* Free the input buffer */
+        H5MM_xfree(*buf);
+
+        /* Set return values */
+        ret_value = (size_t)(dst - (uint8_t *)outbuf);
+        *buf      = outbuf;
+        outbuf    = NULL;
+        *buf_size = outsize;
+    } /* end else */
+
+done:
+    if (outbuf)
+        H5MM_xfree(outbuf);
+    FUNC_LEAVE_NOAPI(ret_value)
+}
+#endif /* H5_HAVE_FILTER_LZ4 */
@@ -36,6 +36,9 @@ H5_DLLVAR H5Z_class2_t H5Z_NBIT[1];
 /* Scale/offset filter */
 H5_DLLVAR H5Z_class2_t H5Z_SCALEOFFSET[1];
 
+/* Bitshuffle filter */
+H5_DLLVAR const H5Z_class2_t H5Z_BITSHUFFLE[1];
+
 /********************/
 /* External filters */
 /********************/
@@ -50,6 +53,16 @@ H5_DLLVAR const H5Z_class2_t H5Z_DEFLATE[1];
 H5_DLLVAR H5Z_class2_t H5Z_SZIP[1];
 #endif /* H5_HAVE_FILTER_SZIP */
 
+/* LZ4 filter */
+#ifdef H5_HAVE_FILTER_LZ4
+H5_DLLVAR const H5Z_class2_t H5Z_LZ4[1];
+#endif /* H5_HAVE_FILTER_LZ4 */
+
+/* Zstandard filter */
+#ifdef H5_HAVE_FILTER_ZSTD
+H5_DLLVAR const H5Z_class2_t H5Z_ZSTD[1];
+#endif /* H5_HAVE_FILTER_ZSTD */
+
 /* Package internal routines */
 H5_DLL herr_t H5Z__unregister(H5Z_filter_t filter_id);
 
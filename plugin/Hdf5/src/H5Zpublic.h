@@ -95,6 +95,18 @@ typedef int H5Z_filter_t;
  * maximum filter id
  */
 #define H5Z_FILTER_MAX 65535
+/**
+ * LZ4 compression (registered filter, built in when available)
+ */
+#define H5Z_FILTER_LZ4 32004
+/**
+ * Bitshuffle (registered filter, built in)
+ */
+#define H5Z_FILTER_BITSHUFFLE 32008
+/**
+ * Zstandard compression (registered filter, built in when available)
+ */
+#define H5Z_FILTER_ZSTD 32015
 
 /* General macros */
 /**
@@ -259,6 +271,29 @@ typedef enum H5Z_SO_scale_type_t {
     H5Z_SO_INT          = 2
 } H5Z_SO_scale_type_t;
 
+/* Macros for the bitshuffle filter */
+/**
+ * \ingroup BITSHUFFLE
+ * Number of parameters that users can set for the bitshuffle filter: block
+ * size in elements (0 for the default), compression and compression level
+ */
+#define H5Z_BSHUF_USER_NPARMS 3
+/**
+ * \ingroup BITSHUFFLE
+ * No compression after the bitshuffle
+ */
+#define H5Z_BSHUF_COMPRESS_NONE 0
+/**
+ * \ingroup BITSHUFFLE
+ * LZ4 compression of each block after the bitshuffle
+ */
+#define H5Z_BSHUF_COMPRESS_LZ4 2
+/**
+ * \ingroup BITSHUFFLE
+ * Zstandard compression of each block after the bitshuffle
+ */
+#define H5Z_BSHUF_COMPRESS_ZSTD 3
+
 /**
  * \ingroup FLETCHER32
  * Values to decide if EDC is enabled for reading data
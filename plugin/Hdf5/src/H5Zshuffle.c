@@ -40,6 +40,453 @@ const H5Z_class2_t H5Z_SHUFFLE[1] = {{
 /* Local macros */
 #define H5Z_SHUFFLE_PARM_SIZE 0 /* "Local" parameter for shuffling size */
 
+/* SIMD kernels.  They handle element sizes of 2, 4, 8 and 16 bytes in blocks
+ * of 16 (SSE2, NEON) or 32 (AVX2) elements; the remaining elements go through
+ * the scalar loop.  SSE2 and NEON are always present on x86-64 and AArch64,
+ * AVX2 is checked at run time.
+ */
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define H5Z_SHUFFLE_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+#define H5Z_SHUFFLE_AVX2
+#include <immintrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define H5Z_SHUFFLE_NEON
+#include <arm_neon.h>
+#endif
+
+/* The kernels are written for any of the element sizes and rely on the
+ * compiler to fully unroll them once the size is a constant.
+ */
+#if defined(__clang__)
+#define H5Z_SHUFFLE_INLINE      static inline __attribute__((always_inline))
+#define H5Z_SHUFFLE_AVX2_TARGET __attribute__((target("avx2")))
+#define H5Z_SHUFFLE_UNROLL      _Pragma("clang loop unroll(full)")
+#elif defined(__GNUC__)
+#define H5Z_SHUFFLE_INLINE      static inline __attribute__((always_inline))
+#define H5Z_SHUFFLE_AVX2_TARGET __attribute__((target("avx2")))
+#if __GNUC__ >= 8
+#define H5Z_SHUFFLE_UNROLL _Pragma("GCC unroll 16")
+#else
+#define H5Z_SHUFFLE_UNROLL
+#endif
+#elif defined(_MSC_VER)
+#define H5Z_SHUFFLE_INLINE static __forceinline
+#define H5Z_SHUFFLE_AVX2_TARGET
+#define H5Z_SHUFFLE_UNROLL
+#else
+#define H5Z_SHUFFLE_INLINE static inline
+#define H5Z_SHUFFLE_AVX2_TARGET
+#define H5Z_SHUFFLE_UNROLL
+#endif
+
+/* Defines the byte transposes of one block for the vector type VEC, given
+ * ZIP(a, b, w, lo, hi), which interleaves the w-byte units of a and b, and
+ * UNZIP(lo, hi, w, a, b), its inverse.
+ *
+ * The block starts (shuffle) or ends (unshuffle) as bytesoftype vectors of
+ * consecutive elements and ends (shuffle) or starts (unshuffle) as one vector
+ * per byte position.  Each step of the unshuffle merges pairs of byte groups,
+ * so that after log2(bytesoftype) steps every group holds whole elements.
+ * Every step is one loop over the bytesoftype / 2 pairs, which also bounds
+ * the indexes of the 16 vectors for the compiler.
+ */
+#define H5Z_SHUFFLE_BLOCK(ISA, VEC, ATTR, ZIP, UNZIP)                                                        \
+    H5Z_SHUFFLE_INLINE ATTR void H5Z__shuffle_block_##ISA(VEC *v, unsigned bytesoftype)                      \
+    {                                                                                                        \
+        VEC      t[16];                                                                                      \
+        unsigned half = bytesoftype / 2, nchunks = bytesoftype, w, k, g, c;                                  \
+                                                                                                             \
+        H5Z_SHUFFLE_UNROLL                                                                                   \
+        for (w = half; w > 0; w /= 2) {                                                                      \
+            H5Z_SHUFFLE_UNROLL                                                                               \
+            for (k = 0; k < half && k < 8; k++) {                                                            \
+                g = k / (nchunks / 2);                                                                       \
+                c = k % (nchunks / 2);                                                                       \
+                UNZIP(v[2 * k], v[2 * k + 1], w, &t[g * nchunks + c], &t[g * nchunks + nchunks / 2 + c]);    \
+            }                                                                                                \
+            nchunks /= 2;                                                                                    \
+            H5Z_SHUFFLE_UNROLL                                                                               \
+            for (k = 0; k < bytesoftype && k < 16; k++)                                                      \
+                v[k] = t[k];                                                                                 \
+        }                                                                                                    \
+    }                                                                                                        \
+    H5Z_SHUFFLE_INLINE ATTR void H5Z__unshuffle_block_##ISA(VEC *v, unsigned bytesoftype)                    \
+    {                                                                                                        \
+        VEC      t[16];                                                                                      \
+        unsigned half = bytesoftype / 2, nchunks = 1, w, k, g, c;                                            \
+                                                                                                             \
+        H5Z_SHUFFLE_UNROLL                                                                                   \
+        for (w = 1; w < bytesoftype; w *= 2) {                                                               \
+            H5Z_SHUFFLE_UNROLL                                                                               \
+            for (k = 0; k < half && k < 8; k++) {                                                            \
+                g = k / nchunks;                                                                             \
+                c = k % nchunks;                                                                             \
+                ZIP(v[2 * g * nchunks + c], v[(2 * g + 1) * nchunks + c], w, &t[2 * k], &t[2 * k + 1]);      \
+            }                                                                                                \
+            nchunks *= 2;                                                                                    \
+            H5Z_SHUFFLE_UNROLL                                                                               \
+            for (k = 0; k < bytesoftype && k < 16; k++)                                                      \
+                v[k] = t[k];                                                                                 \
+        }                                                                                                    \
+    }
+
+/* Dispatches a kernel on the element sizes it has been specialized for */
+#define H5Z_SHUFFLE_DISPATCH(LOOP, dest, src, numofelements, bytesoftype)                                    \
+    switch (bytesoftype) {                                                                                   \
+        case 2:                                                                                              \
+            return LOOP(dest, src, numofelements, 2);                                                        \
+        case 4:                                                                                              \
+            return LOOP(dest, src, numofelements, 4);                                                        \
+        case 8:                                                                                              \
+            return LOOP(dest, src, numofelements, 8);                                                        \
+        case 16:                                                                                             \
+            return LOOP(dest, src, numofelements, 16);                                                       \
+        default:                                                                                             \
+            return 0;                                                                                        \
+    }
+
+#ifdef H5Z_SHUFFLE_SSE2
+H5Z_SHUFFLE_INLINE void
+H5Z__zip_sse2(__m128i a, __m128i b, unsigned w, __m128i *lo, __m128i *hi)
+{
+    switch (w) {
+        case 1:
+            *lo = _mm_unpacklo_epi8(a, b);
+            *hi = _mm_unpackhi_epi8(a, b);
+            break;
+        case 2:
+            *lo = _mm_unpacklo_epi16(a, b);
+            *hi = _mm_unpackhi_epi16(a, b);
+            break;
+        case 4:
+            *lo = _mm_unpacklo_epi32(a, b);
+            *hi = _mm_unpackhi_epi32(a, b);
+            break;
+        default:
+            *lo = _mm_unpacklo_epi64(a, b);
+            *hi = _mm_unpackhi_epi64(a, b);
+            break;
+    }
+}
+
+H5Z_SHUFFLE_INLINE void
+H5Z__unzip_sse2(__m128i lo, __m128i hi, unsigned w, __m128i *a, __m128i *b)
+{
+    __m128i x, y;
+
+    switch (w) {
+        case 1:
+            x  = _mm_set1_epi16(0x00ff);
+            *a = _mm_packus_epi16(_mm_and_si128(lo, x), _mm_and_si128(hi, x));
+            *b = _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8));
+            break;
+        case 2:
+            /* Even 16-bit words to the low half, odd ones to the high half */
+            x  = _mm_shuffle_epi32(_mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, 0xd8), 0xd8), 0xd8);
+            y  = _mm_shuffle_epi32(_mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, 0xd8), 0xd8), 0xd8);
+            *a = _mm_unpacklo_epi64(x, y);
+            *b = _mm_unpackhi_epi64(x, y);
+            break;
+        case 4:
+            x  = _mm_shuffle_epi32(lo, 0xd8);
+            y  = _mm_shuffle_epi32(hi, 0xd8);
+            *a = _mm_unpacklo_epi64(x, y);
+            *b = _mm_unpackhi_epi64(x, y);
+            break;
+        default:
+            *a = _mm_unpacklo_epi64(lo, hi);
+            *b = _mm_unpackhi_epi64(lo, hi);
+            break;
+    }
+}
+
+H5Z_SHUFFLE_BLOCK(sse2, __m128i, , H5Z__zip_sse2, H5Z__unzip_sse2)
+
+H5Z_SHUFFLE_INLINE size_t
+H5Z__shuffle_loop_sse2(unsigned char *dest, const unsigned char *src, size_t numofelements,
+                       unsigned bytesoftype)
+{
+    __m128i  v[16];
+    size_t   i;
+    unsigned j;
+
+    for (i = 0; i + 16 <= numofelements; i += 16) {
+        H5Z_SHUFFLE_UNROLL
+        for (j = 0; j < bytesoftype; j++)
+            v[j] = _mm_loadu_si128((const __m128i *)(src + i * bytesoftype + j * 16));
+        H5Z__shuffle_block_sse2(v, bytesoftype);
+        H5Z_SHUFFLE_UNROLL
+        for (j = 0; j < bytesoftype; j++)
+            _mm_storeu_si128((__m128i *)(dest + j * numofelements + i), v[j]);
+    }
+
+    return i;
+}
+
+H5Z_SHUFFLE_INLINE size_t
+H5Z__unshuffle_loop_sse2(unsigned char *dest, const unsigned char *src, size_t numofelements,
+                         unsigned bytesoftype)
+{
+    __m128i  v[16];
+    size_t   i;
+    unsigned j;
+
+    for (i = 0; i + 16 <= numofelements; i += 16) {
+        H5Z_SHUFFLE_UNROLL
+        for (j = 0; j < bytesoftype; j++)
+            v[j] = _mm_loadu_si128((const __m128i *)(src + j * numofelements + i));
+        H5Z__unshuffle_block_sse2(v, bytesoftype);
+        H5Z_SHUFFLE_UNROLL
+        for (j = 0; j < bytesoftype; j++)
+            _mm_storeu_si128((__m128i *)(dest + i * bytesoftype + j * 16), v[j]);
+    }
+
+    return i;
+}
+
+static size_t
+H5Z__shuffle_sse2(unsigned char *dest, const unsigned char *src, size_t numofelements, unsigned bytesoftype)
+{
+    H5Z_SHUFFLE_DISPATCH(H5Z__shuffle_loop_sse2, dest, src, numofelements, bytesoftype)
+}
+
+static size_t
+H5Z__unshuffle_sse2(unsigned char *dest, const unsigned char *src, size_t numofelements, unsigned bytesoftype)
+{
+    H5Z_SHUFFLE_DISPATCH(H5Z__unshuffle_loop_sse2, dest, src, numofelements, bytesoftype)
+}
+#endif /* H5Z_SHUFFLE_SSE2 */
+
+#ifdef H5Z_SHUFFLE_AVX2
+/* Same as SSE2 on each 128-bit lane: the low lanes hold elements 0-15 of a
+ * block and the high lanes elements 16-31.
+ */
+H5Z_SHUFFLE_INLINE H5Z_SHUFFLE_AVX2_TARGET void
+H5Z__zip_avx2(__m256i a, __m256i b, unsigned w, __m256i *lo, __m256i *hi)
+{
+    switch (w) {
+        case 1:
+            *lo = _mm256_unpacklo_epi8(a, b);
+            *hi = _mm256_unpackhi_epi8(a, b);
+            break;
+        case 2:
+            *lo = _mm256_unpacklo_epi16(a, b);
+            *hi = _mm256_unpackhi_epi16(a, b);
+            break;
+        case 4:
+            *lo = _mm256_unpacklo_epi32(a, b);
+            *hi = _mm256_unpackhi_epi32(a, b);
+            break;
+        default:
+            *lo = _mm256_unpacklo_epi64(a, b);
+            *hi = _mm256_unpackhi_epi64(a, b);
+            break;
+    }
+}
+
+H5Z_SHUFFLE_INLINE H5Z_SHUFFLE_AVX2_TARGET void
+H5Z__unzip_avx2(__m256i lo, __m256i hi, unsigned w, __m256i *a, __m256i *b)
+{
+    __m256i x, y;
+
+    switch (w) {
+        case 1:
+            x  = _mm256_set1_epi16(0x00ff);
+            *a = _mm256_packus_epi16(_mm256_and_si256(lo, x), _mm256_and_si256(hi, x));
+            *b = _mm256_packus_epi16(_mm256_srli_epi16(lo, 8), _mm256_srli_epi16(hi, 8));
+            break;
+        case 2:
+            x  = _mm256_shuffle_epi32(_mm256_shufflehi_epi16(_mm256_shufflelo_epi16(lo, 0xd8), 0xd8), 0xd8);
+            y  = _mm256_shuffle_epi32(_mm256_shufflehi_epi16(_mm256_shufflelo_epi16(hi, 0xd8), 0xd8), 0xd8);
+            *a = _mm256_unpacklo_epi64(x, y);
+            *b = _mm256_unpackhi_epi64(x, y);
+            break;
+        case 4:
+            x  = _mm256_shuffle_epi32(lo, 0xd8);
+            y  = _mm256_shuffle_epi32(hi, 0xd8);
+            *a = _mm256_unpacklo_epi64(x, y);
+            *b = _mm256_unpackhi_epi64(x, y);
+            break;
+        default:
+            *a = _mm256_unpacklo_epi64(lo, hi);
+            *b = _mm256_unpackhi_epi64(lo, hi);
+            break;
+    }
+}
+
+H5Z_SHUFFLE_BLOCK(avx2, __m256i, H5Z_SHUFFLE_AVX2_TARGET, H5Z__zip_avx2, H5Z__unzip_avx2)
+
+H5Z_SHUFFLE_INLINE H5Z_SHUFFLE_AVX2_TARGET size_t
+H5Z__shuffle_loop_avx2(unsigned char *dest, const unsigned char *src, size_t numofelements,
+                       unsigned bytesoftype)
+{
+    __m256i  v[16];
+    size_t   i;
+    unsigned j;
+
+    for (i = 0; i + 32 <= numofelements; i += 32) {
+        const unsigned char *s = src + i * bytesoftype;
+
+        H5Z_SHUFFLE_UNROLL
+        for (j = 0; j < bytesoftype; j++)
+            v[j] = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(s + j * 16))),
+                _mm_loadu_si128((const __m128i *)(s + 16 * bytesoftype + j * 16)), 1);
+        H5Z__shuffle_block_avx2(v, bytesoftype);
+        H5Z_SHUFFLE_UNROLL
+        for (j = 0; j < bytesoftype; j++)
+            _mm256_storeu_si256((__m256i *)(dest + j * numofelements + i), v[j]);
+    }
+
+    return i;
+}
+
+H5Z_SHUFFLE_INLINE H5Z_SHUFFLE_AVX2_TARGET size_t
+H5Z__unshuffle_loop_avx2(unsigned char *dest, const unsigned char *src, size_t numofelements,
+                         unsigned bytesoftype)
+{
+    __m256i  v[16];
+    size_t   i;
+    unsigned j;
+
+    for (i = 0; i + 32 <= numofelements; i += 32) {
+        unsigned char *d = dest + i * bytesoftype;
+
+        H5Z_SHUFFLE_UNROLL
+        for (j = 0; j < bytesoftype; j++)
+            v[j] = _mm256_loadu_si256((const __m256i *)(src + j * numofelements + i));
+        H5Z__unshuffle_block_avx2(v, bytesoftype);
+        H5Z_SHUFFLE_UNROLL
+        for (j = 0; j < bytesoftype; j++) {
+            _mm_storeu_si128((__m128i *)(d + j * 16), _mm256_castsi256_si128(v[j]));
+            _mm_storeu_si128((__m128i *)(d + 16 * bytesoftype + j * 16), _mm256_extracti128_si256(v[j], 1));
+        }
+    }
+
+    return i;
+}
+
+static H5Z_SHUFFLE_AVX2_TARGET size_t
+H5Z__shuffle_avx2(unsigned char *dest, const unsigned char *src, size_t numofelements, unsigned bytesoftype)
+{
+    H5Z_SHUFFLE_DISPATCH(H5Z__shuffle_loop_avx2, dest, src, numofelements, bytesoftype)
+}
+
+static H5Z_SHUFFLE_AVX2_TARGET size_t
+H5Z__unshuffle_avx2(unsigned char *dest, const unsigned char *src, size_t numofelements,
+                    unsigned bytesoftype)
+{
+    H5Z_SHUFFLE_DISPATCH(H5Z__unshuffle_loop_avx2, dest, src, numofelements, bytesoftype)
+}
+#endif /* H5Z_SHUFFLE_AVX2 */
+
+#ifdef H5Z_SHUFFLE_NEON
+H5Z_SHUFFLE_INLINE void
+H5Z__zip_neon(uint8x16_t a, uint8x16_t b, unsigned w, uint8x16_t *lo, uint8x16_t *hi)
+{
+    switch (w) {
+        case 1:
+            *lo = vzip1q_u8(a, b);
+            *hi = vzip2q_u8(a, b);
+            break;
+        case 2:
+            *lo = vreinterpretq_u8_u16(vzip1q_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+            *hi = vreinterpretq_u8_u16(vzip2q_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+            break;
+        case 4:
+            *lo = vreinterpretq_u8_u32(vzip1q_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+            *hi = vreinterpretq_u8_u32(vzip2q_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+            break;
+        default:
+            *lo = vreinterpretq_u8_u64(vzip1q_u64(vreinterpretq_u64_u8(a), vreinterpretq_u64_u8(b)));
+            *hi = vreinterpretq_u8_u64(vzip2q_u64(vreinterpretq_u64_u8(a), vreinterpretq_u64_u8(b)));
+            break;
+    }
+}
+
+H5Z_SHUFFLE_INLINE void
+H5Z__unzip_neon(uint8x16_t lo, uint8x16_t hi, unsigned w, uint8x16_t *a, uint8x16_t *b)
+{
+    switch (w) {
+        case 1:
+            *a = vuzp1q_u8(lo, hi);
+            *b = vuzp2q_u8(lo, hi);
+            break;
+        case 2:
+            *a = vreinterpretq_u8_u16(vuzp1q_u16(vreinterpretq_u16_u8(lo), vreinterpretq_u16_u8(hi)));
+            *b = vreinterpretq_u8_u16(vuzp2q_u16(vreinterpretq_u16_u8(lo), vreinterpretq_u16_u8(hi)));
+            break;
+        case 4:
+            *a = vreinterpretq_u8_u32(vuzp1q_u32(vreinterpretq_u32_u8(lo), vreinterpretq_u32_u8(hi)));
+            *b = vreinterpretq_u8_u32(vuzp2q_u32(vreinterpretq_u32_u8(lo), vreinterpretq_u32_u8(hi)));
+            break;
+        default:
+            *a = vreinterpretq_u8_u64(vuzp1q_u64(vreinterpretq_u64_u8(lo), vreinterpretq_u64_u8(hi)));
+            *b = vreinterpretq_u8_u64(vuzp2q_u64(vreinterpretq_u64_u8(lo), vreinterpretq_u64_u8(hi)));
+            break;
+    }
+}
+
+H5Z_SHUFFLE_BLOCK(neon, uint8x16_t, , H5Z__zip_neon, H5Z__unzip_neon)
+
+H5Z_SHUFFLE_INLINE size_t
+H5Z__shuffle_loop_neon(unsigned char *dest, const unsigned char *src, size_t numofelements,
+                       unsigned bytesoftype)
+{
+    uint8x16_t v[16];
+    size_t     i;
+    unsigned   j;
+
+    for (i = 0; i + 16 <= numofelements; i += 16) {
+        H5Z_SHUFFLE_UNROLL
+        for (j = 0; j < bytesoftype; j++)
+            v[j] = vld1q_u8(src + i * bytesoftype + j * 16);
+        H5Z__shuffle_block_neon(v, bytesoftype);
+        H5Z_SHUFFLE_UNROLL
+        for (j = 0; j < bytesoftype; j++)
+            vst1q_u8(dest + j * numofelements + i, v[j]);
+    }
+
+    return i;
+}
+
+H5Z_SHUFFLE_INLINE size_t
+H5Z__unshuffle_loop_neon(unsigned char *dest, const unsigned char *src, size_t numofelements,
+                         unsigned bytesoftype)
+{
+    uint8x16_t v[16];
+    size_t     i;
+    unsigned   j;
+
+    for (i = 0; i + 16 <= numofelements; i += 16) {
+        H5Z_SHUFFLE_UNROLL
+        for (j = 0; j < bytesoftype; j++)
+            v[j] = vld1q_u8(src + j * numofelements + i);
+        H5Z__unshuffle_block_neon(v, bytesoftype);
+        H5Z_SHUFFLE_UNROLL
+        for (j = 0; j < bytesoftype; j++)
+            vst1q_u8(dest + i * bytesoftype + j * 16, v[j]);
+    }
+
+    return i;
+}
+
+static size_t
+H5Z__shuffle_neon(unsigned char *dest, const unsigned char *src, size_t numofelements, unsigned bytesoftype)
+{
+    H5Z_SHUFFLE_DISPATCH(H5Z__shuffle_loop_neon, dest, src, numofelements, bytesoftype)
+}
+
+static size_t
+H5Z__unshuffle_neon(unsigned char *dest, const unsigned char *src, size_t numofelements, unsigned bytesoftype)
+{
+    H5Z_SHUFFLE_DISPATCH(H5Z__unshuffle_loop_neon, dest, src, numofelements, bytesoftype)
+}
+#endif /* H5Z_SHUFFLE_NEON */
+
 /*-------------------------------------------------------------------------
  * Function:	H5Z__set_local_shuffle
  *
@@ -89,70 +536,79 @@ done:
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5Z__set_local_shuffle() */
 
+
 /*-------------------------------------------------------------------------
- * Function:	H5Z__filter_shuffle
+ * Function:	H5Z_shuffle_buf
  *
- * Purpose:	Implement an I/O filter which "de-interlaces" a block of data
- *              by putting all the bytes in a byte-position for each element
- *              together in the block.  For example, for 4-byte elements stored
- *              as: 012301230123, shuffling will store them as: 000111222333
- *              Usually, the bytes in each byte position are more related to
- *              each other and putting them together will increase compression.
+ * Purpose:	Shuffles (or unshuffles, when REVERSE is set) NBYTES bytes
+ *              of elements of BYTESOFTYPE bytes from SRC into DEST, with
+ *              the byte layout of the shuffle filter.  Bytes past the last
+ *              whole element are copied unchanged.  SRC and DEST must not
+ *              overlap.
  *
- * Return:	Success: Size of buffer filtered
- *		Failure: 0
+ *              Blocks of elements of 2, 4, 8 or 16 bytes are done with the
+ *              SIMD kernels when the CPU has them, everything else with
+ *              the scalar loop.
+ *
+ * Return:	void
  *
  *-------------------------------------------------------------------------
  */
-static size_t
-H5Z__filter_shuffle(unsigned flags, size_t cd_nelmts, const unsigned cd_values[], size_t nbytes,
-                    size_t *buf_size, void **buf)
+void
+H5Z_shuffle_buf(void *dest, const void *src, size_t nbytes, unsigned bytesoftype, bool reverse)
 {
-    void          *dest  = NULL;  /* Buffer to deposit [un]shuffled bytes into */
-    unsigned char *_src  = NULL;  /* Alias for source buffer */
-    unsigned char *_dest = NULL;  /* Alias for destination buffer */
-    unsigned       bytesoftype;   /* Number of bytes per element */
-    size_t         numofelements; /* Number of elements in buffer */
-    size_t         i;             /* Local index variables */
+    const unsigned char *_src  = NULL; /* Alias for source buffer */
+    unsigned char       *_dest = NULL; /* Alias for destination buffer */
+    size_t               numofelements; /* Number of elements in buffer */
+    size_t               done = 0;      /* Number of elements done by the SIMD kernels */
+    size_t               count;         /* Number of elements left for each byte */
+    size_t               i;             /* Local index variables */
 #ifdef NO_DUFFS_DEVICE
-    size_t j;             /* Local index variable */
-#endif                    /* NO_DUFFS_DEVICE */
-    size_t leftover;      /* Extra bytes at end of buffer */
-    size_t ret_value = 0; /* Return value */
-
-    FUNC_ENTER_PACKAGE
+    size_t j; /* Local index variable */
+#endif        /* NO_DUFFS_DEVICE */
 
-    /* Check arguments */
-    if (cd_nelmts != H5Z_SHUFFLE_TOTAL_NPARMS || cd_values[H5Z_SHUFFLE_PARM_SIZE] == 0)
-        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, 0, "invalid shuffle parameters");
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
 
-    /* Get the number of bytes per element from the parameter block */
-    bytesoftype = cd_values[H5Z_SHUFFLE_PARM_SIZE];
+    /* Sanity check */
+    assert(dest);
+    assert(src);
+    assert(bytesoftype > 0);
 
     /* Compute the number of elements in buffer */
     numofelements = nbytes / bytesoftype;
 
-    /* Don't do anything for 1-byte elements, or "fractional" elements */
-    if (bytesoftype > 1 && numofelements > 1) {
-        /* Compute the leftover bytes if there are any */
-        leftover = nbytes % bytesoftype;
-
-        /* Allocate the destination buffer */
-        if (NULL == (dest = H5MM_malloc(nbytes)))
-            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "memory allocation failed for shuffle buffer");
-
-        if (flags & H5Z_FLAG_REVERSE) {
-            /* Get the pointer to the source buffer */
-            _src = (unsigned char *)(*buf);
-
+#if defined(H5Z_SHUFFLE_AVX2)
+    if (H5_have_avx2())
+        done = reverse ? H5Z__unshuffle_avx2((unsigned char *)dest, (const unsigned char *)src, numofelements,
+                                             bytesoftype)
+                       : H5Z__shuffle_avx2((unsigned char *)dest, (const unsigned char *)src, numofelements,
+                                           bytesoftype);
+    else
+#endif
+#if defined(H5Z_SHUFFLE_SSE2)
+        done = reverse ? H5Z__unshuffle_sse2((unsigned char *)dest, (const unsigned char *)src, numofelements,
+                                             bytesoftype)
+                       : H5Z__shuffle_sse2((unsigned char *)dest, (const unsigned char *)src, numofelements,
+                                           bytesoftype);
+#elif defined(H5Z_SHUFFLE_NEON)
+    done = reverse ? H5Z__unshuffle_neon((unsigned char *)dest, (const unsigned char *)src, numofelements,
+                                         bytesoftype)
+                   : H5Z__shuffle_neon((unsigned char *)dest, (const unsigned char *)src, numofelements,
+                                       bytesoftype);
+#endif
+    count = numofelements - done;
+
+    if (count > 0) {
+        if (reverse) {
             /* Input; unshuffle */
             for (i = 0; i < bytesoftype; i++) {
-                _dest = ((unsigned char *)dest) + i;
+                _src  = (const unsigned char *)src + i * numofelements + done;
+                _dest = (unsigned char *)dest + done * bytesoftype + i;
 #define DUFF_GUTS                                                                                            \
     *_dest = *_src++;                                                                                        \
     _dest += bytesoftype;
 #ifdef NO_DUFFS_DEVICE
-                j = numofelements;
+                j = count;
                 while (j > 0) {
                     DUFF_GUTS;
 
@@ -162,8 +618,8 @@ H5Z__filter_shuffle(unsigned flags, size_t cd_nelmts, const unsigned cd_values[]
                 {
                     size_t duffs_index; /* Counting index for Duff's device */
 
-                    duffs_index = (numofelements + 7) / 8;
-                    switch (numofelements % 8) {
+                    duffs_index = (count + 7) / 8;
+                    switch (count % 8) {
                         default:
                             assert(0 && "This Should never be executed!");
                             break;
@@ -204,26 +660,17 @@ H5Z__filter_shuffle(unsigned flags, size_t cd_nelmts, const unsigned cd_values[]
 #endif            /* NO_DUFFS_DEVICE */
 #undef DUFF_GUTS
             } /* end for */
-
-            /* Add leftover to the end of data */
-            if (leftover > 0) {
-                /* Adjust back to end of shuffled bytes */
-                _dest -= (bytesoftype - 1);
-                H5MM_memcpy((void *)_dest, (void *)_src, leftover);
-            }
-        } /* end if */
+        }     /* end if */
         else {
-            /* Get the pointer to the destination buffer */
-            _dest = (unsigned char *)dest;
-
             /* Output; shuffle */
             for (i = 0; i < bytesoftype; i++) {
-                _src = ((unsigned char *)(*buf)) + i;
+                _src  = (const unsigned char *)src + done * bytesoftype + i;
+                _dest = (unsigned char *)dest + i * numofelements + done;
 #define DUFF_GUTS                                                                                            \
     *_dest++ = *_src;                                                                                        \
     _src += bytesoftype;
 #ifdef NO_DUFFS_DEVICE
-                j = numofelements;
+                j = count;
                 while (j > 0) {
                     DUFF_GUTS;
 
@@ -233,8 +680,8 @@ H5Z__filter_shuffle(unsigned flags, size_t cd_nelmts, const unsigned cd_values[]
                 {
                     size_t duffs_index; /* Counting index for Duff's device */
 
-                    duffs_index = (numofelements + 7) / 8;
-                    switch (numofelements % 8) {
+                    duffs_index = (count + 7) / 8;
+                    switch (count % 8) {
                         default:
                             assert(0 && "This Should never be executed!");
                             break;
@@ -275,14 +722,62 @@ H5Z__filter_shuffle(unsigned flags, size_t cd_nelmts, const unsigned cd_values[]
 #endif            /* NO_DUFFS_DEVICE */
 #undef DUFF_GUTS
             } /* end for */
+        }     /* end else */
+    }         /* end if */
+
+    /* Add leftover to the end of data */
+    if (nbytes > numofelements * bytesoftype)
+        H5MM_memcpy((unsigned char *)dest + numofelements * bytesoftype,
+                    (const unsigned char *)src + numofelements * bytesoftype,
+                    nbytes - numofelements * bytesoftype);
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5Z_shuffle_buf() */
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__filter_shuffle
+ *
+ * Purpose:	Implement an I/O filter which "de-interlaces" a block of data
+ *              by putting all the bytes in a byte-position for each element
+ *              together in the block.  For example, for 4-byte elements stored
+ *              as: 012301230123, shuffling will store them as: 000111222333
+ *              Usually, the bytes in each byte position are more related to
+ *              each other and putting them together will increase compression.
+ *
+ * Return:	Success: Size of buffer filtered
+ *		Failure: 0
+ *
+ *-------------------------------------------------------------------------
+ */
+static size_t
+H5Z__filter_shuffle(unsigned flags, size_t cd_nelmts, const unsigned cd_values[], size_t nbytes,
+                    size_t *buf_size, void **buf)
+{
+    void    *dest = NULL;   /* Buffer to deposit [un]shuffled bytes into */
+    unsigned bytesoftype;   /* Number of bytes per element */
+    size_t   numofelements; /* Number of elements in buffer */
+    size_t   ret_value = 0; /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    /* Check arguments */
+    if (cd_nelmts != H5Z_SHUFFLE_TOTAL_NPARMS || cd_values[H5Z_SHUFFLE_PARM_SIZE] == 0)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, 0, "invalid shuffle parameters");
+
+    /* Get the number of bytes per element from the parameter block */
+    bytesoftype = cd_values[H5Z_SHUFFLE_PARM_SIZE];
+
+    /* Compute the number of elements in buffer */
+    numofelements = nbytes / bytesoftype;
+
+    /* Don't do anything for 1-byte elements, or "fractional" elements */
+    if (bytesoftype > 1 && numofelements > 1) {
+        /* Allocate the destination buffer */
+        if (NULL == (dest = H5MM_malloc(nbytes)))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "memory allocation failed for shuffle buffer");
 
-            /* Add leftover to the end of data */
-            if (leftover > 0) {
-                /* Adjust back to end of shuffled bytes */
-                _src -= (bytesoftype - 1);
-                H5MM_memcpy((void *)_dest, (void *)_src, leftover);
-            }
-        } /* end else */
+        /* [Un]shuffle the bytes */
+        H5Z_shuffle_buf(dest, *buf, nbytes, bytesoftype, (flags & H5Z_FLAG_REVERSE) != 0);
 
         /* Free the input buffer */
         H5MM_xfree(*buf);
@@ -53,10 +53,35 @@ typedef struct H5Z_node {
     H5Z_num_val      value;
 } H5Z_node;
 
+/* Kinds of instructions of a compiled transform.  The program works on a
+ * stack of blocks of elements, see H5Z__xform_compile.
+ */
+typedef enum {
+    H5Z_XFORM_INS_LOAD, /* Push the elements of "x" */
+    H5Z_XFORM_INS_VS,   /* Replace the top with "top OP value" */
+    H5Z_XFORM_INS_SV,   /* Replace the top with "value OP top" */
+    H5Z_XFORM_INS_VV    /* Pop the top and replace the next one with "next OP top" */
+} H5Z_xform_ins_kind_t;
+
+typedef struct {
+    H5Z_xform_ins_kind_t kind;
+    H5Z_token_type       op;    /* H5Z_XFORM_PLUS, _MINUS, _MULT or _DIVIDE */
+    double               value; /* The constant of H5Z_XFORM_INS_VS and _SV */
+} H5Z_xform_ins_t;
+
+/* A parse tree compiled into postfix instructions */
+typedef struct {
+    H5Z_xform_ins_t *ins;    /* The instructions, NULL when the tree can't be compiled */
+    size_t           nins;   /* Number of instructions */
+    unsigned         depth;  /* Maximum depth of the stack */
+    unsigned         nloads; /* Number of H5Z_XFORM_INS_LOAD instructions */
+} H5Z_xform_prog_t;
+
 struct H5Z_data_xform_t {
     char            *xform_exp;
     H5Z_node        *parse_root;
     H5Z_datval_ptrs *dat_val_pointers;
+    H5Z_xform_prog_t prog; /* Compiled parse tree */
 };
 
 typedef struct result {
@@ -95,6 +120,11 @@ static void      *H5Z__xform_parse(const char *expression, H5Z_datval_ptrs *dat_
 static void      *H5Z__xform_copy_tree(H5Z_node *tree, H5Z_datval_ptrs *dat_val_pointers,
                                        H5Z_datval_ptrs *new_dat_val_pointers);
 static void       H5Z__xform_reduce_tree(H5Z_node *tree);
+static herr_t     H5Z__xform_compile(const H5Z_node *tree, H5Z_xform_prog_t *prog);
+static bool       H5Z__xform_compile_node(const H5Z_node *tree, H5Z_xform_prog_t *prog, unsigned depth);
+static size_t     H5Z__xform_count_nodes(const H5Z_node *tree);
+static htri_t     H5Z__xform_eval_prog(const H5Z_xform_prog_t *prog, void *array, size_t array_size,
+                                       hid_t array_type);
 
 /* PGCC (11.8-0) has trouble with the command *p++ = *p OP tree_val. It increments P first before
  * doing the operation.  So I break down the command into two lines:
@@ -304,6 +334,225 @@ static void       H5Z__xform_reduce_tree(H5Z_node *tree);
         }                                                                                                    \
     }
 
+/* Number of elements of a block of the stack of a compiled transform.  The
+ * blocks stay in the L1 cache while all the instructions run over them.
+ */
+#define H5Z_XFORM_BLOCK 256
+
+/* SSE2 is always present on x86-64 */
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define H5Z_XFORM_SSE2
+#include <emmintrin.h>
+#endif
+
+/* Expands LOOP for the arithmetic operation OPTYPE of an instruction.  LOOP
+ * gets the C operator and the name of the SSE2 intrinsic.
+ */
+#define H5Z_XFORM_SWITCH_OP(OPTYPE, LOOP, TYPE)                                                              \
+    switch (OPTYPE) {                                                                                        \
+        case H5Z_XFORM_PLUS:                                                                                 \
+            LOOP(TYPE, +, add)                                                                               \
+            break;                                                                                           \
+        case H5Z_XFORM_MINUS:                                                                                \
+            LOOP(TYPE, -, sub)                                                                               \
+            break;                                                                                           \
+        case H5Z_XFORM_MULT:                                                                                 \
+            LOOP(TYPE, *, mul)                                                                               \
+            break;                                                                                           \
+        case H5Z_XFORM_DIVIDE:                                                                               \
+        default:                                                                                             \
+            LOOP(TYPE, /, div)                                                                               \
+            break;                                                                                           \
+    }
+
+/* The loops of the instructions over the n elements of the block r, with
+ * the same conversions as H5Z_XFORM_DO_OP1.  The second operand is v for
+ * H5Z_XFORM_INS_VS and _SV, and the block s for H5Z_XFORM_INS_VV.
+ */
+#define H5Z_XFORM_VS_LOOP(TYPE, OP, NAME)                                                                    \
+    for (; u < n; u++)                                                                                       \
+        r[u] = (TYPE)((double)r[u] OP v);
+#define H5Z_XFORM_SV_LOOP(TYPE, OP, NAME)                                                                    \
+    for (; u < n; u++)                                                                                       \
+        r[u] = (TYPE)(v OP(double) r[u]);
+#define H5Z_XFORM_VV_LOOP(TYPE, OP, NAME)                                                                    \
+    for (; u < n; u++)                                                                                       \
+        r[u] = (TYPE)(r[u] OP s[u]);
+
+#ifdef H5Z_XFORM_SSE2
+/* The same loops for float, which is converted to double and back like
+ * the scalar code does
+ */
+#define H5Z_XFORM_VS_LOOP_FLOAT(TYPE, OP, NAME)                                                              \
+    {                                                                                                        \
+        const __m128d c = _mm_set1_pd(v);                                                                    \
+                                                                                                             \
+        for (; u + 4 <= n; u += 4) {                                                                         \
+            __m128  x  = _mm_loadu_ps(r + u);                                                                \
+            __m128d lo = _mm_##NAME##_pd(_mm_cvtps_pd(x), c);                                                \
+            __m128d hi = _mm_##NAME##_pd(_mm_cvtps_pd(_mm_movehl_ps(x, x)), c);                              \
+                                                                                                             \
+            _mm_storeu_ps(r + u, _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi)));                         \
+        }                                                                                                    \
+        H5Z_XFORM_VS_LOOP(TYPE, OP, NAME)                                                                    \
+    }
+#define H5Z_XFORM_SV_LOOP_FLOAT(TYPE, OP, NAME)                                                              \
+    {                                                                                                        \
+        const __m128d c = _mm_set1_pd(v);                                                                    \
+                                                                                                             \
+        for (; u + 4 <= n; u += 4) {                                                                         \
+            __m128  x  = _mm_loadu_ps(r + u);                                                                \
+            __m128d lo = _mm_##NAME##_pd(c, _mm_cvtps_pd(x));                                                \
+            __m128d hi = _mm_##NAME##_pd(c, _mm_cvtps_pd(_mm_movehl_ps(x, x)));                              \
+                                                                                                             \
+            _mm_storeu_ps(r + u, _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi)));                         \
+        }                                                                                                    \
+        H5Z_XFORM_SV_LOOP(TYPE, OP, NAME)                                                                    \
+    }
+#define H5Z_XFORM_VV_LOOP_FLOAT(TYPE, OP, NAME)                                                              \
+    for (; u + 4 <= n; u += 4)                                                                               \
+        _mm_storeu_ps(r + u, _mm_##NAME##_ps(_mm_loadu_ps(r + u), _mm_loadu_ps(s + u)));                     \
+    H5Z_XFORM_VV_LOOP(TYPE, OP, NAME)
+
+/* The same loops for int with a constant.  The conversions of the values
+ * out of range give the same result as the scalar ones.
+ */
+#define H5Z_XFORM_VS_LOOP_INT(TYPE, OP, NAME)                                                                \
+    {                                                                                                        \
+        const __m128d c = _mm_set1_pd(v);                                                                    \
+                                                                                                             \
+        for (; u + 4 <= n; u += 4) {                                                                         \
+            __m128i x  = _mm_loadu_si128((const __m128i *)(r + u));                                          \
+            __m128d lo = _mm_##NAME##_pd(_mm_cvtepi32_pd(x), c);                                             \
+            __m128d hi = _mm_##NAME##_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(x, 0x0e)), c);                    \
+            __m128i y  = _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi));                     \
+                                                                                                             \
+            _mm_storeu_si128((__m128i *)(r + u), y);                                                         \
+        }                                                                                                    \
+        H5Z_XFORM_VS_LOOP(TYPE, OP, NAME)                                                                    \
+    }
+#define H5Z_XFORM_SV_LOOP_INT(TYPE, OP, NAME)                                                                \
+    {                                                                                                        \
+        const __m128d c = _mm_set1_pd(v);                                                                    \
+                                                                                                             \
+        for (; u + 4 <= n; u += 4) {                                                                         \
+            __m128i x  = _mm_loadu_si128((const __m128i *)(r + u));                                          \
+            __m128d lo = _mm_##NAME##_pd(c, _mm_cvtepi32_pd(x));                                             \
+            __m128d hi = _mm_##NAME##_pd(c, _mm_cvtepi32_pd(_mm_shuffle_epi32(x, 0x0e)));                    \
+            __m128i y  = _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi));                     \
+                                                                                                             \
+            _mm_storeu_si128((__m128i *)(r + u), y);                                                         \
+        }                                                                                                    \
+        H5Z_XFORM_SV_LOOP(TYPE, OP, NAME)                                                                    \
+    }
+
+/* The same loops for double */
+#define H5Z_XFORM_VS_LOOP_DOUBLE(TYPE, OP, NAME)                                                             \
+    {                                                                                                        \
+        const __m128d c = _mm_set1_pd(v);                                                                    \
+                                                                                                             \
+        for (; u + 2 <= n; u += 2)                                                                           \
+            _mm_storeu_pd(r + u, _mm_##NAME##_pd(_mm_loadu_pd(r + u), c));                                   \
+        H5Z_XFORM_VS_LOOP(TYPE, OP, NAME)                                                                    \
+    }
+#define H5Z_XFORM_SV_LOOP_DOUBLE(TYPE, OP, NAME)                                                             \
+    {                                                                                                        \
+        const __m128d c = _mm_set1_pd(v);                                                                    \
+                                                                                                             \
+        for (; u + 2 <= n; u += 2)                                                                           \
+            _mm_storeu_pd(r + u, _mm_##NAME##_pd(c, _mm_loadu_pd(r + u)));                                   \
+        H5Z_XFORM_SV_LOOP(TYPE, OP, NAME)                                                                    \
+    }
+#define H5Z_XFORM_VV_LOOP_DOUBLE(TYPE, OP, NAME)                                                             \
+    for (; u + 2 <= n; u += 2)                                                                               \
+        _mm_storeu_pd(r + u, _mm_##NAME##_pd(_mm_loadu_pd(r + u), _mm_loadu_pd(s + u)));                     \
+    H5Z_XFORM_VV_LOOP(TYPE, OP, NAME)
+#else /* H5Z_XFORM_SSE2 */
+#define H5Z_XFORM_VS_LOOP_FLOAT  H5Z_XFORM_VS_LOOP
+#define H5Z_XFORM_SV_LOOP_FLOAT  H5Z_XFORM_SV_LOOP
+#define H5Z_XFORM_VV_LOOP_FLOAT  H5Z_XFORM_VV_LOOP
+#define H5Z_XFORM_VS_LOOP_DOUBLE H5Z_XFORM_VS_LOOP
+#define H5Z_XFORM_SV_LOOP_DOUBLE H5Z_XFORM_SV_LOOP
+#define H5Z_XFORM_VV_LOOP_DOUBLE H5Z_XFORM_VV_LOOP
+#define H5Z_XFORM_VS_LOOP_INT    H5Z_XFORM_VS_LOOP
+#define H5Z_XFORM_SV_LOOP_INT    H5Z_XFORM_SV_LOOP
+#endif /* H5Z_XFORM_SSE2 */
+
+/* Defines the function that runs a compiled transform over an array of
+ * TYPE, one block at a time.  The bottom of the stack is the block of the
+ * array itself, so a transform of a single "x" needs no temporary storage.
+ * When "x" is used more than once, the original block is kept aside for
+ * the later loads.
+ */
+#define H5Z_XFORM_DEF_RUN(NAME, TYPE, VS_LOOP, SV_LOOP, VV_LOOP)                                             \
+    static herr_t H5Z__xform_run_##NAME(const H5Z_xform_prog_t *prog, void *_array, size_t array_size)       \
+    {                                                                                                        \
+        TYPE  *array = (TYPE *)_array;                                                                       \
+        TYPE  *regs  = NULL;                                                                                 \
+        size_t nregs = (prog->depth - 1) + (prog->nloads > 1 ? 1 : 0);                                       \
+        size_t off;                                                                                          \
+        herr_t ret_value = SUCCEED;                                                                          \
+                                                                                                             \
+        FUNC_ENTER_PACKAGE                                                                                   \
+                                                                                                             \
+        if (nregs > 0 && NULL == (regs = (TYPE *)H5MM_malloc(nregs * H5Z_XFORM_BLOCK * sizeof(TYPE))))       \
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL,                                                     \
+                        "Ran out of memory trying to allocate space for data in data transform");            \
+                                                                                                             \
+        for (off = 0; off < array_size; off += H5Z_XFORM_BLOCK) {                                            \
+            size_t      n   = MIN(H5Z_XFORM_BLOCK, array_size - off);                                        \
+            TYPE       *blk = array + off;                                                                   \
+            const TYPE *x   = blk;                                                                           \
+            size_t      top = 0;                                                                             \
+            size_t      i;                                                                                   \
+                                                                                                             \
+            if (prog->nloads > 1) {                                                                          \
+                x = regs + (nregs - 1) * H5Z_XFORM_BLOCK;                                                    \
+                H5MM_memcpy(regs + (nregs - 1) * H5Z_XFORM_BLOCK, blk, n * sizeof(TYPE));                    \
+            }                                                                                                \
+                                                                                                             \
+            for (i = 0; i < prog->nins; i++) {                                                               \
+                const H5Z_xform_ins_t *ins = prog->ins + i;                                                  \
+                double                 v   = ins->value;                                                     \
+                TYPE                  *r, *s;                                                                \
+                size_t                 u = 0;                                                                \
+                                                                                                             \
+                switch (ins->kind) {                                                                         \
+                    case H5Z_XFORM_INS_LOAD:                                                                 \
+                        /* The first load is always at the bottom, which holds "x" */                        \
+                        r = top ? regs + (top - 1) * H5Z_XFORM_BLOCK : blk;                                  \
+                        if (top > 0)                                                                         \
+                            H5MM_memcpy(r, x, n * sizeof(TYPE));                                             \
+                        top++;                                                                               \
+                        break;                                                                               \
+                                                                                                             \
+                    case H5Z_XFORM_INS_VS:                                                                   \
+                        r = top > 1 ? regs + (top - 2) * H5Z_XFORM_BLOCK : blk;                              \
+                        H5Z_XFORM_SWITCH_OP(ins->op, VS_LOOP, TYPE)                                          \
+                        break;                                                                               \
+                                                                                                             \
+                    case H5Z_XFORM_INS_SV:                                                                   \
+                        r = top > 1 ? regs + (top - 2) * H5Z_XFORM_BLOCK : blk;                              \
+                        H5Z_XFORM_SWITCH_OP(ins->op, SV_LOOP, TYPE)                                          \
+                        break;                                                                               \
+                                                                                                             \
+                    case H5Z_XFORM_INS_VV:                                                                   \
+                    default:                                                                                 \
+                        top--;                                                                               \
+                        r = top > 1 ? regs + (top - 2) * H5Z_XFORM_BLOCK : blk;                              \
+                        s = regs + (top - 1) * H5Z_XFORM_BLOCK;                                              \
+                        H5Z_XFORM_SWITCH_OP(ins->op, VV_LOOP, TYPE)                                          \
+                        break;                                                                               \
+                }                                                                                            \
+            }                                                                                                \
+        }                                                                                                    \
+                                                                                                             \
+done:                                                                                                        \
+        H5MM_xfree(regs);                                                                                    \
+                                                                                                             \
+        FUNC_LEAVE_NOAPI(ret_value)                                                                          \
+    }
+
 /*
  * This is the context-free grammar for our expressions:
  *
@@ -916,6 +1165,7 @@ H5Z_xform_eval(H5Z_data_xform_t *data_xform_prop, void *array, size_t array_size
     H5Z_node  *tree;
     hid_t      array_type;
     H5Z_result res;
+    htri_t     compiled = false;
     size_t     i;
     herr_t     ret_value = SUCCEED; /* Return value */
 
@@ -968,6 +1218,12 @@ H5Z_xform_eval(H5Z_data_xform_t *data_xform_prop, void *array, size_t array_size
             H5Z_XFORM_DO_OP5(long double, array_size)
 
     } /* end if */
+    /* Otherwise, run the compiled transform if there is one */
+    else if (data_xform_prop->prog.ins &&
+             (compiled = H5Z__xform_eval_prog(&data_xform_prop->prog, array, array_size, array_type))) {
+        if (compiled < 0)
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "error while performing data transform");
+    } /* end if */
     /* Otherwise, do the full data transform */
     else {
         /* Optimization for linear transform: */
@@ -1381,6 +1637,232 @@ H5Z__do_op(H5Z_node *tree)
     FUNC_LEAVE_NOAPI_VOID
 }
 
+/*-------------------------------------------------------------------------
+ * Function:    H5Z__xform_count_nodes
+ *
+ * Purpose:     Counts the nodes of the parse tree passed in.
+ *
+ * Return:      The number of nodes
+ *
+ *-------------------------------------------------------------------------
+ */
+static size_t
+H5Z__xform_count_nodes(const H5Z_node *tree)
+{
+    size_t ret_value = 0;
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    if (tree)
+        ret_value = 1 + H5Z__xform_count_nodes(tree->lchild) + H5Z__xform_count_nodes(tree->rchild);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Z__xform_compile_node
+ *
+ * Purpose:     Appends the instructions of the subtree passed in to prog,
+ *              for a stack that holds depth blocks before them.
+ *
+ * Return:      true if the subtree could be compiled, false otherwise
+ *
+ *-------------------------------------------------------------------------
+ */
+static bool
+H5Z__xform_compile_node(const H5Z_node *tree, H5Z_xform_prog_t *prog, unsigned depth)
+{
+    H5Z_xform_ins_t *ins;
+    bool             lnumb, rnumb;
+    bool             ret_value = true;
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    assert(tree);
+
+    if (depth + 1 > prog->depth)
+        prog->depth = depth + 1;
+
+    if (tree->type == H5Z_XFORM_SYMBOL) {
+        ins       = prog->ins + prog->nins++;
+        ins->kind = H5Z_XFORM_INS_LOAD;
+        ins->op   = H5Z_XFORM_SYMBOL;
+        prog->nloads++;
+    }
+    else if ((tree->type == H5Z_XFORM_PLUS || tree->type == H5Z_XFORM_MINUS ||
+              tree->type == H5Z_XFORM_MULT || tree->type == H5Z_XFORM_DIVIDE) &&
+             tree->rchild) {
+        /* A missing left operand, like in -x, is 0 as in H5Z_XFORM_DO_OP1 */
+        lnumb = !tree->lchild || tree->lchild->type == H5Z_XFORM_INTEGER ||
+                tree->lchild->type == H5Z_XFORM_FLOAT;
+        rnumb = tree->rchild->type == H5Z_XFORM_INTEGER || tree->rchild->type == H5Z_XFORM_FLOAT;
+
+        /* Operations on two numbers are left to H5Z__xform_eval_full, which fails on them */
+        if (lnumb && rnumb)
+            ret_value = false;
+        else if (lnumb) {
+            if ((ret_value = H5Z__xform_compile_node(tree->rchild, prog, depth))) {
+                ins        = prog->ins + prog->nins++;
+                ins->kind  = H5Z_XFORM_INS_SV;
+                ins->op    = tree->type;
+                ins->value = !tree->lchild                             ? 0
+                             : tree->lchild->type == H5Z_XFORM_INTEGER ? (double)tree->lchild->value.int_val
+                                                                       : tree->lchild->value.float_val;
+            }
+        }
+        else if (rnumb) {
+            if ((ret_value = H5Z__xform_compile_node(tree->lchild, prog, depth))) {
+                ins        = prog->ins + prog->nins++;
+                ins->kind  = H5Z_XFORM_INS_VS;
+                ins->op    = tree->type;
+                ins->value = tree->rchild->type == H5Z_XFORM_INTEGER ? (double)tree->rchild->value.int_val
+                                                                     : tree->rchild->value.float_val;
+            }
+        }
+        else if ((ret_value = H5Z__xform_compile_node(tree->lchild, prog, depth) &&
+                              H5Z__xform_compile_node(tree->rchild, prog, depth + 1))) {
+            ins       = prog->ins + prog->nins++;
+            ins->kind = H5Z_XFORM_INS_VV;
+            ins->op   = tree->type;
+        }
+    }
+    else
+        ret_value = false;
+
+    FUNC_LEAVE_NOAPI(ret_value)
+}
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Z__xform_compile
+ *
+ * Purpose:     Compiles the parse tree passed in into postfix instructions
+ *              over a stack of blocks of elements.  Each block runs through
+ *              all the instructions while it is in the cache, instead of
+ *              every node of the tree walking over the whole array like
+ *              H5Z__xform_eval_full does.
+ *
+ *              Trees that can't be compiled leave prog->ins NULL and are
+ *              still evaluated by H5Z__xform_eval_full.
+ *
+ * Return:      Success:    SUCCEED
+ *              Failure:    FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5Z__xform_compile(const H5Z_node *tree, H5Z_xform_prog_t *prog)
+{
+    herr_t ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    assert(tree);
+    assert(prog);
+
+    memset(prog, 0, sizeof(H5Z_xform_prog_t));
+
+    /* Numbers are filled in and a lone "x" is a no-op, see H5Z_xform_eval */
+    if (tree->type == H5Z_XFORM_INTEGER || tree->type == H5Z_XFORM_FLOAT || tree->type == H5Z_XFORM_SYMBOL)
+        HGOTO_DONE(SUCCEED);
+
+    if (NULL == (prog->ins = (H5Z_xform_ins_t *)H5MM_calloc(H5Z__xform_count_nodes(tree) *
+                                                             sizeof(H5Z_xform_ins_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to allocate memory for data transform program");
+
+    if (!H5Z__xform_compile_node(tree, prog, 0)) {
+        prog->ins = (H5Z_xform_ins_t *)H5MM_xfree(prog->ins);
+        memset(prog, 0, sizeof(H5Z_xform_prog_t));
+    }
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5Z__xform_compile() */
+
+/* The functions that run a compiled transform, one for each type of
+ * H5Z_XFORM_DO_OP5
+ */
+H5Z_XFORM_DEF_RUN(char, char, H5Z_XFORM_VS_LOOP, H5Z_XFORM_SV_LOOP, H5Z_XFORM_VV_LOOP)
+#if CHAR_MIN >= 0
+H5Z_XFORM_DEF_RUN(schar, signed char, H5Z_XFORM_VS_LOOP, H5Z_XFORM_SV_LOOP, H5Z_XFORM_VV_LOOP)
+#else  /* CHAR_MIN >= 0 */
+H5Z_XFORM_DEF_RUN(uchar, unsigned char, H5Z_XFORM_VS_LOOP, H5Z_XFORM_SV_LOOP, H5Z_XFORM_VV_LOOP)
+#endif /* CHAR_MIN >= 0 */
+H5Z_XFORM_DEF_RUN(short, short, H5Z_XFORM_VS_LOOP, H5Z_XFORM_SV_LOOP, H5Z_XFORM_VV_LOOP)
+H5Z_XFORM_DEF_RUN(ushort, unsigned short, H5Z_XFORM_VS_LOOP, H5Z_XFORM_SV_LOOP, H5Z_XFORM_VV_LOOP)
+H5Z_XFORM_DEF_RUN(int, int, H5Z_XFORM_VS_LOOP_INT, H5Z_XFORM_SV_LOOP_INT, H5Z_XFORM_VV_LOOP)
+H5Z_XFORM_DEF_RUN(uint, unsigned int, H5Z_XFORM_VS_LOOP, H5Z_XFORM_SV_LOOP, H5Z_XFORM_VV_LOOP)
+H5Z_XFORM_DEF_RUN(long, long, H5Z_XFORM_VS_LOOP, H5Z_XFORM_SV_LOOP, H5Z_XFORM_VV_LOOP)
+H5Z_XFORM_DEF_RUN(ulong, unsigned long, H5Z_XFORM_VS_LOOP, H5Z_XFORM_SV_LOOP, H5Z_XFORM_VV_LOOP)
+H5Z_XFORM_DEF_RUN(llong, long long, H5Z_XFORM_VS_LOOP, H5Z_XFORM_SV_LOOP, H5Z_XFORM_VV_LOOP)
+H5Z_XFORM_DEF_RUN(ullong, unsigned long long, H5Z_XFORM_VS_LOOP, H5Z_XFORM_SV_LOOP, H5Z_XFORM_VV_LOOP)
+H5Z_XFORM_DEF_RUN(float, float, H5Z_XFORM_VS_LOOP_FLOAT, H5Z_XFORM_SV_LOOP_FLOAT, H5Z_XFORM_VV_LOOP_FLOAT)
+H5Z_XFORM_DEF_RUN(double, double, H5Z_XFORM_VS_LOOP_DOUBLE, H5Z_XFORM_SV_LOOP_DOUBLE,
+                  H5Z_XFORM_VV_LOOP_DOUBLE)
+H5Z_XFORM_DEF_RUN(ldouble, long double, H5Z_XFORM_VS_LOOP, H5Z_XFORM_SV_LOOP, H5Z_XFORM_VV_LOOP)
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Z__xform_eval_prog
+ *
+ * Purpose:     Applies a compiled transform to array.
+ *
+ * Return:      Success:    true if the transform was applied, false if
+ *                          the type of the array is left to
+ *                          H5Z__xform_eval_full
+ *              Failure:    FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static htri_t
+H5Z__xform_eval_prog(const H5Z_xform_prog_t *prog, void *array, size_t array_size, hid_t array_type)
+{
+    herr_t status    = SUCCEED;
+    htri_t ret_value = true; /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    assert(prog && prog->ins);
+
+    if (array_type == H5T_NATIVE_CHAR)
+        status = H5Z__xform_run_char(prog, array, array_size);
+#if CHAR_MIN >= 0
+    else if (array_type == H5T_NATIVE_SCHAR)
+        status = H5Z__xform_run_schar(prog, array, array_size);
+#else  /* CHAR_MIN >= 0 */
+    else if (array_type == H5T_NATIVE_UCHAR)
+        status = H5Z__xform_run_uchar(prog, array, array_size);
+#endif /* CHAR_MIN >= 0 */
+    else if (array_type == H5T_NATIVE_SHORT)
+        status = H5Z__xform_run_short(prog, array, array_size);
+    else if (array_type == H5T_NATIVE_USHORT)
+        status = H5Z__xform_run_ushort(prog, array, array_size);
+    else if (array_type == H5T_NATIVE_INT)
+        status = H5Z__xform_run_int(prog, array, array_size);
+    else if (array_type == H5T_NATIVE_UINT)
+        status = H5Z__xform_run_uint(prog, array, array_size);
+    else if (array_type == H5T_NATIVE_LONG)
+        status = H5Z__xform_run_long(prog, array, array_size);
+    else if (array_type == H5T_NATIVE_ULONG)
+        status = H5Z__xform_run_ulong(prog, array, array_size);
+    else if (array_type == H5T_NATIVE_LLONG)
+        status = H5Z__xform_run_llong(prog, array, array_size);
+    else if (array_type == H5T_NATIVE_ULLONG)
+        status = H5Z__xform_run_ullong(prog, array, array_size);
+    else if (array_type == H5T_NATIVE_FLOAT)
+        status = H5Z__xform_run_float(prog, array, array_size);
+    else if (array_type == H5T_NATIVE_DOUBLE)
+        status = H5Z__xform_run_double(prog, array, array_size);
+    else if (array_type == H5T_NATIVE_LDOUBLE)
+        status = H5Z__xform_run_ldouble(prog, array, array_size);
+    else
+        ret_value = false;
+
+    if (status < 0)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "error while performing data transform");
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5Z__xform_eval_prog() */
+
 /*-------------------------------------------------------------------------
  * Function: H5Z_xform_create
  *
@@ -1457,6 +1939,10 @@ H5Z_xform_create(const char *expr)
         HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, NULL,
                     "error copying the parse tree, did not find correct number of \"variables\"");
 
+    /* Compile the parse tree */
+    if (H5Z__xform_compile(data_xform_prop->parse_root, &data_xform_prop->prog) < 0)
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "unable to compile data transform expression");
+
     /* Assign return value */
     ret_value = data_xform_prop;
 
@@ -1466,6 +1952,8 @@ done:
         if (data_xform_prop) {
             if (data_xform_prop->parse_root)
                 H5Z__xform_destroy_parse_tree(data_xform_prop->parse_root);
+            if (data_xform_prop->prog.ins)
+                H5MM_xfree(data_xform_prop->prog.ins);
             if (data_xform_prop->xform_exp)
                 H5MM_xfree(data_xform_prop->xform_exp);
             if (count > 0 && data_xform_prop->dat_val_pointers->ptr_dat_val)
@@ -1499,6 +1987,9 @@ H5Z_xform_destroy(H5Z_data_xform_t *data_xform_prop)
         /* Destroy the parse tree */
         H5Z__xform_destroy_parse_tree(data_xform_prop->parse_root);
 
+        /* Free the compiled parse tree */
+        H5MM_xfree(data_xform_prop->prog.ins);
+
         /* Free the expression */
         H5MM_xfree(data_xform_prop->xform_exp);
 
@@ -1584,6 +2075,10 @@ H5Z_xform_copy(H5Z_data_xform_t **data_xform_prop)
             HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL,
                         "error copying the parse tree, did not find correct number of \"variables\"");
 
+        /* Compile the new parse tree */
+        if (H5Z__xform_compile(new_data_xform_prop->parse_root, &new_data_xform_prop->prog) < 0)
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to compile data transform expression");
+
         /* Copy new information on top of old information */
         *data_xform_prop = new_data_xform_prop;
     } /* end if */
@@ -1594,6 +2089,8 @@ done:
         if (new_data_xform_prop) {
             if (new_data_xform_prop->parse_root)
                 H5Z__xform_destroy_parse_tree(new_data_xform_prop->parse_root);
+            if (new_data_xform_prop->prog.ins)
+                H5MM_xfree(new_data_xform_prop->prog.ins);
             if (new_data_xform_prop->xform_exp)
                 H5MM_xfree(new_data_xform_prop->xform_exp);
             H5MM_xfree(new_data_xform_prop);
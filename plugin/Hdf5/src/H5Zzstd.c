@@ -0,0 +1,120 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://www.hdfgroup.org/licenses.               *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "H5Zmodule.h" /* This source code file is part of the H5Z module */
+
+#include "H5private.h"   /* Generic Functions			*/
+#include "H5Eprivate.h"  /* Error handling		  	*/
+#include "H5MMprivate.h" /* Memory management			*/
+#include "H5Zpkg.h"      /* Data filters				*/
+
+#ifdef H5_HAVE_FILTER_ZSTD
+
+#include H5_ZSTD_HEADER /* "zstd.h" */
+
+/* Local function prototypes */
+static size_t H5Z__filter_zstd(unsigned flags, size_t cd_nelmts, const unsigned cd_values[], size_t nbytes,
+                               size_t *buf_size, void **buf);
+
+/* This message derives from H5Z */
+const H5Z_class2_t H5Z_ZSTD[1] = {{
+    H5Z_CLASS_T_VERS, /* H5Z_class_t version */
+    H5Z_FILTER_ZSTD,  /* Filter id number		*/
+    1,                /* encoder_present flag (set to true) */
+    1,                /* decoder_present flag (set to true) */
+    "zstd",           /* Filter name for debugging	*/
+    NULL,             /* The "can apply" callback     */
+    NULL,             /* The "set local" callback     */
+    H5Z__filter_zstd, /* The actual filter function	*/
+}};
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__filter_zstd
+ *
+ * Purpose:	Implement an I/O filter around Zstandard.
+ *
+ *              Each chunk is stored as one Zstandard frame with its
+ *              uncompressed size, as the registered Zstandard filter
+ *              (32015) does.  The optional cd_values[0] is the compression
+ *              level, as a signed int; 0 selects the library default.
+ *
+ * Return:	Success: Size of buffer filtered
+ *		Failure: 0
+ *
+ *-------------------------------------------------------------------------
+ */
+static size_t
+H5Z__filter_zstd(unsigned flags, size_t cd_nelmts, const unsigned cd_values[], size_t nbytes,
+                 size_t *buf_size, void **buf)
+{
+    void  *outbuf = NULL; /* Pointer to new buffer */
+    size_t outsize;       /* Size of the output buffer */
+    size_t status;        /* Status from Zstandard operation */
+    size_t ret_value = 0; /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    /* Sanity check */
+    assert(*buf_size > 0);
+    assert(buf);
+    assert(*buf);
+
+    if (flags & H5Z_FLAG_REVERSE) {
+        /* Input; uncompress */
+        unsigned long long origsize = ZSTD_getFrameContentSize(*buf, nbytes);
+
+        if (origsize == ZSTD_CONTENTSIZE_ERROR || origsize == ZSTD_CONTENTSIZE_UNKNOWN ||
+            origsize > (unsigned long long)SIZE_MAX)
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "invalid zstd frame header");
+        outsize = MAX((size_t)origsize, 1);
+
+        if (NULL == (outbuf = H5MM_malloc(outsize)))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "memory allocation failed for zstd uncompression");
+
+        status = ZSTD_decompress(outbuf, (size_t)origsize, *buf, nbytes);
+        if (ZSTD_isError(status) || status != (size_t)origsize)
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "zstd uncompression failed");
+    } /* end if */
+    else {
+        /* Output; compress */
+        int level = ZSTD_CLEVEL_DEFAULT; /* Compression level */
+
+        if (cd_nelmts > 0 && cd_values[0] != 0) {
+            level = (int)cd_values[0];
+            level = MAX(level, ZSTD_minCLevel());
+            level = MIN(level, ZSTD_maxCLevel());
+        }
+
+        outsize = ZSTD_compressBound(nbytes);
+        if (NULL == (outbuf = H5MM_malloc(outsize)))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "unable to allocate zstd destination buffer");
+
+        status = ZSTD_compress(outbuf, outsize, *buf, nbytes, level);
+        if (ZSTD_isError(status))
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "zstd compression failed");
+    } /* end else */
+
+    /* Free the input buffer */
+    H5MM_xfree(*buf);
+
+    /* Set return values */
+    *buf      = outbuf;
+    outbuf    = NULL;
+    *buf_size = outsize;
+    ret_value = status;
+
+done:
+    if (outbuf)
+        H5MM_xfree(outbuf);
+    FUNC_LEAVE_NOAPI(ret_value)
+}
+#endif /* H5_HAVE_FILTER_ZSTD */
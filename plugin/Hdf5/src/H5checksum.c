@@ -37,6 +37,38 @@
 /* (same as the IEEE 802.3 (Ethernet) quotient) */
 #define H5_CRC_QUOTIENT 0x04C11DB7
 
+/* SIMD fletcher32.  SSE2 is always present on x86-64, AVX2 is checked at run
+ * time.  The words of whole vectors are summed in 32-bit lanes, in blocks of
+ * up to H5_FLETCHER32_BLOCK vectors so that the lanes can't overflow.
+ */
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define H5_CHECKSUM_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+#define H5_CHECKSUM_AVX2
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define H5_CHECKSUM_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define H5_CHECKSUM_AVX2_TARGET
+#endif
+#endif
+#endif
+#define H5_FLETCHER32_BLOCK 128
+
+/* Reduces a fletcher32 sum modulo 65535 like the end-around carry of the
+ * scalar loop does: the result is 0 only when the sum is 0.
+ */
+#define H5_FLETCHER32_MOD(x) ((x) ? (uint32_t)(((x) - 1) % 65535 + 1) : 0)
+
+/* lookup3 reads its input as little-endian 32-bit words, which can be loaded
+ * as they are on little-endian machines.
+ */
+#if defined(H5_CHECKSUM_SSE2) || defined(_M_ARM64) ||                                                       \
+    (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define H5_LOOKUP3_LE_WORDS
+#endif
+
 /******************/
 /* Local Typedefs */
 /******************/
@@ -67,6 +99,145 @@ static uint32_t H5_crc_table[256];
 /* Flag: has the table been computed? */
 static bool H5_crc_table_computed = false;
 
+#ifdef H5_CHECKSUM_SSE2
+/*-------------------------------------------------------------------------
+ * Function:	H5__checksum_fletcher32_add
+ *
+ * Purpose:	Adds to the fletcher32 sums a block of NWORDS words, given
+ *              the sum of the words, SUM, and the sum of each word times
+ *              the number of words from it to the end of the block, WSUM.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+static inline void
+H5__checksum_fletcher32_add(uint32_t *sum1, uint32_t *sum2, size_t nwords, uint64_t sum, uint64_t wsum)
+{
+    uint64_t s2 = *sum2 + (uint64_t)nwords * *sum1 + wsum;
+    uint64_t s1 = *sum1 + sum;
+
+    *sum1 = H5_FLETCHER32_MOD(s1);
+    *sum2 = H5_FLETCHER32_MOD(s2);
+} /* end H5__checksum_fletcher32_add() */
+
+/*-------------------------------------------------------------------------
+ * Function:	H5__checksum_fletcher32_sse2
+ *
+ * Purpose:	Adds the big-endian words of the whole 16-byte vectors in
+ *              DATA to the fletcher32 sums.  Each word is split in its two
+ *              bytes, so that they can be multiplied as signed 16-bit
+ *              values.  The running sums of the vectors give, once added
+ *              up, the weight of each vector in the second sum.
+ *
+ * Return:	Number of words summed
+ *
+ *-------------------------------------------------------------------------
+ */
+static size_t
+H5__checksum_fletcher32_sse2(const uint8_t *data, size_t nwords, uint32_t *sum1, uint32_t *sum2)
+{
+    const __m128i lomask = _mm_set1_epi16(0x00ff);
+    const __m128i ones   = _mm_set1_epi16(1);
+    const __m128i hiones = _mm_set1_epi16(256);
+    const __m128i weight = _mm_set_epi16(1, 2, 3, 4, 5, 6, 7, 8);
+    const __m128i hiweight = _mm_slli_epi16(weight, 8);
+    size_t        nvec     = nwords / 8;
+    size_t        done     = 0;
+
+    while (done < nvec) {
+        size_t   n      = MIN(nvec - done, H5_FLETCHER32_BLOCK);
+        __m128i  vsum   = _mm_setzero_si128();
+        __m128i  vprev  = _mm_setzero_si128();
+        __m128i  vwsum  = _mm_setzero_si128();
+        uint32_t lanes[3][4];
+        uint64_t sum = 0, prev = 0, wsum = 0;
+        size_t   i;
+
+        for (i = 0; i < n; i++) {
+            __m128i x  = _mm_loadu_si128((const __m128i *)(data + 16 * i));
+            __m128i hi = _mm_and_si128(x, lomask); /* First byte of each word */
+            __m128i lo = _mm_srli_epi16(x, 8);
+
+            vprev = _mm_add_epi32(vprev, vsum);
+            vsum  = _mm_add_epi32(vsum, _mm_add_epi32(_mm_madd_epi16(hi, hiones), _mm_madd_epi16(lo, ones)));
+            vwsum = _mm_add_epi32(vwsum, _mm_add_epi32(_mm_madd_epi16(hi, hiweight), _mm_madd_epi16(lo, weight)));
+        }
+        _mm_storeu_si128((__m128i *)lanes[0], vsum);
+        _mm_storeu_si128((__m128i *)lanes[1], vprev);
+        _mm_storeu_si128((__m128i *)lanes[2], vwsum);
+        for (i = 0; i < 4; i++) {
+            sum += lanes[0][i];
+            prev += lanes[1][i];
+            wsum += lanes[2][i];
+        }
+        H5__checksum_fletcher32_add(sum1, sum2, 8 * n, sum, 8 * prev + wsum);
+
+        data += 16 * n;
+        done += n;
+    }
+
+    return 8 * nvec;
+} /* end H5__checksum_fletcher32_sse2() */
+#endif /* H5_CHECKSUM_SSE2 */
+
+#ifdef H5_CHECKSUM_AVX2
+/*-------------------------------------------------------------------------
+ * Function:	H5__checksum_fletcher32_avx2
+ *
+ * Purpose:	Same as H5__checksum_fletcher32_sse2(), with 32-byte vectors.
+ *
+ * Return:	Number of words summed
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5_CHECKSUM_AVX2_TARGET size_t
+H5__checksum_fletcher32_avx2(const uint8_t *data, size_t nwords, uint32_t *sum1, uint32_t *sum2)
+{
+    const __m256i lomask   = _mm256_set1_epi16(0x00ff);
+    const __m256i ones     = _mm256_set1_epi16(1);
+    const __m256i hiones   = _mm256_set1_epi16(256);
+    const __m256i weight   = _mm256_set_epi16(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16);
+    const __m256i hiweight = _mm256_slli_epi16(weight, 8);
+    size_t        nvec     = nwords / 16;
+    size_t        done     = 0;
+
+    while (done < nvec) {
+        size_t   n      = MIN(nvec - done, H5_FLETCHER32_BLOCK);
+        __m256i  vsum   = _mm256_setzero_si256();
+        __m256i  vprev  = _mm256_setzero_si256();
+        __m256i  vwsum  = _mm256_setzero_si256();
+        uint32_t lanes[3][8];
+        uint64_t sum = 0, prev = 0, wsum = 0;
+        size_t   i;
+
+        for (i = 0; i < n; i++) {
+            __m256i x  = _mm256_loadu_si256((const __m256i *)(data + 32 * i));
+            __m256i hi = _mm256_and_si256(x, lomask); /* First byte of each word */
+            __m256i lo = _mm256_srli_epi16(x, 8);
+
+            vprev = _mm256_add_epi32(vprev, vsum);
+            vsum  = _mm256_add_epi32(vsum, _mm256_add_epi32(_mm256_madd_epi16(hi, hiones), _mm256_madd_epi16(lo, ones)));
+            vwsum = _mm256_add_epi32(vwsum, _mm256_add_epi32(_mm256_madd_epi16(hi, hiweight), _mm256_madd_epi16(lo, weight)));
+        }
+        _mm256_storeu_si256((__m256i *)lanes[0], vsum);
+        _mm256_storeu_si256((__m256i *)lanes[1], vprev);
+        _mm256_storeu_si256((__m256i *)lanes[2], vwsum);
+        for (i = 0; i < 8; i++) {
+            sum += lanes[0][i];
+            prev += lanes[1][i];
+            wsum += lanes[2][i];
+        }
+        H5__checksum_fletcher32_add(sum1, sum2, 16 * n, sum, 16 * prev + wsum);
+
+        data += 32 * n;
+        done += n;
+    }
+
+    return 16 * nvec;
+} /* end H5__checksum_fletcher32_avx2() */
+#endif /* H5_CHECKSUM_AVX2 */
+
 /*-------------------------------------------------------------------------
  * Function:	H5_checksum_fletcher32
  *
@@ -87,6 +258,11 @@ static bool H5_crc_table_computed = false;
  *              0xffff (for backward compatibility reasons with earlier
  *              HDF5 fletcher32 I/O filter routine, mostly).
  *
+ * Note #4:     The whole vectors are summed with SIMD, in blocks that are
+ *              reduced modulo 65535.  The end-around carry of the scalar
+ *              loop gives the same checksum whatever the places where it
+ *              is done, so the result is identical.
+ *
  * Return:	32-bit fletcher checksum of input buffer (can't fail)
  *
  *-------------------------------------------------------------------------
@@ -97,6 +273,9 @@ H5_checksum_fletcher32(const void *_data, size_t _len)
     const uint8_t *data = (const uint8_t *)_data; /* Pointer to the data to be summed */
     size_t         len  = _len / 2;               /* Length in 16-bit words */
     uint32_t       sum1 = 0, sum2 = 0;
+#ifdef H5_CHECKSUM_SSE2
+    size_t done; /* Words summed with SIMD */
+#endif
 
     FUNC_ENTER_NOAPI_NOINIT_NOERR
 
@@ -104,6 +283,17 @@ H5_checksum_fletcher32(const void *_data, size_t _len)
     assert(_data);
     assert(_len > 0);
 
+#if defined(H5_CHECKSUM_AVX2)
+    if (H5_have_avx2())
+        done = H5__checksum_fletcher32_avx2(data, len, &sum1, &sum2);
+    else
+#endif
+#if defined(H5_CHECKSUM_SSE2)
+        done = H5__checksum_fletcher32_sse2(data, len, &sum1, &sum2);
+    data += 2 * done;
+    len -= done;
+#endif
+
     /* Compute checksum for pairs of bytes */
     /* (the magic "360" value is the largest number of sums that can be
      *  performed without numeric overflow)
@@ -377,6 +567,19 @@ H5_checksum_lookup3(const void *key, size_t length, uint32_t initval)
     a = b = c = 0xdeadbeef + ((uint32_t)length) + initval;
 
     /*--------------- all but the last block: affect some 32 bits of (a,b,c) */
+#ifdef H5_LOOKUP3_LE_WORDS
+    while (length > 12) {
+        uint32_t w[3];
+
+        memcpy(w, k, sizeof(w));
+        a += w[0];
+        b += w[1];
+        c += w[2];
+        H5_lookup3_mix(a, b, c);
+        length -= 12;
+        k += 12;
+    }
+#else
     while (length > 12) {
         a += k[0];
         a += ((uint32_t)k[1]) << 8;
@@ -394,6 +597,7 @@ H5_checksum_lookup3(const void *key, size_t length, uint32_t initval)
         length -= 12;
         k += 12;
     }
+#endif
 
     /*-------------------------------- last block: affect all 32 bits of (c) */
     switch (length) /* all the case statements fall through */
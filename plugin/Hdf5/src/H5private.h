@@ -1677,6 +1677,10 @@ H5_DLL uint32_t H5_checksum_lookup3(const void *data, size_t len, uint32_t initv
 H5_DLL uint32_t H5_checksum_metadata(const void *data, size_t len, uint32_t initval);
 H5_DLL uint32_t H5_hash_string(const char *str);
 
+/* CPU features */
+H5_DLL herr_t H5_cpu_init(void);
+H5_DLL bool   H5_have_avx2(void);
+
 /* Time related routines */
 H5_DLL time_t H5_make_time(struct tm *tm);
 H5_DLL void   H5_nanosleep(uint64_t nanosec);
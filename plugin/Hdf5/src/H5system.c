@@ -32,6 +32,10 @@
 #include "H5Fprivate.h"  /* File access              */
 #include "H5MMprivate.h" /* Memory management        */
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
 /****************/
 /* Local Macros */
 /****************/
@@ -60,6 +64,10 @@
 /* Local Variables */
 /*******************/
 
+/* Whether the CPU and the OS support AVX2, set once by H5_init_library() */
+static bool H5_have_avx2_g = false;
+static bool H5_cpu_checked_g = false;
+
 /* Track whether tzset routine was called */
 static bool H5_ntzset = false;
 
@@ -849,6 +857,63 @@ H5_nanosleep(uint64_t nanosec)
     FUNC_LEAVE_NOAPI_VOID
 } /* end H5_nanosleep() */
 
+/*--------------------------------------------------------------------------
+ * Function:    H5_cpu_init
+ *
+ * Purpose:     Checks the features of the CPU that select the kernels, once,
+ *              while the library is initialized.  Done there rather than on
+ *              first use so that concurrent callers only ever read the
+ *              answer.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *--------------------------------------------------------------------------
+ */
+herr_t
+H5_cpu_init(void)
+{
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    if (!H5_cpu_checked_g) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        int info[4];
+
+        __cpuid(info, 0);
+        if (info[0] >= 7) {
+            __cpuid(info, 1);
+            /* OSXSAVE and AVX, then YMM state enabled by the OS */
+            if ((info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6) {
+                __cpuidex(info, 7, 0);
+                H5_have_avx2_g = (info[1] & (1 << 5)) != 0;
+            }
+        }
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_cpu_init();
+        H5_have_avx2_g = __builtin_cpu_supports("avx2") != 0;
+#endif
+        H5_cpu_checked_g = true;
+    }
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5_cpu_init() */
+
+/*--------------------------------------------------------------------------
+ * Function:    H5_have_avx2
+ *
+ * Purpose:     Checks whether the CPU supports AVX2 and the OS saves the
+ *              AVX registers, so that the kernels built for AVX2 can be
+ *              used.  False until the library is initialized.
+ *
+ * Return:      true/false
+ *--------------------------------------------------------------------------
+ */
+bool
+H5_have_avx2(void)
+{
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    FUNC_LEAVE_NOAPI(H5_have_avx2_g)
+} /* end H5_have_avx2() */
+
 #ifdef H5_HAVE_WIN32_API
 
 #define H5_WIN32_ENV_VAR_BUFFER_SIZE 32767
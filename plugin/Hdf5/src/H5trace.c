@@ -1090,6 +1090,16 @@ H5_trace_args(H5RS_str_t *rs, const char *type, va_list ap)
                                     H5RS_acat(rs, "H5_VFD_DIRECT");
                                     break;
 #endif
+#ifdef H5_HAVE_IOURING
+                                case H5_VFD_IOURING:
+                                    H5RS_acat(rs, "H5_VFD_IOURING");
+                                    break;
+#endif
+#ifdef H5_HAVE_MMAP
+                                case H5_VFD_MMAP:
+                                    H5RS_acat(rs, "H5_VFD_MMAP");
+                                    break;
+#endif
 #ifdef H5_HAVE_MIRROR_VFD
                                 case H5_VFD_MIRROR:
                                     H5RS_acat(rs, "H5_VFD_MIRROR");
@@ -3600,6 +3610,14 @@ H5_trace_args(H5RS_str_t *rs, const char *type, va_list ap)
                                     H5RS_acat(rs, "H5VL_NATIVE_DATASET_GET_OFFSET");
                                     break;
 
+                                case H5VL_NATIVE_DATASET_GET_CHUNK_CACHE_STATS:
+                                    H5RS_acat(rs, "H5VL_NATIVE_DATASET_GET_CHUNK_CACHE_STATS");
+                                    break;
+
+                                case H5VL_NATIVE_DATASET_FORMAT_UPGRADE:
+                                    H5RS_acat(rs, "H5VL_NATIVE_DATASET_FORMAT_UPGRADE");
+                                    break;
+
                                 default:
                                     H5RS_asprintf_cat(rs, "%ld", (long)optional);
                                     break;
@@ -59,8 +59,10 @@
 #include "H5FDdirect.h"   /* Linux direct I/O                         */
 #include "H5FDfamily.h"   /* File families                            */
 #include "H5FDhdfs.h"     /* Hadoop HDFS                              */
+#include "H5FDiouring.h"  /* Batched vector I/O with Linux io_uring   */
 #include "H5FDlog.h"      /* sec2 driver with I/O logging (for debugging) */
 #include "H5FDmirror.h"   /* Mirror VFD and IPC definitions           */
+#include "H5FDmmap.h"     /* Read-only memory-mapped file I/O         */
 #include "H5FDmpi.h"      /* MPI-based file drivers                   */
 #include "H5FDmulti.h"    /* Usage-partitioned file family            */
 #include "H5FDonion.h"    /* Onion file I/O                           */